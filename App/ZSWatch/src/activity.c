@@ -0,0 +1,310 @@
+#include "activity.h"
+
+#ifdef CONFIG_ZSWATCH_ACTIVITY
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <arm_math.h>
+
+LOG_MODULE_REGISTER(activity, LOG_LEVEL_INF);
+
+#define G_LSB             (1000000 / MOTION_ACCEL_UG_PER_LSB)
+#define G_PER_LSB         (MOTION_ACCEL_UG_PER_LSB * 1e-6f)
+#define PERIOD_US         (1000000 / ACTIVITY_RATE_HZ)
+#define GAP_US            1000000        // trou dans le flux : fenêtre vidée
+#define DC_SHIFT          6              // gravité / moyenne : ~1.2 s à 52 Hz
+#define ZC_BAND           (G_LSB / 100)  // hystérésis des passages par zéro (10 mg)
+
+// Bande de la fréquence dominante (bins de ACTIVITY_RATE_HZ / ACTIVITY_WINDOW Hz)
+#define BIN_HZ            ((float)ACTIVITY_RATE_HZ / ACTIVITY_WINDOW)
+#define BIN_LO            3              // 0.6 Hz
+#define BIN_HI            24             // 4.9 Hz
+
+// Arbre de décision
+#define REST_STD_G        0.015f  // immobile : norme stable...
+#define REST_SMA_G        0.05f   // ... et axes stables (rotation lente du poignet)
+#define MOVE_STD_G        0.05f   // mouvement franc
+#define PERIODIC_MIN      0.3f    // part de l'énergie dans le pic
+#define STEP_MIN_HZ       1.0f
+#define STEP_MAX_HZ       4.0f
+#define RUN_STD_G         0.45f
+#define RUN_HZ            2.5f
+#define VEHICLE_STD_G     0.15f   // vibrations faibles et non périodiques
+#define VEHICLE_ZCR_HZ    6.0f
+#define FIDGET_STD_G      0.04f   // petits gestes sans rythme : repos
+
+static struct {
+    // Moyenne par période de ACTIVITY_RATE_HZ
+    int32_t acc_sum[3];
+    int acc_n;
+    int64_t next_us;
+    // Filtres (Q4)
+    bool primed;
+    int32_t grav_q4[3];
+    int32_t dc_q4;
+    int8_t sign;
+    // Fenêtre glissante et sommes entretenues
+    int32_t mag[ACTIVITY_WINDOW];
+    uint16_t sma[ACTIVITY_WINDOW];
+    uint8_t zc[ACTIVITY_WINDOW];
+    int head;
+    int fill;
+    int64_t sum;
+    int64_t sum_sq;
+    uint32_t sma_sum;
+    uint32_t zc_sum;
+    int hop;
+    // Confirmation
+    ActivityState pending;
+    uint8_t confirm;
+    ActivityInfo info;
+} act;
+
+static struct k_spinlock lock;
+
+// FFT : tables CMSIS-DSP et fenêtre de Hann, initialisées au premier usage
+static arm_rfft_fast_instance_f32 fft;
+static float hann[ACTIVITY_WINDOW];
+static float fft_in[ACTIVITY_WINDOW];
+static float fft_out[ACTIVITY_WINDOW];
+static float power[ACTIVITY_WINDOW / 2];
+static bool fft_ready;
+
+static bool fft_init(void)
+{
+    if (fft_ready) {
+        return true;
+    }
+    if (arm_rfft_fast_init_f32(&fft, ACTIVITY_WINDOW) != ARM_MATH_SUCCESS) {
+        LOG_ERR("Erreur d'initialisation de la FFT (%d points)", ACTIVITY_WINDOW);
+        return false;
+    }
+    for (int i = 0; i < ACTIVITY_WINDOW; i++) {
+        hann[i] = 0.5f - 0.5f * cosf(2 * PI * i / ACTIVITY_WINDOW);
+    }
+    fft_ready = true;
+    return true;
+}
+
+static void window_clear(void)
+{
+    act.head = act.fill = act.hop = 0;
+    act.sum = act.sum_sq = 0;
+    act.sma_sum = act.zc_sum = 0;
+    act.primed = false;
+}
+
+/* ==================== Caractéristiques ==================== */
+/* Fréquence dominante et périodicité : FFT de la norme centrée, fenêtrée */
+static void spectral_features(ActivityFeatures *f, float mean)
+{
+    const int n = ACTIVITY_WINDOW;
+    int k;
+
+    for (int i = 0; i < n; i++) {
+        fft_in[i] = act.mag[(act.head + i) % n] - mean;
+    }
+    arm_mult_f32(fft_in, hann, fft_in, n);
+    arm_rfft_fast_f32(&fft, fft_in, fft_out, 0);
+    // fft_out : [DC, Nyquist, re1, im1, ...] ; power[k] = |X(k)|², k = 1 .. n/2 - 1
+    power[0] = 0.0f;
+    arm_cmplx_mag_squared_f32(&fft_out[2], &power[1], n / 2 - 1);
+
+    float total, peak;
+    uint32_t idx;
+
+    arm_mean_f32(&power[1], n / 2 - 1, &total);
+    total *= n / 2 - 1;
+    arm_max_f32(&power[BIN_LO], BIN_HI - BIN_LO + 1, &peak, &idx);
+    k = BIN_LO + idx;
+
+    float l = power[k - 1], c = power[k], r = power[k + 1];
+    float den = l - 2 * c + r;
+    float delta = den < 0.0f ? 0.5f * (l - r) / den : 0.0f;  // interpolation parabolique
+
+    f->dom_hz = (k + delta) * BIN_HZ;
+    f->periodicity = total > 0.0f ? (l + c + r) / total : 0.0f;
+}
+
+static void compute_features(ActivityFeatures *f)
+{
+    const int64_t n = ACTIVITY_WINDOW;
+    // Variance exacte en entiers : (n Σx² - (Σx)²) / n²
+    int64_t var_n2 = n * act.sum_sq - act.sum * act.sum;
+
+    f->std_g = sqrtf((float)var_n2) / n * G_PER_LSB;
+    f->sma_g = (float)act.sma_sum / n * G_PER_LSB;
+    f->zcr_hz = (float)act.zc_sum * ACTIVITY_RATE_HZ / n;
+    spectral_features(f, (float)act.sum / n);
+}
+
+ActivityState activity_classify(const ActivityFeatures *f)
+{
+    if (f->std_g < REST_STD_G && f->sma_g < REST_SMA_G) {
+        return ACTIVITY_REST;
+    }
+    if (f->std_g >= MOVE_STD_G && f->periodicity >= PERIODIC_MIN &&
+        f->dom_hz >= STEP_MIN_HZ && f->dom_hz <= STEP_MAX_HZ) {
+        return (f->std_g >= RUN_STD_G || f->dom_hz >= RUN_HZ) ? ACTIVITY_RUN : ACTIVITY_WALK;
+    }
+    if (f->std_g < VEHICLE_STD_G && f->zcr_hz >= VEHICLE_ZCR_HZ) {
+        return ACTIVITY_VEHICLE;
+    }
+    if (f->std_g < FIDGET_STD_G) {
+        return ACTIVITY_REST;
+    }
+    return ACTIVITY_UNKNOWN;  // mouvement irrégulier : état conservé
+}
+
+/* Décision toutes les ACTIVITY_HOP périodes ; true si l'état publié change */
+static bool decide(int64_t t_us)
+{
+    ActivityFeatures f;
+
+    compute_features(&f);
+    ActivityState cand = activity_classify(&f);
+    bool changed = false;
+
+    if (cand == ACTIVITY_UNKNOWN || cand == act.info.state) {
+        act.confirm = 0;
+    } else if (cand != act.pending) {
+        act.pending = cand;
+        act.confirm = 1;
+    } else {
+        act.confirm++;
+    }
+    if (act.confirm >= ACTIVITY_CONFIRM_HOPS) {
+        act.confirm = 0;
+        changed = true;
+        LOG_INF("Activité : %s -> %s", activity_name(act.info.state), activity_name(cand));
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    if (changed) {
+        act.info.state = cand;
+        act.info.since_ms = (uint32_t)(t_us / 1000);
+        act.info.changes++;
+    }
+    act.info.features = f;
+    k_spin_unlock(&lock, key);
+    return changed;
+}
+
+/* Un échantillon moyenné : mise à jour O(1) des sommes de la fenêtre */
+static bool push(const int32_t a[3], int64_t t_us)
+{
+    const int n = ACTIVITY_WINDOW;
+    int32_t m = (int32_t)sqrtf((float)a[0] * a[0] + (float)a[1] * a[1] + (float)a[2] * a[2]);
+    uint32_t sma = 0;
+
+    if (!act.primed) {
+        for (int i = 0; i < 3; i++) {
+            act.grav_q4[i] = a[i] * 16;
+        }
+        act.dc_q4 = m * 16;
+        act.sign = 0;
+        act.primed = true;
+    }
+    for (int i = 0; i < 3; i++) {
+        act.grav_q4[i] += (a[i] * 16 - act.grav_q4[i]) >> DC_SHIFT;
+        sma += abs(a[i] - (act.grav_q4[i] >> 4));
+    }
+    act.dc_q4 += (m * 16 - act.dc_q4) >> DC_SHIFT;
+
+    int32_t c = m - (act.dc_q4 >> 4);
+    int8_t sign = c > ZC_BAND ? 1 : c < -ZC_BAND ? -1 : act.sign;
+    uint8_t zc = act.sign != 0 && sign != act.sign;
+    act.sign = sign;
+
+    // Retrait du plus ancien, ajout du nouveau
+    if (act.fill == n) {
+        int32_t old = act.mag[act.head];
+        act.sum -= old;
+        act.sum_sq -= (int64_t)old * old;
+        act.sma_sum -= act.sma[act.head];
+        act.zc_sum -= act.zc[act.head];
+    } else {
+        act.fill++;
+    }
+    act.mag[act.head] = m;
+    act.sma[act.head] = MIN(sma, UINT16_MAX);
+    act.zc[act.head] = zc;
+    act.sum += m;
+    act.sum_sq += (int64_t)m * m;
+    act.sma_sum += act.sma[act.head];
+    act.zc_sum += zc;
+    act.head = (act.head + 1) % n;
+
+    if (act.fill < n || ++act.hop < ACTIVITY_HOP) {
+        return false;
+    }
+    act.hop = 0;
+    return fft_ready && decide(t_us);
+}
+
+bool activity_feed(const MotionSample *samples, int n)
+{
+    bool changed = false;
+
+    if (n > 0 && !fft_init()) {
+        return false;
+    }
+    for (int i = 0; i < n; i++) {
+        const MotionSample *s = &samples[i];
+
+        if (act.acc_n > 0 && s->timestamp_us >= act.next_us) {
+            int32_t avg[3];
+
+            for (int k = 0; k < 3; k++) {
+                avg[k] = act.acc_sum[k] / act.acc_n;
+                act.acc_sum[k] = 0;
+            }
+            act.acc_n = 0;
+            changed |= push(avg, act.next_us);
+            act.next_us += PERIOD_US;
+            if (s->timestamp_us - act.next_us > GAP_US) {
+                window_clear();  // accéléro coupé : fenêtre périmée
+            }
+        }
+        if (act.acc_n == 0 && s->timestamp_us >= act.next_us) {
+            act.next_us = s->timestamp_us + PERIOD_US;
+        }
+        for (int k = 0; k < 3; k++) {
+            act.acc_sum[k] += s->accel[k];
+        }
+        act.acc_n++;
+    }
+    return changed;
+}
+
+void activity_get(ActivityInfo *info)
+{
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    *info = act.info;
+    k_spin_unlock(&lock, key);
+}
+
+const char *activity_name(ActivityState state)
+{
+    static const char *const names[ACTIVITY_COUNT] = {
+        [ACTIVITY_UNKNOWN] = "inconnu",
+        [ACTIVITY_REST] = "repos",
+        [ACTIVITY_WALK] = "marche",
+        [ACTIVITY_RUN] = "course",
+        [ACTIVITY_VEHICLE] = "vehicule",
+    };
+
+    return state < ACTIVITY_COUNT ? names[state] : "?";
+}
+
+void activity_reset(void)
+{
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    memset(&act, 0, sizeof(act));
+    k_spin_unlock(&lock, key);
+}
+
+#endif /* CONFIG_ZSWATCH_ACTIVITY */
@@ -0,0 +1,66 @@
+#ifndef ACTIVITY_H
+#define ACTIVITY_H
+
+#include <stdbool.h>
+#include "motion_sensor.h"
+
+/*
+ * Reconnaissance d'activité (repos / marche / course / véhicule) sur le
+ * flux accéléromètre de la FIFO, ramené à ACTIVITY_RATE_HZ par moyenne.
+ *
+ * Fenêtre glissante de ACTIVITY_WINDOW échantillons ; caractéristiques
+ * entretenues en O(1) par échantillon (sommes entières exactes, sans
+ * dérive) : variance de la norme, SMA (aire de magnitude du signal sans
+ * gravité), taux de passages par zéro. Tous les ACTIVITY_HOP échantillons,
+ * une FFT réelle CMSIS-DSP de la fenêtre donne la fréquence dominante et
+ * la part d'énergie du pic (périodicité), puis un arbre de décision fixe
+ * propose un état, adopté après ACTIVITY_CONFIRM_HOPS propositions
+ * identiques consécutives.
+ */
+#define ACTIVITY_RATE_HZ        52
+#define ACTIVITY_WINDOW         256    // ~4.9 s, taille de la FFT
+#define ACTIVITY_HOP            52     // une décision par seconde
+#define ACTIVITY_CONFIRM_HOPS   3
+
+typedef enum {
+    ACTIVITY_UNKNOWN = 0,  // fenêtre pas encore pleine
+    ACTIVITY_REST,
+    ACTIVITY_WALK,
+    ACTIVITY_RUN,
+    ACTIVITY_VEHICLE,
+    ACTIVITY_COUNT,
+} ActivityState;
+
+typedef struct {
+    float std_g;           // écart-type de la norme
+    float sma_g;           // moyenne de |ax| + |ay| + |az| sans gravité
+    float zcr_hz;          // passages par zéro de la norme centrée, par seconde
+    float dom_hz;          // fréquence dominante (0.5 .. 5 Hz)
+    float periodicity;     // part de l'énergie 0.5 .. 5 Hz autour du pic
+} ActivityFeatures;
+
+typedef struct {
+    ActivityState state;
+    uint32_t since_ms;     // horodatage du changement d'état
+    uint32_t changes;
+    ActivityFeatures features;  // dernière décision
+} ActivityInfo;
+
+/**
+ * @brief Traite des échantillons (du plus ancien au plus récent).
+ *        Un seul appelant (boucle principale).
+ * @return true si l'état publié a changé pendant l'appel
+ */
+bool activity_feed(const MotionSample *samples, int n);
+
+void activity_get(ActivityInfo *info);
+
+/* Décision brute (sans confirmation) sur des caractéristiques données */
+ActivityState activity_classify(const ActivityFeatures *f);
+
+const char *activity_name(ActivityState state);
+
+/* Vide la fenêtre ; état inconnu jusqu'à la prochaine fenêtre pleine */
+void activity_reset(void);
+
+#endif
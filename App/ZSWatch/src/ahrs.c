@@ -0,0 +1,266 @@
+#include "ahrs.h"
+
+#ifdef CONFIG_ZSWATCH_AHRS
+
+#include <zephyr/kernel.h>
+#include <stdlib.h>
+#include <math.h>
+#include "mag_cal.h"
+
+#define DEG_PER_RAD      57.29578f
+#define STANDARD_GRAVITY 9.80665f
+
+// Échelles brutes -> unités physiques (pleines échelles par défaut)
+#define GYRO_RAD_PER_LSB  (MOTION_GYRO_10UDPS_PER_LSB * 1e-5f / DEG_PER_RAD)
+#define ACCEL_G_PER_LSB   (MOTION_ACCEL_UG_PER_LSB * 1e-6f)
+
+// Trou plus long dans le flux (IMU en veille) : réinitialisation directe
+#define AHRS_GAP_US       100000
+
+static struct {
+    float q[4];
+    float accel[3];        // dernier échantillon (g), pour l'accélération linéaire
+    float mag[3];          // repère IMU (gauss)
+    int64_t mag_us;
+    bool has_mag;
+    bool primed;
+    int64_t last_us;
+} ahrs = { .q = { 1.0f, 0.0f, 0.0f, 0.0f } };
+
+static float inv_norm3(float x, float y, float z)
+{
+    return 1.0f / sqrtf(x * x + y * y + z * z);
+}
+
+void ahrs_set_mag(const MagSample *m)
+{
+    float v[3];
+
+    mag_gauss(m->magn, v);
+#ifdef CONFIG_ZSWATCH_MAG_CAL
+    // Fer dur / fer doux corrigés : sinon le lacet suit l'aimantation de la carte
+    mag_cal_apply(v, v);
+#endif
+    mag_to_imu_axes(v, ahrs.mag);
+    ahrs.mag_us = m->timestamp_us;
+    ahrs.has_mag = true;
+}
+
+/*
+ * Orientation directe depuis la gravité et le champ : axes terrestres
+ * (nord, ouest, haut) exprimés dans le repère capteur, puis conversion
+ * de la matrice de rotation en quaternion. Sans champ, lacet nul.
+ */
+static void ahrs_init_from(const float a[3], const float *m)
+{
+    float u[3], n[3], w[3];
+    float k = inv_norm3(a[0], a[1], a[2]);
+
+    for (int i = 0; i < 3; i++) {
+        u[i] = a[i] * k;
+    }
+    // Nord : champ (ou axe x) projeté sur l'horizontale
+    const float x_axis[3] = { 1.0f, 0.0f, 0.0f };
+    const float *ref = m ? m : x_axis;
+    float d = ref[0] * u[0] + ref[1] * u[1] + ref[2] * u[2];
+    for (int i = 0; i < 3; i++) {
+        n[i] = ref[i] - d * u[i];
+    }
+    k = inv_norm3(n[0], n[1], n[2]);
+    if (!isfinite(k)) {
+        return;  // champ vertical : on garde l'orientation courante
+    }
+    for (int i = 0; i < 3; i++) {
+        n[i] *= k;
+    }
+    w[0] = u[1] * n[2] - u[2] * n[1];
+    w[1] = u[2] * n[0] - u[0] * n[2];
+    w[2] = u[0] * n[1] - u[1] * n[0];
+
+    // Lignes de la matrice capteur -> terre : n, w, u
+    float r00 = n[0], r01 = n[1], r02 = n[2];
+    float r10 = w[0], r11 = w[1], r12 = w[2];
+    float r20 = u[0], r21 = u[1], r22 = u[2];
+    float tr = r00 + r11 + r22;
+    float *q = ahrs.q;
+
+    if (tr > 0.0f) {
+        float s = 2.0f * sqrtf(tr + 1.0f);
+        q[0] = 0.25f * s;
+        q[1] = (r21 - r12) / s;
+        q[2] = (r02 - r20) / s;
+        q[3] = (r10 - r01) / s;
+    } else if (r00 > r11 && r00 > r22) {
+        float s = 2.0f * sqrtf(1.0f + r00 - r11 - r22);
+        q[0] = (r21 - r12) / s;
+        q[1] = 0.25f * s;
+        q[2] = (r01 + r10) / s;
+        q[3] = (r02 + r20) / s;
+    } else if (r11 > r22) {
+        float s = 2.0f * sqrtf(1.0f + r11 - r00 - r22);
+        q[0] = (r02 - r20) / s;
+        q[1] = (r01 + r10) / s;
+        q[2] = 0.25f * s;
+        q[3] = (r12 + r21) / s;
+    } else {
+        float s = 2.0f * sqrtf(1.0f + r22 - r00 - r11);
+        q[0] = (r10 - r01) / s;
+        q[1] = (r02 + r20) / s;
+        q[2] = (r12 + r21) / s;
+        q[3] = 0.25f * s;
+    }
+}
+
+/* ==================== Filtre de Madgwick ==================== */
+void ahrs_update(const float gyro[3], const float accel[3], const float mag[3], float dt)
+{
+    float q0 = ahrs.q[0], q1 = ahrs.q[1], q2 = ahrs.q[2], q3 = ahrs.q[3];
+    float gx = gyro[0], gy = gyro[1], gz = gyro[2];
+    float ax = accel[0], ay = accel[1], az = accel[2];
+
+    // Dérivée du quaternion due à la rotation mesurée
+    float qd0 = 0.5f * (-q1 * gx - q2 * gy - q3 * gz);
+    float qd1 = 0.5f * (q0 * gx + q2 * gz - q3 * gy);
+    float qd2 = 0.5f * (q0 * gy - q1 * gz + q3 * gx);
+    float qd3 = 0.5f * (q0 * gz + q1 * gy - q2 * gx);
+
+    // Correction par descente de gradient (accéléro en chute libre : ignoré)
+    if (ax != 0.0f || ay != 0.0f || az != 0.0f) {
+        float k = inv_norm3(ax, ay, az);
+        float s0, s1, s2, s3;
+
+        ax *= k;
+        ay *= k;
+        az *= k;
+
+        float q0q0 = q0 * q0, q1q1 = q1 * q1, q2q2 = q2 * q2, q3q3 = q3 * q3;
+
+        if (mag && (mag[0] != 0.0f || mag[1] != 0.0f || mag[2] != 0.0f)) {
+            k = inv_norm3(mag[0], mag[1], mag[2]);
+            float mx = mag[0] * k, my = mag[1] * k, mz = mag[2] * k;
+
+            float _2q0mx = 2.0f * q0 * mx, _2q0my = 2.0f * q0 * my;
+            float _2q0mz = 2.0f * q0 * mz, _2q1mx = 2.0f * q1 * mx;
+            float _2q0 = 2.0f * q0, _2q1 = 2.0f * q1, _2q2 = 2.0f * q2, _2q3 = 2.0f * q3;
+            float _2q0q2 = 2.0f * q0 * q2, _2q2q3 = 2.0f * q2 * q3;
+            float q0q1 = q0 * q1, q0q2 = q0 * q2, q0q3 = q0 * q3;
+            float q1q2 = q1 * q2, q1q3 = q1 * q3, q2q3 = q2 * q3;
+
+            // Champ ramené dans le repère terrestre : référence (bx, 0, bz)
+            float hx = mx * q0q0 - _2q0my * q3 + _2q0mz * q2 + mx * q1q1 + _2q1 * my * q2 +
+                       _2q1 * mz * q3 - mx * q2q2 - mx * q3q3;
+            float hy = _2q0mx * q3 + my * q0q0 - _2q0mz * q1 + _2q1mx * q2 - my * q1q1 +
+                       my * q2q2 + _2q2 * mz * q3 - my * q3q3;
+            float _2bx = sqrtf(hx * hx + hy * hy);
+            float _2bz = -_2q0mx * q2 + _2q0my * q1 + mz * q0q0 + _2q1mx * q3 - mz * q1q1 +
+                         _2q2 * my * q3 - mz * q2q2 + mz * q3q3;
+            float _4bx = 2.0f * _2bx, _4bz = 2.0f * _2bz;
+
+            // Écarts prédiction - mesure (gravité puis champ)
+            float fa_x = 2.0f * q1q3 - _2q0q2 - ax;
+            float fa_y = 2.0f * q0q1 + _2q2q3 - ay;
+            float fa_z = 1.0f - 2.0f * q1q1 - 2.0f * q2q2 - az;
+            float fm_x = _2bx * (0.5f - q2q2 - q3q3) + _2bz * (q1q3 - q0q2) - mx;
+            float fm_y = _2bx * (q1q2 - q0q3) + _2bz * (q0q1 + q2q3) - my;
+            float fm_z = _2bx * (q0q2 + q1q3) + _2bz * (0.5f - q1q1 - q2q2) - mz;
+
+            s0 = -_2q2 * fa_x + _2q1 * fa_y - _2bz * q2 * fm_x +
+                 (-_2bx * q3 + _2bz * q1) * fm_y + _2bx * q2 * fm_z;
+            s1 = _2q3 * fa_x + _2q0 * fa_y - 4.0f * q1 * fa_z + _2bz * q3 * fm_x +
+                 (_2bx * q2 + _2bz * q0) * fm_y + (_2bx * q3 - _4bz * q1) * fm_z;
+            s2 = -_2q0 * fa_x + _2q3 * fa_y - 4.0f * q2 * fa_z +
+                 (-_4bx * q2 - _2bz * q0) * fm_x + (_2bx * q1 + _2bz * q3) * fm_y +
+                 (_2bx * q0 - _4bz * q2) * fm_z;
+            s3 = _2q1 * fa_x + _2q2 * fa_y + (-_4bx * q3 + _2bz * q1) * fm_x +
+                 (-_2bx * q0 + _2bz * q2) * fm_y + _2bx * q1 * fm_z;
+        } else {
+            // 6 axes : gravité seule
+            float _2q0 = 2.0f * q0, _2q1 = 2.0f * q1, _2q2 = 2.0f * q2, _2q3 = 2.0f * q3;
+            float _4q0 = 4.0f * q0, _4q1 = 4.0f * q1, _4q2 = 4.0f * q2;
+            float _8q1 = 8.0f * q1, _8q2 = 8.0f * q2;
+
+            s0 = _4q0 * q2q2 + _2q2 * ax + _4q0 * q1q1 - _2q1 * ay;
+            s1 = _4q1 * q3q3 - _2q3 * ax + 4.0f * q0q0 * q1 - _2q0 * ay - _4q1 +
+                 _8q1 * q1q1 + _8q1 * q2q2 + _4q1 * az;
+            s2 = 4.0f * q0q0 * q2 + _2q0 * ax + _4q2 * q3q3 - _2q3 * ay - _4q2 +
+                 _8q2 * q1q1 + _8q2 * q2q2 + _4q2 * az;
+            s3 = 4.0f * q1q1 * q3 - _2q1 * ax + 4.0f * q2q2 * q3 - _2q2 * ay;
+        }
+
+        float sn = s0 * s0 + s1 * s1 + s2 * s2 + s3 * s3;
+        if (sn > 0.0f) {
+            k = AHRS_BETA / sqrtf(sn);
+            qd0 -= k * s0;
+            qd1 -= k * s1;
+            qd2 -= k * s2;
+            qd3 -= k * s3;
+        }
+    }
+
+    q0 += qd0 * dt;
+    q1 += qd1 * dt;
+    q2 += qd2 * dt;
+    q3 += qd3 * dt;
+
+    float k = 1.0f / sqrtf(q0 * q0 + q1 * q1 + q2 * q2 + q3 * q3);
+    ahrs.q[0] = q0 * k;
+    ahrs.q[1] = q1 * k;
+    ahrs.q[2] = q2 * k;
+    ahrs.q[3] = q3 * k;
+}
+
+void ahrs_feed(const MotionSample *samples, int n)
+{
+    for (int i = 0; i < n; i++) {
+        const MotionSample *s = &samples[i];
+        float g[3];
+
+        for (int a = 0; a < 3; a++) {
+            ahrs.accel[a] = s->accel[a] * ACCEL_G_PER_LSB;
+            g[a] = s->gyro[a] * GYRO_RAD_PER_LSB;
+        }
+        bool mag_ok = ahrs.has_mag &&
+                      llabs(s->timestamp_us - ahrs.mag_us) < AHRS_MAG_MAX_AGE_US;
+        const float *m = mag_ok ? ahrs.mag : NULL;
+
+        if (!ahrs.primed || s->timestamp_us - ahrs.last_us > AHRS_GAP_US) {
+            ahrs_init_from(ahrs.accel, m);
+            ahrs.primed = true;
+        } else {
+            ahrs_update(g, ahrs.accel, m, (s->timestamp_us - ahrs.last_us) * 1e-6f);
+        }
+        ahrs.last_us = s->timestamp_us;
+    }
+}
+
+void ahrs_get(AhrsOutput *out)
+{
+    float q0 = ahrs.q[0], q1 = ahrs.q[1], q2 = ahrs.q[2], q3 = ahrs.q[3];
+
+    for (int i = 0; i < 4; i++) {
+        out->q[i] = ahrs.q[i];
+    }
+    out->euler_deg[0] = atan2f(q0 * q1 + q2 * q3, 0.5f - q1 * q1 - q2 * q2) * DEG_PER_RAD;
+    out->euler_deg[1] = asinf(fminf(1.0f, fmaxf(-1.0f, 2.0f * (q0 * q2 - q1 * q3)))) * DEG_PER_RAD;
+    out->euler_deg[2] = atan2f(q1 * q2 + q0 * q3, 0.5f - q2 * q2 - q3 * q3) * DEG_PER_RAD;
+
+    // Gravité (1 g) vue dans le repère capteur
+    float grav[3] = {
+        2.0f * (q1 * q3 - q0 * q2),
+        2.0f * (q0 * q1 + q2 * q3),
+        q0 * q0 - q1 * q1 - q2 * q2 + q3 * q3,
+    };
+    for (int i = 0; i < 3; i++) {
+        out->lin_accel[i] = (ahrs.accel[i] - grav[i]) * STANDARD_GRAVITY;
+    }
+}
+
+void ahrs_reset(void)
+{
+    ahrs.q[0] = 1.0f;
+    ahrs.q[1] = ahrs.q[2] = ahrs.q[3] = 0.0f;
+    ahrs.has_mag = false;
+    ahrs.primed = false;
+}
+
+#endif /* CONFIG_ZSWATCH_AHRS */
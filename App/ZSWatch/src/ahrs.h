@@ -0,0 +1,55 @@
+#ifndef AHRS_H
+#define AHRS_H
+
+#include <stdbool.h>
+#include "motion_sensor.h"
+#include "mag_sensor.h"
+
+/*
+ * Fusion 9 axes (filtre de Madgwick, float32 sur le FPU) à la cadence de
+ * la FIFO IMU. Le gyroscope est intégré à chaque échantillon ; une
+ * descente de gradient (gain AHRS_BETA) le recale sur la gravité et le
+ * champ magnétique. Sans champ magnétique récent, le lacet n'est plus
+ * observé (6 axes) et dérive avec le biais du gyroscope.
+ *
+ * Repère de l'IMU (LSM6DSO) : z vers le haut à plat, +1 g au repos.
+ * Le LIS2MDL est ramené dans ce repère (axes de l'IKS01A3).
+ */
+#define AHRS_BETA            0.1f
+#define AHRS_MAG_MAX_AGE_US  200000  // champ plus ancien : fusion 6 axes
+
+typedef struct {
+    float q[4];            // quaternion w, x, y, z (capteur -> terre)
+    float euler_deg[3];    // roulis, tangage, lacet (°)
+    float lin_accel[3];    // accélération sans la gravité, repère capteur (m/s²)
+} AhrsOutput;
+
+/**
+ * @brief Mémorise le dernier champ magnétique (repère LIS2MDL, gauss).
+ *        Appelé avant ahrs_feed() avec le plus récent échantillon lu.
+ */
+void ahrs_set_mag(const MagSample *m);
+
+/**
+ * @brief Fait avancer le filtre sur des échantillons FIFO (du plus ancien au
+ *        plus récent). Le premier échantillon initialise l'orientation
+ *        directement depuis la gravité et le champ. Un seul appelant.
+ */
+void ahrs_feed(const MotionSample *samples, int n);
+
+/**
+ * @brief Une itération du filtre, unités physiques, repère IMU.
+ * @param gyro rad/s
+ * @param accel quelconque (normalisée), ignorée si nulle
+ * @param mag quelconque (normalisée), NULL pour la fusion 6 axes
+ * @param dt pas de temps (s)
+ */
+void ahrs_update(const float gyro[3], const float accel[3], const float mag[3], float dt);
+
+/* Orientation courante, angles d'Euler et accélération linéaire (calculés à l'appel) */
+void ahrs_get(AhrsOutput *out);
+
+/* Retour au quaternion identité ; le prochain ahrs_feed() réinitialise */
+void ahrs_reset(void);
+
+#endif
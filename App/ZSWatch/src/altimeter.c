@@ -0,0 +1,227 @@
+#include "altimeter.h"
+
+#ifdef CONFIG_ZSWATCH_ALTIMETER
+
+#include <zephyr/kernel.h>
+#include <string.h>
+#include <math.h>
+
+#define STANDARD_GRAVITY  9.80665f
+#define SEA_LEVEL_PA      101325.0f
+#define ACCEL_G_PER_LSB   (MOTION_ACCEL_UG_PER_LSB * 1e-6f)
+
+// Bruits du modèle (écarts-types)
+#define SIGMA_ACCEL       1.0f    // accélération verticale, rebond des pas compris (m/s²)
+#define SIGMA_NO_ACCEL    1.0f    // sans accéléromètre : accélération d'un marcheur
+#define SIGMA_BIAS        0.01f   // marche aléatoire du biais (m/s² / √s)
+#define SIGMA_BARO        0.25f   // altitude barométrique à 100 Hz (m)
+
+#define GRAVITY_ALPHA     0.005f  // passe-bas de la gravité : ~1 s à 208 Hz
+#define ACCEL_MAX_AGE_US  100000  // au-delà : prédiction sans accélération
+#define DT_MAX_S          0.5f
+
+static struct {
+    bool primed;
+    float h_ref;               // altitude barométrique du premier échantillon
+    float x[3];                // altitude, vitesse, biais accéléro
+    float p[3][3];
+    int64_t t_us;              // instant de l'état
+    // Accélération verticale
+    float grav[3];             // gravité estimée (g)
+    bool grav_primed;
+    float a_vert;              // m/s², gravité retirée
+    int64_t a_us;
+    // Étages
+    float floor_ref;
+    int64_t rest_since_us;
+    float baro_alt;
+    AltimeterInfo info;
+} alt;
+
+static struct k_spinlock lock;
+
+static float baro_altitude(const struct sensor_value *kpa)
+{
+    float pa = (kpa->val1 + kpa->val2 * 1e-6f) * 1000.0f;
+
+    return 44330.77f * (1.0f - powf(pa / SEA_LEVEL_PA, 0.190263f));
+}
+
+/* ==================== Kalman ==================== */
+static void predict(float dt, float a, bool has_accel)
+{
+    float dt2 = dt * dt;
+    float *x = alt.x;
+    float (*p)[3] = alt.p;
+
+    // x = F x + G (a - b)
+    float u = has_accel ? a - x[2] : 0.0f;
+    x[0] += x[1] * dt + 0.5f * u * dt2;
+    x[1] += u * dt;
+
+    // P = F P F' + Q ; F = [1 dt -dt²/2 ; 0 1 -dt ; 0 0 1] (ou sans biais)
+    float f02 = has_accel ? -0.5f * dt2 : 0.0f, f12 = has_accel ? -dt : 0.0f;
+    float fp[3][3];
+    for (int j = 0; j < 3; j++) {
+        fp[0][j] = p[0][j] + dt * p[1][j] + f02 * p[2][j];
+        fp[1][j] = p[1][j] + f12 * p[2][j];
+        fp[2][j] = p[2][j];
+    }
+    for (int i = 0; i < 3; i++) {
+        p[i][0] = fp[i][0] + dt * fp[i][1] + f02 * fp[i][2];
+        p[i][1] = fp[i][1] + f12 * fp[i][2];
+        p[i][2] = fp[i][2];
+    }
+
+    float s2 = has_accel ? SIGMA_ACCEL * SIGMA_ACCEL : SIGMA_NO_ACCEL * SIGMA_NO_ACCEL;
+    float g0 = 0.5f * dt2, g1 = dt;
+    p[0][0] += g0 * g0 * s2;
+    p[0][1] += g0 * g1 * s2;
+    p[1][0] += g0 * g1 * s2;
+    p[1][1] += g1 * g1 * s2;
+    p[2][2] += SIGMA_BIAS * SIGMA_BIAS * dt;
+}
+
+static void correct(float z)
+{
+    float *x = alt.x;
+    float (*p)[3] = alt.p;
+    float s = p[0][0] + SIGMA_BARO * SIGMA_BARO;
+    float k[3] = { p[0][0] / s, p[1][0] / s, p[2][0] / s };
+    float y = z - x[0];
+    float p0[3] = { p[0][0], p[0][1], p[0][2] };
+
+    for (int i = 0; i < 3; i++) {
+        x[i] += k[i] * y;
+        for (int j = 0; j < 3; j++) {
+            p[i][j] -= k[i] * p0[j];
+        }
+    }
+}
+
+/* Amène l'état à l'instant t (prédiction) */
+static void advance(int64_t t_us)
+{
+    float dt = (t_us - alt.t_us) * 1e-6f;
+
+    if (dt <= 0.0f) {
+        return;  // échantillon plus ancien que l'état : pas de retour arrière
+    }
+    bool has_accel = (t_us - alt.a_us) < ACCEL_MAX_AGE_US;
+    predict(MIN(dt, DT_MAX_S), alt.a_vert, has_accel);
+    alt.t_us = t_us;
+}
+
+/* ==================== Entrées ==================== */
+static void on_accel(const MotionSample *s)
+{
+    float a[3], dot = 0.0f, gn = 0.0f;
+
+    for (int i = 0; i < 3; i++) {
+        a[i] = s->accel[i] * ACCEL_G_PER_LSB;
+    }
+    if (!alt.grav_primed) {
+        memcpy(alt.grav, a, sizeof(a));
+        alt.grav_primed = true;
+    }
+    for (int i = 0; i < 3; i++) {
+        alt.grav[i] += (a[i] - alt.grav[i]) * GRAVITY_ALPHA;
+        gn += alt.grav[i] * alt.grav[i];
+    }
+    gn = sqrtf(gn);
+    if (gn < 0.5f) {
+        return;  // chute libre ou secousse : pas de verticale fiable
+    }
+    for (int i = 0; i < 3; i++) {
+        dot += a[i] * alt.grav[i];
+    }
+    // Projection sur la verticale moins 1 g. Seule la direction vient du
+    // passe-bas (sa norme suivrait l'accélération verticale lente) ; l'erreur
+    // d'échelle de l'accéléromètre est absorbée par l'état biais.
+    alt.a_vert = (dot / gn - 1.0f) * STANDARD_GRAVITY;
+    alt.a_us = s->timestamp_us;
+
+    if (alt.primed) {
+        advance(s->timestamp_us);
+    }
+}
+
+static void update_floors(int64_t t_us)
+{
+    float h = alt.x[0];
+
+    while (h >= alt.floor_ref + ALTIMETER_FLOOR_M) {
+        alt.floor_ref += ALTIMETER_FLOOR_M;
+        alt.info.floors_up++;
+    }
+    while (h <= alt.floor_ref - ALTIMETER_FLOOR_M) {
+        alt.floor_ref -= ALTIMETER_FLOOR_M;
+        alt.info.floors_down++;
+    }
+
+    // Immobile assez longtemps : la référence suit (dérive météo)
+    if (fabsf(alt.x[1]) > ALTIMETER_REST_MS) {
+        alt.rest_since_us = t_us;
+    } else if (t_us - alt.rest_since_us > ALTIMETER_REST_S * 1000000LL) {
+        alt.floor_ref = h;
+    }
+}
+
+static void on_pressure(const EnvSample *s)
+{
+    float h = baro_altitude(&s->pressure);
+
+    alt.baro_alt = h;
+    if (!alt.primed) {
+        alt.h_ref = h;
+        memset(alt.x, 0, sizeof(alt.x));
+        memset(alt.p, 0, sizeof(alt.p));
+        alt.p[0][0] = SIGMA_BARO * SIGMA_BARO;
+        alt.p[1][1] = 1.0f;
+        alt.p[2][2] = 0.1f;
+        alt.t_us = s->timestamp_us;
+        alt.floor_ref = 0.0f;
+        alt.rest_since_us = s->timestamp_us;
+        alt.primed = true;
+        return;
+    }
+    advance(s->timestamp_us);
+    correct(h - alt.h_ref);
+    update_floors(s->timestamp_us);
+}
+
+void altimeter_feed(const MotionSample *imu, int n_imu, const EnvSample *press, int n_press)
+{
+    int i = 0, j = 0;
+
+    // Fusion des deux flux par horodatage croissant
+    while (i < n_imu || j < n_press) {
+        if (j >= n_press || (i < n_imu && imu[i].timestamp_us <= press[j].timestamp_us)) {
+            on_accel(&imu[i++]);
+        } else {
+            on_pressure(&press[j++]);
+        }
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    alt.info.altitude_m = alt.x[0];
+    alt.info.vspeed_ms = alt.x[1];
+    alt.info.baro_alt_m = alt.baro_alt;
+    k_spin_unlock(&lock, key);
+}
+
+void altimeter_get(AltimeterInfo *info)
+{
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    *info = alt.info;
+    k_spin_unlock(&lock, key);
+}
+
+void altimeter_reset(void)
+{
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    memset(&alt, 0, sizeof(alt));
+    k_spin_unlock(&lock, key);
+}
+
+#endif /* CONFIG_ZSWATCH_ALTIMETER */
@@ -0,0 +1,46 @@
+#ifndef ALTIMETER_H
+#define ALTIMETER_H
+
+#include <stdbool.h>
+#include "env_sensor.h"
+#include "motion_sensor.h"
+
+/*
+ * Altimètre barométrique : filtre de Kalman à 3 états (altitude, vitesse
+ * verticale, biais de l'accéléromètre), float32.
+ *   - prédiction à chaque échantillon IMU (208 Hz) avec l'accélération
+ *     verticale : projection sur la gravité estimée par passe-bas ;
+ *   - correction à chaque échantillon LPS22HH (100 Hz) avec l'altitude
+ *     barométrique (atmosphère standard).
+ * Sans accéléromètre (bloc en veille), la prédiction se fait à
+ * accélération nulle : seule la latence augmente.
+ *
+ * Étages : franchissement de ALTIMETER_FLOOR_M depuis l'altitude de
+ * référence, recalée après ALTIMETER_REST_S immobile verticalement (la
+ * dérive météo, ~1 hPa/3 h, ne compte pas comme un étage).
+ */
+#define ALTIMETER_FLOOR_M   3.0f
+#define ALTIMETER_REST_S    10
+#define ALTIMETER_REST_MS   0.05f  // |vitesse| sous ce seuil : repos (m/s)
+
+typedef struct {
+    float altitude_m;      // relative au premier échantillon
+    float vspeed_ms;       // > 0 en montée
+    float baro_alt_m;      // altitude standard (1013.25 hPa), non filtrée
+    uint16_t floors_up;
+    uint16_t floors_down;
+} AltimeterInfo;
+
+/**
+ * @brief Fait avancer le filtre sur les échantillons retirés des anneaux
+ *        (chaque tableau du plus ancien au plus récent ; fusion par
+ *        horodatage). Un seul appelant (boucle principale).
+ */
+void altimeter_feed(const MotionSample *imu, int n_imu, const EnvSample *press, int n_press);
+
+void altimeter_get(AltimeterInfo *info);
+
+/* Altitude relative et compteurs remis à zéro au prochain échantillon */
+void altimeter_reset(void);
+
+#endif
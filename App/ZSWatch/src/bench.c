@@ -0,0 +1,873 @@
+#include "bench.h"
+#include <zephyr/kernel.h>
+#include <zephyr/storage/flash_map.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "sensor_async.h"
+#include "sensor_fixed.h"
+#include "sensor_log.h"
+#include "pedometer.h"
+#include "ahrs.h"
+#include "altimeter.h"
+#include "activity.h"
+#include "fall_detect.h"
+#include "forecast.h"
+#include "derived.h"
+#include "sensor_bus.h"
+#include "synth_trace.h"
+
+#ifdef CONFIG_ZSWATCH_BENCH
+
+#define BENCH_ROUNDS 20
+
+/* Durée moyenne d'un cycle d'acquisition complet, en µs */
+static uint32_t bench_sequential(EnvSensor *env, MotionSensor *imu, MagSensor *mag)
+{
+    uint32_t start = k_cycle_get_32();
+
+    for (int i = 0; i < BENCH_ROUNDS; i++) {
+        env_update(env);
+        motion_update(imu);
+        mag_update(mag);
+    }
+    return k_cyc_to_us_floor32(k_cycle_get_32() - start) / BENCH_ROUNDS;
+}
+
+#ifdef CONFIG_ZSWATCH_SENSOR_ASYNC
+static uint32_t bench_async(EnvSensor *env, MotionSensor *imu, MagSensor *mag)
+{
+    uint32_t start = k_cycle_get_32();
+
+    for (int i = 0; i < BENCH_ROUNDS; i++) {
+        sensor_async_update(env, imu, mag);
+    }
+    return k_cyc_to_us_floor32(k_cycle_get_32() - start) / BENCH_ROUNDS;
+}
+#endif
+
+/* Les 11 conversions du cycle BLE : via double puis en entier (cycles CPU) */
+static volatile int32_t bench_sink;
+
+static uint32_t bench_conv_double(const EnvSensor *env, const MotionSensor *imu,
+                                  const MagSensor *mag)
+{
+    uint32_t start = k_cycle_get_32();
+
+    for (int i = 0; i < BENCH_ROUNDS; i++) {
+        bench_sink = (int16_t)(sensor_value_to_double(&env->temp_hts) * 100);
+        bench_sink = (uint16_t)(sensor_value_to_double(&env->humidity) * 100);
+        bench_sink = (uint32_t)(sensor_value_to_double(&env->pressure) * 1000);
+        bench_sink = (int16_t)(sensor_value_to_double(&env->temp_lps) * 100);
+        for (int a = 0; a < 3; a++) {
+            bench_sink = (int16_t)(sensor_value_to_double(&imu->accel[a]) * 100);
+            bench_sink = (int16_t)(sensor_value_to_double(&mag->magn[a]) * 100);
+        }
+    }
+    return (k_cycle_get_32() - start) / BENCH_ROUNDS;
+}
+
+static uint32_t bench_conv_fixed(const EnvSensor *env, const MotionSensor *imu,
+                                 const MagSensor *mag)
+{
+    int16_t v[3];
+    uint32_t start = k_cycle_get_32();
+
+    for (int i = 0; i < BENCH_ROUNDS; i++) {
+        bench_sink = env_temp_centi(env);
+        bench_sink = env_humidity_centi(env);
+        bench_sink = env_pressure_pa(env);
+        bench_sink = env_temp_lps_centi(env);
+        motion_accel_centi(imu, v);
+        bench_sink = v[0] + v[1] + v[2];
+        mag_magn_centi(mag, v);
+        bench_sink = v[0] + v[1] + v[2];
+    }
+    return (k_cycle_get_32() - start) / BENCH_ROUNDS;
+}
+
+#ifdef CONFIG_ZSWATCH_SENSOR_LOG
+// Endurance flash interne nRF5340 (cycles d'effacement par page)
+#define BENCH_FLASH_ENDURANCE 10000
+// Assez d'ajouts pour écrire plusieurs blocs compressés
+#define BENCH_LOG_RECORDS     (4 * CONFIG_ZSWATCH_SENSOR_LOG_BLOCK_RECORDS)
+#define BENCH_TRACE_LEN       MOTION_ODR_HZ
+
+static TsPoint trace[BENCH_TRACE_LEN];
+
+/* Compression d'une trace par blocs indépendants : taux et cycles par point */
+static void bench_codec(const char *name, int n, uint32_t raw_bytes)
+{
+    static TsEncoder enc;
+    uint32_t packed = 0, cycles = 0;
+
+    if (n == 0) {
+        printf("Compression %-6s : pas de trace\n", name);
+        return;
+    }
+    ts_encoder_init(&enc);
+    for (int i = 0; i < n; i++) {
+        uint32_t start = k_cycle_get_32();
+        int ret = ts_encoder_add(&enc, &trace[i]);
+
+        if (ret != 0) {
+            packed += ts_encoder_size(&enc);
+            ts_encoder_init(&enc);
+            ret = ts_encoder_add(&enc, &trace[i]);
+        }
+        cycles += k_cycle_get_32() - start;
+    }
+    packed += ts_encoder_size(&enc);
+
+    printf("Compression %-6s : %d points | %u -> %u octets (x%u.%u) | %u cycles/point\n",
+           name, n, raw_bytes, packed, raw_bytes / packed, raw_bytes * 10 / packed % 10,
+           cycles / n);
+}
+
+/* Trace réelle du journal (enregistrements des sessions précédentes) */
+static int trace_from_log(uint32_t *raw_bytes)
+{
+    static SensorLogCursor cursor;
+    SensorLogRecord rec;
+    int n = 0;
+
+    *raw_bytes = 0;
+    if (sensor_log_seek(0, &cursor) == 0) {
+        while (n < BENCH_TRACE_LEN && sensor_log_next(&cursor, &rec) == 0) {
+            // Trace environnement complète seulement (capteurs en veille : voies absentes)
+            if ((rec.flags & (SENSOR_LOG_HAS_ENV | SENSOR_LOG_HAS_PRESS)) !=
+                (SENSOR_LOG_HAS_ENV | SENSOR_LOG_HAS_PRESS)) {
+                continue;
+            }
+            TsPoint *p = &trace[n++];
+
+            p->time = rec.time_s;
+            p->mask = 0x7;
+            p->values[0] = rec.temp_100;
+            p->values[1] = rec.humi_100;
+            p->values[2] = rec.pressure;
+            *raw_bytes += 4 + 2 + 2 + 4;
+        }
+    }
+    return n;
+}
+
+#ifdef CONFIG_ZSWATCH_MOTION_FIFO
+/* Trace IMU d'environ 1 s sortie de la FIFO : horodatage µs + 6 axes bruts */
+static int trace_from_imu(MotionSensor *imu, uint32_t *raw_bytes)
+{
+    static MotionSample samples[BENCH_TRACE_LEN];
+    int n;
+
+    motion_fifo_read(imu, samples, ARRAY_SIZE(samples));  // vide l'anneau
+    k_sleep(K_SECONDS(1));
+    n = motion_fifo_read(imu, samples, ARRAY_SIZE(samples));
+
+    for (int i = 0; i < n; i++) {
+        trace[i].time = (uint32_t)samples[i].timestamp_us;
+        trace[i].mask = 0x3F;
+        for (int a = 0; a < 3; a++) {
+            trace[i].values[a] = samples[i].accel[a];
+            trace[i].values[3 + a] = samples[i].gyro[a];
+        }
+    }
+    *raw_bytes = n * sizeof(MotionSample);
+    return n;
+}
+#endif
+
+/*
+ * Zone de test (partition log_scratch) : FCB distincte, effacée à chaque
+ * mesure. Le journal de l'utilisateur n'est jamais écrit par le bench.
+ */
+#define BENCH_SCRATCH_PARTITION FIXED_PARTITION_ID(log_scratch)
+#define BENCH_SCRATCH_SECTORS   4
+
+static struct fcb scratch_fcb;
+static struct flash_sector scratch_sectors[BENCH_SCRATCH_SECTORS];
+
+static int scratch_mount(void)
+{
+    const struct flash_area *fa;
+    uint32_t cnt = ARRAY_SIZE(scratch_sectors);
+
+    if (flash_area_get_sectors(BENCH_SCRATCH_PARTITION, &cnt, scratch_sectors) < 0 ||
+        flash_area_open(BENCH_SCRATCH_PARTITION, &fa) < 0) {
+        return -1;
+    }
+    int ret = flash_area_erase(fa, 0, fa->fa_size);
+    flash_area_close(fa);
+    if (ret < 0) {
+        return -1;
+    }
+
+    memset(&scratch_fcb, 0, sizeof(scratch_fcb));
+    scratch_fcb.f_magic = 0x5a534254;  // "ZSBT"
+    scratch_fcb.f_sectors = scratch_sectors;
+    scratch_fcb.f_sector_cnt = cnt;
+    return fcb_init(BENCH_SCRATCH_PARTITION, &scratch_fcb);
+}
+
+/* Même chemin que l'écriture d'un bloc du journal (sensor_log.c) */
+static int scratch_flush(TsEncoder *enc, uint32_t *flash_bytes)
+{
+    struct fcb_entry loc;
+    uint16_t len = ts_encoder_size(enc);
+    int ret = fcb_append(&scratch_fcb, len, &loc);
+
+    if (ret == -ENOSPC) {
+        if (fcb_rotate(&scratch_fcb) != 0) {
+            return -1;
+        }
+        ret = fcb_append(&scratch_fcb, len, &loc);
+    }
+    uint16_t write_len = ROUND_UP(len, scratch_fcb.f_align);
+    if (ret != 0 ||
+        flash_area_write(scratch_fcb.fap, FCB_ENTRY_FA_DATA_OFF(loc), enc->buf, write_len) < 0 ||
+        fcb_append_finish(&scratch_fcb, &loc) != 0) {
+        return -1;
+    }
+    *flash_bytes += (loc.fe_data_off - loc.fe_elem_off) + write_len + scratch_fcb.f_align;
+    ts_encoder_init(enc);
+    return 0;
+}
+
+/* Débit d'écriture du journal et usure projetée (enregistrement complet) */
+static void bench_sensor_log(const EnvSensor *env)
+{
+    static TsEncoder enc;
+    SensorLogStats log;
+    uint32_t flash_bytes = 0;
+    TsPoint p = {
+        .mask = GENMASK(SENSOR_LOG_CH_MAG + 2, 0),  // env, accéléro et magnéto
+        .values = {
+            [SENSOR_LOG_CH_TEMP] = env_temp_centi(env),
+            [SENSOR_LOG_CH_HUMI] = env_humidity_centi(env),
+            [SENSOR_LOG_CH_PRESS] = env_pressure_pa(env),
+        },
+    };
+
+    sensor_log_get_stats(&log);
+    if (scratch_mount() != 0) {
+        printf("Journal : partition log_scratch indisponible\n");
+        return;
+    }
+    ts_encoder_init(&enc);
+
+    uint32_t start = k_cycle_get_32();
+    for (int i = 0; i < BENCH_LOG_RECORDS; i++) {
+        int ret = 0;
+
+        p.time = i * CONFIG_ZSWATCH_SENSOR_LOG_PERIOD_S;
+        if (enc.count >= CONFIG_ZSWATCH_SENSOR_LOG_BLOCK_RECORDS) {
+            ret = scratch_flush(&enc, &flash_bytes);
+        }
+        if (ret == 0 && ts_encoder_add(&enc, &p) != 0) {
+            ret = scratch_flush(&enc, &flash_bytes);
+            if (ret == 0) {
+                ret = ts_encoder_add(&enc, &p);
+            }
+        }
+        if (ret != 0) {
+            printf("Journal : erreur d'ecriture\n");
+            return;
+        }
+    }
+    uint32_t us = k_cyc_to_us_floor32(k_cycle_get_32() - start) / BENCH_LOG_RECORDS;
+
+    // Écriture par blocs : moyenne sur les blocs effectivement écrits
+    uint32_t bytes_10 = flash_bytes * 10 / BENCH_LOG_RECORDS;
+    uint32_t per_sector = bytes_10 ? log.sector_size * 10 / bytes_10 : 0;
+    // Tous les secteurs du journal s'usent au même rythme (rotation circulaire)
+    uint64_t records = (uint64_t)per_sector * log.sectors * BENCH_FLASH_ENDURANCE;
+    uint32_t years = records * CONFIG_ZSWATCH_SENSOR_LOG_PERIOD_S / (365ULL * 24 * 3600);
+
+    printf("Journal : %u us/ajout | %u.%u octets flash/enreg. | %u enreg./secteur\n",
+           us, bytes_10 / 10, bytes_10 % 10, per_sector);
+    printf("Journal : usure 1 effacement / %u enreg. -> ~%u ans a %u s/enreg.\n",
+           per_sector, years, CONFIG_ZSWATCH_SENSOR_LOG_PERIOD_S);
+}
+#endif
+
+#ifdef CONFIG_ZSWATCH_PEDOMETER
+
+/* Traces de marche de synth_trace.h, par lots de 100 ms */
+static void bench_pedometer(void)
+{
+    static MotionSample batch[SYNTH_BATCH_LEN];
+
+    for (int i = 0; i < SYNTH_WALK_COUNT; i++) {
+        const SynthWalk *w = &synth_walks[i];
+        uint32_t cycles = 0;
+        uint32_t expected = w->hz * w->seconds;
+        int samples = w->seconds * MOTION_ODR_HZ;
+        SynthWalkReplay r;
+        PedometerInfo info;
+        int n;
+
+        pedometer_reset();
+        synth_walk_start(&r, w);
+        while ((n = synth_walk_batch(&r, batch, ARRAY_SIZE(batch))) > 0) {
+            uint32_t start = k_cycle_get_32();
+            pedometer_feed(batch, n);
+            cycles += k_cycle_get_32() - start;
+        }
+        pedometer_get(&info);
+
+        int32_t err_10 = expected ? ((int32_t)info.steps - (int32_t)expected) * 1000 / (int32_t)expected : 0;
+
+        printf("Podometre %-6s : %u pas / %u attendus (%d.%d %%) | %u pas/min | "
+               "%u cycles/echantillon\n", w->name, info.steps, expected, err_10 / 10,
+               abs(err_10 % 10), info.cadence_spm, cycles / samples);
+    }
+    pedometer_reset();
+}
+#endif
+
+#ifdef CONFIG_ZSWATCH_AHRS
+#define BENCH_AHRS_SECONDS 60
+
+static void quat_mul(const float a[4], const float b[4], float out[4])
+{
+    out[0] = a[0] * b[0] - a[1] * b[1] - a[2] * b[2] - a[3] * b[3];
+    out[1] = a[0] * b[1] + a[1] * b[0] + a[2] * b[3] - a[3] * b[2];
+    out[2] = a[0] * b[2] - a[1] * b[3] + a[2] * b[0] + a[3] * b[1];
+    out[3] = a[0] * b[3] + a[1] * b[2] - a[2] * b[1] + a[3] * b[0];
+}
+
+/* Vecteur terrestre vu du capteur : q* v q */
+static void quat_to_sensor(const float q[4], const float v[3], float out[3])
+{
+    const float qc[4] = { q[0], -q[1], -q[2], -q[3] };
+    const float vq[4] = { 0.0f, v[0], v[1], v[2] };
+    float t[4], r[4];
+
+    quat_mul(qc, vq, t);
+    quat_mul(t, q, r);
+    out[0] = r[1];
+    out[1] = r[2];
+    out[2] = r[3];
+}
+
+/*
+ * Trajectoire synthétique à vitesse angulaire constante (repère capteur),
+ * intégrée exactement. Le filtre part de l'identité, loin de la vérité :
+ * temps de convergence sous 2°, erreur finale et cycles par mise à jour.
+ */
+static void bench_ahrs_trace(const char *name, const float w[3], const float q_start[4],
+                             bool use_mag)
+{
+    const float dt = 1.0f / MOTION_ODR_HZ;
+    const float gravity[3] = { 0.0f, 0.0f, 1.0f };
+    const float field[3] = { 0.22f, 0.0f, -0.42f };  // gauss, inclinaison ~62°
+    float q[4] = { q_start[0], q_start[1], q_start[2], q_start[3] };
+    float wn = sqrtf(w[0] * w[0] + w[1] * w[1] + w[2] * w[2]);
+    float dq[4] = { 1.0f, 0.0f, 0.0f, 0.0f };
+    int n = BENCH_AHRS_SECONDS * MOTION_ODR_HZ;
+    int converged = -1;
+    uint32_t cycles = 0;
+    float err = 0.0f;
+
+    if (wn > 0.0f) {
+        float s = sinf(wn * dt / 2) / wn;
+        dq[0] = cosf(wn * dt / 2);
+        dq[1] = w[0] * s;
+        dq[2] = w[1] * s;
+        dq[3] = w[2] * s;
+    }
+
+    ahrs_reset();
+    for (int i = 0; i < n; i++) {
+        float next[4], a[3], m[3];
+        AhrsOutput o;
+
+        quat_mul(q, dq, next);
+        memcpy(q, next, sizeof(q));
+        quat_to_sensor(q, gravity, a);
+        quat_to_sensor(q, field, m);
+
+        uint32_t start = k_cycle_get_32();
+        ahrs_update(w, a, use_mag ? m : NULL, dt);
+        cycles += k_cycle_get_32() - start;
+
+        ahrs_get(&o);
+        if (use_mag) {
+            float dot = fabsf(o.q[0] * q[0] + o.q[1] * q[1] + o.q[2] * q[2] + o.q[3] * q[3]);
+            err = 2.0f * acosf(fminf(1.0f, dot)) * 57.29578f;
+        } else {
+            // Sans magnétomètre, seule l'inclinaison (angle à la verticale) est observable
+            float g_est[3];
+            quat_to_sensor(o.q, gravity, g_est);
+            err = acosf(fminf(1.0f, g_est[0] * a[0] + g_est[1] * a[1] + g_est[2] * a[2])) * 57.29578f;
+        }
+        if (err < 2.0f && converged < 0) {
+            converged = i;
+        } else if (err >= 2.0f) {
+            converged = -1;
+        }
+    }
+
+    if (converged >= 0) {
+        printf("AHRS %-9s : < 2 deg apres %d ms | erreur finale %d.%02d deg | %u cycles/maj\n",
+               name, converged * 1000 / MOTION_ODR_HZ, (int)err, (int)(err * 100) % 100,
+               cycles / n);
+    } else {
+        printf("AHRS %-9s : pas de convergence (erreur %d deg) | %u cycles/maj\n",
+               name, (int)err, cycles / n);
+    }
+}
+
+static void bench_ahrs(void)
+{
+    // Départ à 90° de lacet et 30° de roulis de l'identité
+    const float q_start[4] = { 0.683f, 0.183f, 0.183f, 0.683f };
+    const float still[3] = { 0.0f, 0.0f, 0.0f };
+    const float turn[3] = { 0.0f, 0.0f, 0.8f };         // rotation du poignet à plat
+    const float tumble[3] = { 0.5f, -0.3f, 0.4f };      // rotation quelconque
+
+    bench_ahrs_trace("immobile", still, q_start, true);
+    bench_ahrs_trace("lacet", turn, q_start, true);
+    bench_ahrs_trace("libre", tumble, q_start, true);
+    bench_ahrs_trace("libre 6ax", tumble, q_start, false);
+    ahrs_reset();
+}
+#endif
+
+#ifdef CONFIG_ZSWATCH_ALTIMETER
+/* Escalier de synth_trace.h rejoué par lots de 100 ms, comme la boucle principale */
+static void bench_altimeter_trace(const char *name, bool use_imu)
+{
+    static MotionSample imu[SYNTH_BATCH_LEN];
+    static EnvSample press[SYNTH_BATCH_LEN];
+    uint32_t cycles = 0, samples = 0;
+    float err_h = 0.0f, err_h2 = 0.0f, err_v2 = 0.0f;
+    int n_imu, n_press, n_err = 0;
+    SynthStairs st;
+
+    altimeter_reset();
+    synth_stairs_init(&st, use_imu);
+    while (synth_stairs_batch(&st, imu, &n_imu, press, &n_press)) {
+        uint32_t start = k_cycle_get_32();
+        altimeter_feed(imu, n_imu, press, n_press);
+        cycles += k_cycle_get_32() - start;
+        samples += n_imu + n_press;
+
+        AltimeterInfo info;
+        altimeter_get(&info);
+        if (st.t_us > 2000000) {  // après la convergence initiale
+            err_h += info.altitude_m - st.h;
+            err_h2 += (info.altitude_m - st.h) * (info.altitude_m - st.h);
+            err_v2 += (info.vspeed_ms - st.v) * (info.vspeed_ms - st.v);
+            n_err++;
+        }
+    }
+
+    AltimeterInfo info;
+    altimeter_get(&info);
+    // Altitude relative au premier échantillon (bruité) : écart-type, sans le décalage constant
+    float mean_h = err_h / n_err;
+    int eh = (int)(sqrtf(MAX(err_h2 / n_err - mean_h * mean_h, 0.0f)) * 100);
+    int ev = (int)(sqrtf(err_v2 / n_err) * 100);
+    printf("Altimetre %-6s : etages +%u/%d -%u/%d | erreur alt %d cm, vitesse %d cm/s | "
+           "%u cycles/echantillon\n", name, info.floors_up, SYNTH_STAIRS_UP, info.floors_down,
+           SYNTH_STAIRS_DOWN, eh, ev, samples ? cycles / samples : 0);
+}
+
+static void bench_altimeter(void)
+{
+    bench_altimeter_trace("fusion", true);
+    bench_altimeter_trace("baro", false);
+    altimeter_reset();
+}
+#endif
+
+#ifdef CONFIG_ZSWATCH_ACTIVITY
+/* Trace étiquetée de synth_trace.h (IMU 208 Hz, lots de 100 ms) */
+static void bench_activity(void)
+{
+    static MotionSample batch[SYNTH_BATCH_LEN];
+    static uint32_t confusion[ACTIVITY_COUNT][ACTIVITY_COUNT];
+    uint32_t cycles = 0, samples = 0, changes = 0;
+    ActivityState label;
+    SynthActivity trace;
+    bool settled;
+
+    memset(confusion, 0, sizeof(confusion));
+    activity_reset();
+    synth_activity_init(&trace);
+    while (synth_activity_batch(&trace, batch, &label, &settled)) {
+        uint32_t start = k_cycle_get_32();
+        changes += activity_feed(batch, ARRAY_SIZE(batch));
+        cycles += k_cycle_get_32() - start;
+        samples += ARRAY_SIZE(batch);
+
+        if (settled) {
+            ActivityInfo info;
+            activity_get(&info);
+            confusion[label][info.state]++;
+        }
+    }
+
+    // Lignes : activité réelle ; colonnes : estimée (secondes)
+    uint32_t right = 0, total = 0;
+    printf("Activite : reel \\ estime  inconnu  repos marche course vehicule\n");
+    for (int r = ACTIVITY_REST; r < ACTIVITY_COUNT; r++) {
+        printf("Activite : %-13s", activity_name(r));
+        for (int c = 0; c < ACTIVITY_COUNT; c++) {
+            printf(" %6u", confusion[r][c] / 10);
+            total += confusion[r][c];
+        }
+        right += confusion[r][r];
+        printf("\n");
+    }
+    uint32_t us = k_cyc_to_us_floor32(cycles);
+    uint32_t load_10000 = (uint32_t)((uint64_t)us * 10000 / (trace.t_us ? trace.t_us : 1));
+    printf("Activite : exactitude %u %% | %u changements (%u segments) | %u cycles/echantillon | "
+           "charge CPU %u.%02u %%\n", total ? right * 100 / total : 0, changes,
+           SYNTH_ACTIVITY_SEGMENTS, cycles / samples,
+           load_10000 / 100, load_10000 % 100);
+    activity_reset();
+}
+#endif
+
+#ifdef CONFIG_ZSWATCH_FALL_DETECT
+/*
+ * Scénarios de synth_trace.h, livrés comme par la FIFO. La latence
+ * mesurée va de l'échantillon d'impact à l'appel de l'alerte.
+ */
+static const char *const bench_fall_expected[SYNTH_FALL_COUNT] = {
+    [SYNTH_FALL_CONFIRMED] = "impact + confirmee",
+    [SYNTH_FALL_GETUP] = "impact + releve",
+    [SYNTH_FALL_JUMP] = "rien",
+    [SYNTH_FALL_GESTURE] = "rien",
+};
+
+static struct {
+    uint32_t phases[FALL_PHASE_RECOVERED + 1];
+    uint32_t latency_us;
+    uint8_t n_snap;
+} bench_fall_seen;
+
+static void bench_fall_handler(const FallEvent *e)
+{
+    bench_fall_seen.phases[e->phase]++;
+    if (e->phase == FALL_PHASE_IMPACT) {
+        bench_fall_seen.latency_us = e->latency_us;
+        bench_fall_seen.n_snap = e->n_snap;
+    }
+}
+
+static void bench_fall(void)
+{
+    static MotionSample fifo[128];
+
+    for (size_t i = 0; i < SYNTH_FALL_COUNT; i++) {
+        uint32_t cycles = 0, events;
+        SynthFallReplay r;
+        FallInfo info;
+        int n;
+
+        memset(&bench_fall_seen, 0, sizeof(bench_fall_seen));
+        fall_detect_init(NULL, bench_fall_handler);
+        synth_fall_start(&r, &synth_falls[i]);
+        do {
+            fall_detect_get(&info);
+            n = synth_fall_read(&r, fifo, ARRAY_SIZE(fifo), info.armed, &events);
+            if (n > 0) {
+                uint32_t start = k_cycle_get_32();
+                fall_detect_feed(fifo, n, events);
+                cycles += k_cycle_get_32() - start;
+            }
+        } while (n > 0);
+
+        printf("Chute %-6s : impact %u confirmee %u releve %u (attendu : %s) | "
+               "latence %u.%u ms | instantane %u | %u cycles/echantillon\n",
+               synth_falls[i].name, bench_fall_seen.phases[FALL_PHASE_IMPACT],
+               bench_fall_seen.phases[FALL_PHASE_CONFIRMED],
+               bench_fall_seen.phases[FALL_PHASE_RECOVERED], bench_fall_expected[i],
+               bench_fall_seen.latency_us / 1000, bench_fall_seen.latency_us / 100 % 10,
+               bench_fall_seen.n_snap, cycles / r.total);
+    }
+    fall_detect_init(NULL, NULL);
+}
+#endif
+
+#ifdef CONFIG_ZSWATCH_FORECAST
+#define BENCH_FC_BATCH     10
+
+/*
+ * Passage d'une dépression sur 30 h (trace partagée avec les tests,
+ * synth_trace.h). Vérifié en fin de segment (fenêtre 3 h entièrement
+ * dans le segment) : pente estimée, tendance et prévision.
+ */
+static void bench_forecast(void)
+{
+    static EnvSample press[BENCH_FC_BATCH];
+    uint32_t cycles = 0, samples = 0;
+    float hours = 0.0f;
+    int n, seg, ok = 0;
+    SynthWeather w;
+
+    forecast_reset();
+    synth_weather_init(&w);
+    while ((n = synth_weather_batch(&w, press, BENCH_FC_BATCH, &seg)) > 0) {
+        uint32_t start = k_cycle_get_32();
+        forecast_feed(press, n);
+        cycles += k_cycle_get_32() - start;
+        samples += n;
+        if (seg < 0) {
+            continue;
+        }
+        hours += synth_weather[seg].hours;
+
+        ForecastInfo fc;
+        forecast_get(&fc);
+        bool pass = fc.valid && fc.trend == synth_weather[seg].expected;
+        int err_10 = (int)fabsf((fc.slope_pa_h - synth_weather[seg].pa_h) * 10.0f);
+
+        ok += pass;
+        printf("Meteo %2d h : %u hPa | pente %d Pa/h (imposee %d, erreur %d.%d) | %s (%s) | "
+               "24 h %d Pa | %s\n", (int)hours, fc.sea_level_pa / 100, (int)fc.slope_pa_h,
+               (int)synth_weather[seg].pa_h, err_10 / 10, err_10 % 10,
+               forecast_trend_name(fc.trend), pass ? "ok" : "ERREUR", fc.delta_24h_pa,
+               forecast_text(fc.code));
+    }
+    printf("Meteo : tendances %d/%d | %u cycles/echantillon | historique %u octets\n",
+           ok, SYNTH_WEATHER_SEGMENTS, samples ? cycles / samples : 0,
+           (unsigned)((FORECAST_SHORT_LEN + FORECAST_LONG_LEN) * sizeof(int32_t)));
+    forecast_reset();
+}
+#endif
+
+#ifdef CONFIG_ZSWATCH_DERIVED
+#define BENCH_DERIVED_ROUNDS 1000
+
+/*
+ * Coût du registre : publications sans lecteur (aucun calcul attendu),
+ * puis un seul lecteur (point de rosée) avec une température qui ne
+ * change qu'une fois sur 10. Valeurs de référence : 25 C / 60 % -> rosée
+ * 16.7 C, 13.8 g/m3 ; 32 C / 70 % -> ressenti ~41 C (table NOAA).
+ */
+static void bench_derived(void)
+{
+    uint32_t pub_cycles = 0, hit_cycles = 0, eval_cycles = 0, n_hit = 0, n_eval = 0;
+    uint32_t evals_idle = 0;
+    DerivedStats st;
+    int32_t v;
+
+    derived_reset();
+    for (int i = 0; i < BENCH_DERIVED_ROUNDS; i++) {
+        int32_t t = 2000 + i % 500, h = 5000 + i % 300;
+        int32_t a[3] = { i % 50, -(i % 30), 981 };
+        uint32_t start = k_cycle_get_32();
+
+        derived_publish(DERIVED_IN_TEMP, &t, 1);
+        derived_publish(DERIVED_IN_HUMI, &h, 1);
+        derived_publish(DERIVED_IN_ACCEL, a, 3);
+        pub_cycles += k_cycle_get_32() - start;
+    }
+    for (int m = 0; m < DERIVED_COUNT; m++) {
+        derived_get_stats(m, &st);
+        evals_idle += st.evals;
+    }
+
+    for (int i = 0; i < BENCH_DERIVED_ROUNDS; i++) {
+        int32_t t = 1500 + i / 10;
+        int32_t h = 6000;
+
+        derived_publish(DERIVED_IN_TEMP, &t, 1);
+        derived_publish(DERIVED_IN_HUMI, &h, 1);
+
+        DerivedStats before;
+        derived_get_stats(DERIVED_DEW_POINT, &before);
+        uint32_t start = k_cycle_get_32();
+        derived_get(DERIVED_DEW_POINT, &v);
+        uint32_t c = k_cycle_get_32() - start;
+
+        derived_get_stats(DERIVED_DEW_POINT, &st);
+        if (st.evals != before.evals) {
+            eval_cycles += c;
+            n_eval++;
+        } else {
+            hit_cycles += c;
+            n_hit++;
+        }
+    }
+    derived_get_stats(DERIVED_DEW_POINT, &st);
+    printf("Derives : publication %u cycles (3 entrees) | sans lecteur : %u calcul(s) | "
+           "rosee %u calculs / %u lectures\n", pub_cycles / BENCH_DERIVED_ROUNDS, evals_idle,
+           st.evals, st.reads);
+    printf("Derives : lecture en cache %u cycles | avec calcul %u cycles\n",
+           n_hit ? hit_cycles / n_hit : 0, n_eval ? eval_cycles / n_eval : 0);
+
+    int32_t dew, ah, hi;
+    derived_publish(DERIVED_IN_TEMP, &(int32_t){ 2500 }, 1);
+    derived_publish(DERIVED_IN_HUMI, &(int32_t){ 6000 }, 1);
+    derived_get(DERIVED_DEW_POINT, &dew);
+    derived_get(DERIVED_ABS_HUMIDITY, &ah);
+    derived_publish(DERIVED_IN_TEMP, &(int32_t){ 3200 }, 1);
+    derived_publish(DERIVED_IN_HUMI, &(int32_t){ 7000 }, 1);
+    derived_get(DERIVED_HEAT_INDEX, &hi);
+    printf("Derives : 25 C 60 %% -> rosee %d.%02d C, %d.%02d g/m3 | 32 C 70 %% -> ressenti "
+           "%d.%02d C\n", dew / 100, dew % 100, ah / 100, ah % 100, hi / 100, hi % 100);
+    derived_reset();
+}
+#endif
+
+/* ==================== Bus capteurs ==================== */
+/*
+ * Canal de test du même type que sensor_env_chan, avec les deux sortes
+ * d'observateurs : listener (dans le thread qui publie) et subscriber
+ * (thread propre à SENSOR_BUS_THREAD_PRIO, file de BENCH_BUS_DEPTH).
+ * Latence publication -> consommation sur des publications espacées,
+ * puis rafale plus longue que la file : notifications perdues.
+ */
+#define BENCH_BUS_ROUNDS   100
+#define BENCH_BUS_DEPTH    4
+#define BENCH_BUS_BURST    16
+
+static struct {
+    uint32_t n, sum, max;       // cycles
+} bench_lat[2];                 // 0 listener, 1 subscriber
+
+static uint32_t bench_bus_last_seq;
+
+static void bench_lat_add(int i, uint32_t pub_cycles)
+{
+    uint32_t c = k_cycle_get_32() - pub_cycles;
+
+    bench_lat[i].n++;
+    bench_lat[i].sum += c;
+    bench_lat[i].max = MAX(bench_lat[i].max, c);
+}
+
+static void bench_bus_cb(const struct zbus_channel *chan)
+{
+    const SensorEnvMsg *e = zbus_chan_const_msg(chan);
+
+    bench_lat_add(0, e->hdr.pub_cycles);
+}
+
+ZBUS_LISTENER_DEFINE(bench_bus_lis, bench_bus_cb);
+ZBUS_SUBSCRIBER_DEFINE(bench_bus_sub, BENCH_BUS_DEPTH);
+ZBUS_CHAN_DEFINE(bench_bus_chan, SensorEnvMsg, NULL, NULL,
+                 ZBUS_OBSERVERS(bench_bus_lis, bench_bus_sub), ZBUS_MSG_INIT(0));
+
+static void bench_bus_thread(void *p1, void *p2, void *p3)
+{
+    const struct zbus_channel *chan;
+
+    while (zbus_sub_wait(&bench_bus_sub, &chan, K_FOREVER) == 0) {
+        SensorEnvMsg e;
+
+        if (zbus_chan_read(chan, &e, K_MSEC(10)) == 0) {
+            bench_lat_add(1, e.hdr.pub_cycles);
+            bench_bus_last_seq = e.hdr.seq;
+        }
+    }
+}
+
+K_THREAD_DEFINE(bench_bus_tid, 768, bench_bus_thread, NULL, NULL, NULL,
+                SENSOR_BUS_THREAD_PRIO, 0, 0);
+
+static void bench_bus(void)
+{
+    SensorEnvMsg e = { 0 };
+    uint32_t failed = 0;
+
+    memset(bench_lat, 0, sizeof(bench_lat));
+    for (int i = 0; i < BENCH_BUS_ROUNDS; i++) {
+        e.hdr.seq = i + 1;
+        e.hdr.pub_cycles = k_cycle_get_32();
+        failed += zbus_chan_pub(&bench_bus_chan, &e, K_MSEC(5)) != 0;
+        k_sleep(K_MSEC(2));  // le subscriber consomme avant la suivante
+    }
+    for (int i = 0; i < 2; i++) {
+        uint32_t avg = bench_lat[i].n ? bench_lat[i].sum / bench_lat[i].n : 0;
+
+        printf("Bus %-10s : %u/%u recus | latence moy. %u us (%u cycles), max %u us\n",
+               i ? "subscriber" : "listener", bench_lat[i].n, BENCH_BUS_ROUNDS,
+               k_cyc_to_us_floor32(avg), avg, k_cyc_to_us_floor32(bench_lat[i].max));
+    }
+
+    // Rafale : main (plus prioritaire) publie sans laisser tourner le subscriber
+    memset(bench_lat, 0, sizeof(bench_lat));
+    uint32_t burst_failed = 0;
+    for (int i = 0; i < BENCH_BUS_BURST; i++) {
+        e.hdr.seq = BENCH_BUS_ROUNDS + i + 1;
+        e.hdr.pub_cycles = k_cycle_get_32();
+        burst_failed += zbus_chan_pub(&bench_bus_chan, &e, K_NO_WAIT) != 0;
+    }
+    k_sleep(K_MSEC(20));
+    printf("Bus rafale %d (file %d) : listener %u | subscriber %u notifications, %u perdues, "
+           "derniere valeur lue %u/%u | echecs hors rafale %u\n", BENCH_BUS_BURST,
+           BENCH_BUS_DEPTH, bench_lat[0].n, bench_lat[1].n, burst_failed,
+           bench_bus_last_seq - BENCH_BUS_ROUNDS, BENCH_BUS_BURST, failed);
+
+    // Mémoire : canal (métadonnées + message) et coût d'un observateur
+    uint32_t chan_bytes = sizeof(struct zbus_channel) + sizeof(struct zbus_channel_data);
+    uint32_t obs_bytes = sizeof(struct zbus_observer) + sizeof(struct zbus_channel_observation);
+    printf("Bus memoire : canal %u + message (env %u, motion %u, mag %u) octets | "
+           "observateur %u octets | file subscriber %u + %u octets/notification\n",
+           chan_bytes, (unsigned)sizeof(SensorEnvMsg), (unsigned)sizeof(SensorMotionMsg),
+           (unsigned)sizeof(SensorMagMsg), obs_bytes, (unsigned)sizeof(struct k_msgq),
+           (unsigned)sizeof(struct zbus_channel *));
+}
+
+void bench_run(EnvSensor *env, MotionSensor *imu, MagSensor *mag)
+{
+    printf("=== BENCH (%d cycles) ===\n", BENCH_ROUNDS);
+    printf("Acquisition sequentielle : %u us/cycle\n", bench_sequential(env, imu, mag));
+#ifdef CONFIG_ZSWATCH_SENSOR_ASYNC
+    printf("Acquisition RTIO         : %u us/cycle\n", bench_async(env, imu, mag));
+#endif
+    printf("Conversions double       : %u cycles/cycle BLE\n", bench_conv_double(env, imu, mag));
+    printf("Conversions entieres     : %u cycles/cycle BLE\n", bench_conv_fixed(env, imu, mag));
+#ifdef CONFIG_ZSWATCH_SENSOR_LOG
+    uint32_t raw;
+    int n = trace_from_log(&raw);
+
+    bench_codec("env", n, raw);
+#ifdef CONFIG_ZSWATCH_MOTION_FIFO
+    n = trace_from_imu(imu, &raw);
+    bench_codec("imu", n, raw);
+#endif
+    bench_sensor_log(env);
+#endif
+
+#ifdef CONFIG_ZSWATCH_PEDOMETER
+    bench_pedometer();
+#endif
+#ifdef CONFIG_ZSWATCH_AHRS
+    bench_ahrs();
+#endif
+#ifdef CONFIG_ZSWATCH_ALTIMETER
+    bench_altimeter();
+#endif
+#ifdef CONFIG_ZSWATCH_ACTIVITY
+    bench_activity();
+#endif
+#ifdef CONFIG_ZSWATCH_FALL_DETECT
+    bench_fall();
+#endif
+#ifdef CONFIG_ZSWATCH_FORECAST
+    bench_forecast();
+#endif
+#ifdef CONFIG_ZSWATCH_DERIVED
+    bench_derived();
+#endif
+    bench_bus();
+
+    // Laisse le temps de lire avant le rafraîchissement du dashboard
+    k_sleep(K_SECONDS(5));
+}
+
+#else
+
+void bench_run(EnvSensor *env, MotionSensor *imu, MagSensor *mag)
+{
+}
+
+#endif /* CONFIG_ZSWATCH_BENCH */
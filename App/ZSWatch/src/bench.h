@@ -0,0 +1,14 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include "env_sensor.h"
+#include "motion_sensor.h"
+#include "mag_sensor.h"
+
+/**
+ * @brief Exécute les mesures de performance (CONFIG_ZSWATCH_BENCH) et
+ *        affiche les résultats sur la console. Sans effet sinon.
+ */
+void bench_run(EnvSensor *env, MotionSensor *imu, MagSensor *mag);
+
+#endif
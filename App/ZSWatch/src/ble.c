@@ -7,6 +7,11 @@
 #include <zephyr/logging/log.h>
 #include <zephyr/sys/byteorder.h>
 #include <string.h>
+#include "ble.h"
+#include "ble_link.h"
+#include "ble_bulk.h"
+#include "imu_stream.h"
+#include "timebase.h"
 
 LOG_MODULE_REGISTER(ble, LOG_LEVEL_INF);
 
@@ -22,6 +27,32 @@ LOG_MODULE_REGISTER(ble, LOG_LEVEL_INF);
 #define BT_UUID_CTS_VAL                0x1805  // Current Time Service
 #define BT_UUID_CURRENT_TIME_VAL        0x2A2B  // Current Time characteristic
 
+/* ==================== UUIDs du service "sensor frame" (128 bits) ==================== */
+#define BT_UUID_ZSW_FRAME_SVC_VAL \
+    BT_UUID_128_ENCODE(0x5a570001, 0x2c3b, 0x4e1d, 0x9f6a, 0x7b8c9d0e1f20)
+#define BT_UUID_ZSW_FRAME_VAL \
+    BT_UUID_128_ENCODE(0x5a570002, 0x2c3b, 0x4e1d, 0x9f6a, 0x7b8c9d0e1f20)
+#define BT_UUID_ZSW_IMU_STREAM_VAL \
+    BT_UUID_128_ENCODE(0x5a570003, 0x2c3b, 0x4e1d, 0x9f6a, 0x7b8c9d0e1f20)
+#define BT_UUID_ZSW_IMU_CTRL_VAL \
+    BT_UUID_128_ENCODE(0x5a570004, 0x2c3b, 0x4e1d, 0x9f6a, 0x7b8c9d0e1f20)
+#define BT_UUID_ZSW_TIME_SYNC_VAL \
+    BT_UUID_128_ENCODE(0x5a570005, 0x2c3b, 0x4e1d, 0x9f6a, 0x7b8c9d0e1f20)
+#define BT_UUID_ZSW_STEPS_VAL \
+    BT_UUID_128_ENCODE(0x5a570006, 0x2c3b, 0x4e1d, 0x9f6a, 0x7b8c9d0e1f20)
+#define BT_UUID_ZSW_ORIENTATION_VAL \
+    BT_UUID_128_ENCODE(0x5a570007, 0x2c3b, 0x4e1d, 0x9f6a, 0x7b8c9d0e1f20)
+#define BT_UUID_ZSW_ALTITUDE_VAL \
+    BT_UUID_128_ENCODE(0x5a570008, 0x2c3b, 0x4e1d, 0x9f6a, 0x7b8c9d0e1f20)
+#define BT_UUID_ZSW_ACTIVITY_VAL \
+    BT_UUID_128_ENCODE(0x5a570009, 0x2c3b, 0x4e1d, 0x9f6a, 0x7b8c9d0e1f20)
+#define BT_UUID_ZSW_FALL_VAL \
+    BT_UUID_128_ENCODE(0x5a57000a, 0x2c3b, 0x4e1d, 0x9f6a, 0x7b8c9d0e1f20)
+#define BT_UUID_ZSW_FORECAST_VAL \
+    BT_UUID_128_ENCODE(0x5a57000b, 0x2c3b, 0x4e1d, 0x9f6a, 0x7b8c9d0e1f20)
+#define BT_UUID_ZSW_DERIVED_VAL \
+    BT_UUID_128_ENCODE(0x5a57000c, 0x2c3b, 0x4e1d, 0x9f6a, 0x7b8c9d0e1f20)
+
 /* Déclaration des UUID 16 bits */
 static const struct bt_uuid_16 ess_uuid = BT_UUID_INIT_16(BT_UUID_ESS_VAL);
 static const struct bt_uuid_16 temp_uuid = BT_UUID_INIT_16(BT_UUID_TEMPERATURE_VAL);
@@ -31,6 +62,18 @@ static const struct bt_uuid_16 mag_uuid = BT_UUID_INIT_16(BT_UUID_MAGNETIC_FLUX_
 static const struct bt_uuid_16 accel_uuid = BT_UUID_INIT_16(BT_UUID_ACCELEROMETER_3D_VAL);
 static const struct bt_uuid_16 cts_uuid = BT_UUID_INIT_16(BT_UUID_CTS_VAL);
 static const struct bt_uuid_16 current_time_uuid = BT_UUID_INIT_16(BT_UUID_CURRENT_TIME_VAL);
+static const struct bt_uuid_128 frame_svc_uuid = BT_UUID_INIT_128(BT_UUID_ZSW_FRAME_SVC_VAL);
+static const struct bt_uuid_128 frame_uuid = BT_UUID_INIT_128(BT_UUID_ZSW_FRAME_VAL);
+static const struct bt_uuid_128 imu_stream_uuid = BT_UUID_INIT_128(BT_UUID_ZSW_IMU_STREAM_VAL);
+static const struct bt_uuid_128 imu_ctrl_uuid = BT_UUID_INIT_128(BT_UUID_ZSW_IMU_CTRL_VAL);
+static const struct bt_uuid_128 time_sync_uuid = BT_UUID_INIT_128(BT_UUID_ZSW_TIME_SYNC_VAL);
+static const struct bt_uuid_128 steps_uuid = BT_UUID_INIT_128(BT_UUID_ZSW_STEPS_VAL);
+static const struct bt_uuid_128 orientation_uuid = BT_UUID_INIT_128(BT_UUID_ZSW_ORIENTATION_VAL);
+static const struct bt_uuid_128 altitude_uuid = BT_UUID_INIT_128(BT_UUID_ZSW_ALTITUDE_VAL);
+static const struct bt_uuid_128 activity_uuid = BT_UUID_INIT_128(BT_UUID_ZSW_ACTIVITY_VAL);
+static const struct bt_uuid_128 fall_uuid = BT_UUID_INIT_128(BT_UUID_ZSW_FALL_VAL);
+static const struct bt_uuid_128 forecast_uuid = BT_UUID_INIT_128(BT_UUID_ZSW_FORECAST_VAL);
+static const struct bt_uuid_128 derived_uuid = BT_UUID_INIT_128(BT_UUID_ZSW_DERIVED_VAL);
 
 /* ==================== Variables pour les données capteurs ==================== */
 static int16_t temp_value;
@@ -38,34 +81,112 @@ static uint16_t humi_value;
 static uint32_t press_value;          // Pression en pascals
 static int16_t mag_value[3];
 static int16_t accel_value[3];
-
-/* ==================== Variable pour l'heure (timestamp Unix simplifié) ==================== */
-static uint32_t current_time; // secondes depuis 1970 (timestamp Unix)
+static uint8_t frame_value[BLE_SENSOR_FRAME_SIZE];
+static uint8_t steps_value[BLE_STEPS_SIZE];
+static uint8_t orientation_value[BLE_ORIENTATION_SIZE];
+static uint8_t altitude_value[BLE_ALTITUDE_SIZE];
+static uint8_t activity_value[BLE_ACTIVITY_SIZE];
+static uint8_t fall_value[BLE_FALL_MAX_SIZE];
+static uint16_t fall_len = BLE_FALL_HEADER_SIZE;
+static uint8_t forecast_value[BLE_FORECAST_SIZE] = { [9] = 0xFF };
+static uint8_t derived_value[BLE_DERIVED_SIZE];
+static uint16_t frame_seq;
+
+/* Connexion courante (CONFIG_BT_MAX_CONN=1) */
+static struct bt_conn *current_conn;
 
 /* ==================== Callbacks CCC pour les notifications ==================== */
+/* Voies ayant un abonné (bit = BleChannel) */
+static atomic_t subscriptions;
+
+static void ccc_update(BleChannel ch, uint16_t value, const char *name)
+{
+    bool on = (value & (BT_GATT_CCC_NOTIFY | BT_GATT_CCC_INDICATE)) != 0;
+
+    if (on) {
+        atomic_set_bit(&subscriptions, ch);
+    } else {
+        atomic_clear_bit(&subscriptions, ch);
+    }
+    LOG_INF("Notifications %s %s", name, on ? "activées" : "désactivées");
+}
+
+bool ble_is_subscribed(BleChannel ch)
+{
+    return atomic_test_bit(&subscriptions, ch);
+}
+
 static void temp_ccc_changed(const struct bt_gatt_attr *attr, uint16_t value)
 {
-    LOG_INF("Notifications température %s", (value == BT_GATT_CCC_NOTIFY) ? "activées" : "désactivées");
+    ccc_update(BLE_CH_TEMP, value, "température");
 }
 
 static void humi_ccc_changed(const struct bt_gatt_attr *attr, uint16_t value)
 {
-    LOG_INF("Notifications humidité %s", (value == BT_GATT_CCC_NOTIFY) ? "activées" : "désactivées");
+    ccc_update(BLE_CH_HUMI, value, "humidité");
 }
 
 static void press_ccc_changed(const struct bt_gatt_attr *attr, uint16_t value)
 {
-    LOG_INF("Notifications pression %s", (value == BT_GATT_CCC_NOTIFY) ? "activées" : "désactivées");
+    ccc_update(BLE_CH_PRESS, value, "pression");
 }
 
 static void mag_ccc_changed(const struct bt_gatt_attr *attr, uint16_t value)
 {
-    LOG_INF("Notifications magnétomètre %s", (value == BT_GATT_CCC_NOTIFY) ? "activées" : "désactivées");
+    ccc_update(BLE_CH_MAG, value, "magnétomètre");
 }
 
 static void accel_ccc_changed(const struct bt_gatt_attr *attr, uint16_t value)
 {
-    LOG_INF("Notifications accélération %s", (value == BT_GATT_CCC_NOTIFY) ? "activées" : "désactivées");
+    ccc_update(BLE_CH_ACCEL, value, "accélération");
+}
+
+static void frame_ccc_changed(const struct bt_gatt_attr *attr, uint16_t value)
+{
+    ccc_update(BLE_CH_FRAME, value, "trame capteurs");
+}
+
+static void steps_ccc_changed(const struct bt_gatt_attr *attr, uint16_t value)
+{
+    ccc_update(BLE_CH_STEPS, value, "podomètre");
+}
+
+static void orientation_ccc_changed(const struct bt_gatt_attr *attr, uint16_t value)
+{
+    ccc_update(BLE_CH_ORIENTATION, value, "orientation");
+}
+
+static void altitude_ccc_changed(const struct bt_gatt_attr *attr, uint16_t value)
+{
+    ccc_update(BLE_CH_ALTITUDE, value, "altimètre");
+}
+
+static void activity_ccc_changed(const struct bt_gatt_attr *attr, uint16_t value)
+{
+    ccc_update(BLE_CH_ACTIVITY, value, "activité");
+}
+
+static void fall_ccc_changed(const struct bt_gatt_attr *attr, uint16_t value)
+{
+    ccc_update(BLE_CH_FALL, value, "chute");
+}
+
+static void forecast_ccc_changed(const struct bt_gatt_attr *attr, uint16_t value)
+{
+    ccc_update(BLE_CH_FORECAST, value, "prévision");
+}
+
+static void derived_ccc_changed(const struct bt_gatt_attr *attr, uint16_t value)
+{
+    ccc_update(BLE_CH_DERIVED, value, "grandeurs dérivées");
+}
+
+static void imu_stream_ccc_changed(const struct bt_gatt_attr *attr, uint16_t value)
+{
+    ccc_update(BLE_CH_IMU_STREAM, value, "streaming IMU");
+    if (value != BT_GATT_CCC_NOTIFY) {
+        imu_stream_control(false, 0);
+    }
 }
 
 /* ==================== Fonctions de lecture pour les caractéristiques ==================== */
@@ -99,19 +220,94 @@ static ssize_t read_accel(struct bt_conn *conn, const struct bt_gatt_attr *attr,
     return bt_gatt_attr_read(conn, attr, buf, len, offset, accel_value, sizeof(accel_value));
 }
 
+static ssize_t read_frame(struct bt_conn *conn, const struct bt_gatt_attr *attr,
+                          void *buf, uint16_t len, uint16_t offset)
+{
+    return bt_gatt_attr_read(conn, attr, buf, len, offset, frame_value, sizeof(frame_value));
+}
+
+static ssize_t read_steps(struct bt_conn *conn, const struct bt_gatt_attr *attr,
+                          void *buf, uint16_t len, uint16_t offset)
+{
+    return bt_gatt_attr_read(conn, attr, buf, len, offset, steps_value, sizeof(steps_value));
+}
+
+static ssize_t read_orientation(struct bt_conn *conn, const struct bt_gatt_attr *attr,
+                                void *buf, uint16_t len, uint16_t offset)
+{
+    return bt_gatt_attr_read(conn, attr, buf, len, offset, orientation_value,
+                             sizeof(orientation_value));
+}
+
+static ssize_t read_altitude(struct bt_conn *conn, const struct bt_gatt_attr *attr,
+                             void *buf, uint16_t len, uint16_t offset)
+{
+    return bt_gatt_attr_read(conn, attr, buf, len, offset, altitude_value, sizeof(altitude_value));
+}
+
+static ssize_t read_activity(struct bt_conn *conn, const struct bt_gatt_attr *attr,
+                             void *buf, uint16_t len, uint16_t offset)
+{
+    return bt_gatt_attr_read(conn, attr, buf, len, offset, activity_value, sizeof(activity_value));
+}
+
+static ssize_t read_fall(struct bt_conn *conn, const struct bt_gatt_attr *attr,
+                         void *buf, uint16_t len, uint16_t offset)
+{
+    return bt_gatt_attr_read(conn, attr, buf, len, offset, fall_value, fall_len);
+}
+
+static ssize_t read_forecast(struct bt_conn *conn, const struct bt_gatt_attr *attr,
+                             void *buf, uint16_t len, uint16_t offset)
+{
+    return bt_gatt_attr_read(conn, attr, buf, len, offset, forecast_value, sizeof(forecast_value));
+}
+
+static ssize_t read_derived(struct bt_conn *conn, const struct bt_gatt_attr *attr,
+                            void *buf, uint16_t len, uint16_t offset)
+{
+    return bt_gatt_attr_read(conn, attr, buf, len, offset, derived_value, sizeof(derived_value));
+}
+
+/* ==================== Contrôle du streaming IMU ==================== */
+/* Octet 0 : 1 = démarrer, 0 = arrêter ; octets 1-2 optionnels : fréquence (Hz, LE) */
+static ssize_t write_imu_ctrl(struct bt_conn *conn, const struct bt_gatt_attr *attr,
+                              const void *buf, uint16_t len, uint16_t offset, uint8_t flags)
+{
+    const uint8_t *p = buf;
+
+    if (offset != 0) {
+        return BT_GATT_ERR(BT_ATT_ERR_INVALID_OFFSET);
+    }
+    if (len != 1 && len != 3) {
+        return BT_GATT_ERR(BT_ATT_ERR_INVALID_ATTRIBUTE_LEN);
+    }
+
+    imu_stream_control(p[0] != 0, (len == 3) ? sys_get_le16(&p[1]) : 0);
+    return len;
+}
+
 /* ==================== Callback d'écriture pour la caractéristique Current Time ==================== */
 static ssize_t write_current_time(struct bt_conn *conn,
                                    const struct bt_gatt_attr *attr,
                                    const void *buf, uint16_t len, uint16_t offset,
                                    uint8_t flags)
 {
+    const uint8_t *p = buf;
+
     LOG_INF("write_current_time called with len=%d", len);
-    if (len != sizeof(current_time)) {
-        LOG_ERR("Invalid length: %d (expected %d)", len, sizeof(current_time));
+    // [u32 s] ou [u32 s][u32 µs] : la fraction affine l'estimation de dérive
+    if (len != 4 && len != 8) {
+        LOG_ERR("Invalid length: %d (expected 4 or 8)", len);
         return BT_GATT_ERR(BT_ATT_ERR_INVALID_ATTRIBUTE_LEN);
     }
-    memcpy(&current_time, buf, sizeof(current_time));
-    LOG_INF("Heure reçue via BLE : %u (timestamp Unix)", current_time);
+    uint32_t epoch_s = sys_get_le32(p);
+    uint32_t frac_us = (len == 8) ? sys_get_le32(&p[4]) : 0;
+    if (frac_us >= USEC_PER_SEC) {
+        return BT_GATT_ERR(BT_ATT_ERR_VALUE_NOT_ALLOWED);
+    }
+    LOG_INF("Heure reçue via BLE : %u (timestamp Unix)", epoch_s);
+    timebase_sync((int64_t)epoch_s * USEC_PER_SEC + frac_us, (len == 8) ? 1 : USEC_PER_SEC);
     return len;
 }
 
@@ -120,7 +316,25 @@ static ssize_t read_current_time(struct bt_conn *conn,
                                    const struct bt_gatt_attr *attr,
                                    void *buf, uint16_t len, uint16_t offset)
 {
-    return bt_gatt_attr_read(conn, attr, buf, len, offset, &current_time, sizeof(current_time));
+    // Heure courante, pas la dernière valeur écrite
+    uint8_t value[sizeof(uint32_t)];
+
+    sys_put_le32(timebase_now_s(), value);
+    return bt_gatt_attr_read(conn, attr, buf, len, offset, value, sizeof(value));
+}
+
+/* ==================== Conseil de synchro : [u32 délai s][i32 dérive ppb] ==================== */
+static ssize_t read_time_sync(struct bt_conn *conn,
+                              const struct bt_gatt_attr *attr,
+                              void *buf, uint16_t len, uint16_t offset)
+{
+    TimebaseInfo info;
+    uint8_t value[8];
+
+    timebase_get_info(&info);
+    sys_put_le32(info.next_sync_s, value);
+    sys_put_le32(info.drift_ppb, &value[4]);
+    return bt_gatt_attr_read(conn, attr, buf, len, offset, value, sizeof(value));
 }
 
 /* ==================== Définition des services GATT ==================== */
@@ -171,7 +385,84 @@ BT_GATT_SERVICE_DEFINE(cts_svc,
     BT_GATT_CHARACTERISTIC(&current_time_uuid.uuid,
                            BT_GATT_CHRC_READ | BT_GATT_CHRC_WRITE,
                            BT_GATT_PERM_READ | BT_GATT_PERM_WRITE,
-                           read_current_time, write_current_time, &current_time),
+                           read_current_time, write_current_time, NULL),
+    /* Délai conseillé avant la prochaine écriture Current Time */
+    BT_GATT_CHARACTERISTIC(&time_sync_uuid.uuid,
+                           BT_GATT_CHRC_READ,
+                           BT_GATT_PERM_READ,
+                           read_time_sync, NULL, NULL),
+);
+
+/* Service "sensor frame" : toutes les voies dans une seule notification */
+BT_GATT_SERVICE_DEFINE(frame_svc,
+    BT_GATT_PRIMARY_SERVICE(&frame_svc_uuid),
+    BT_GATT_CHARACTERISTIC(&frame_uuid.uuid,
+                           BT_GATT_CHRC_READ | BT_GATT_CHRC_NOTIFY,
+                           BT_GATT_PERM_READ,
+                           read_frame, NULL, frame_value),
+    BT_GATT_CCC(frame_ccc_changed, BT_GATT_PERM_READ | BT_GATT_PERM_WRITE),
+
+    /* Streaming IMU 6 axes (paquets delta, voir imu_stream.h) */
+    BT_GATT_CHARACTERISTIC(&imu_stream_uuid.uuid,
+                           BT_GATT_CHRC_NOTIFY,
+                           BT_GATT_PERM_NONE,
+                           NULL, NULL, NULL),
+    BT_GATT_CCC(imu_stream_ccc_changed, BT_GATT_PERM_READ | BT_GATT_PERM_WRITE),
+
+    /* Démarrage / arrêt du streaming */
+    BT_GATT_CHARACTERISTIC(&imu_ctrl_uuid.uuid,
+                           BT_GATT_CHRC_WRITE,
+                           BT_GATT_PERM_WRITE,
+                           NULL, write_imu_ctrl, NULL),
+
+    /* Podomètre (voir ble_update_steps) */
+    BT_GATT_CHARACTERISTIC(&steps_uuid.uuid,
+                           BT_GATT_CHRC_READ | BT_GATT_CHRC_NOTIFY,
+                           BT_GATT_PERM_READ,
+                           read_steps, NULL, steps_value),
+    BT_GATT_CCC(steps_ccc_changed, BT_GATT_PERM_READ | BT_GATT_PERM_WRITE),
+
+    /* Orientation 9 axes (voir ble_update_orientation) */
+    BT_GATT_CHARACTERISTIC(&orientation_uuid.uuid,
+                           BT_GATT_CHRC_READ | BT_GATT_CHRC_NOTIFY,
+                           BT_GATT_PERM_READ,
+                           read_orientation, NULL, orientation_value),
+    BT_GATT_CCC(orientation_ccc_changed, BT_GATT_PERM_READ | BT_GATT_PERM_WRITE),
+
+    /* Altimètre (voir ble_update_altitude) */
+    BT_GATT_CHARACTERISTIC(&altitude_uuid.uuid,
+                           BT_GATT_CHRC_READ | BT_GATT_CHRC_NOTIFY,
+                           BT_GATT_PERM_READ,
+                           read_altitude, NULL, altitude_value),
+    BT_GATT_CCC(altitude_ccc_changed, BT_GATT_PERM_READ | BT_GATT_PERM_WRITE),
+
+    /* Activité (voir ble_update_activity) */
+    BT_GATT_CHARACTERISTIC(&activity_uuid.uuid,
+                           BT_GATT_CHRC_READ | BT_GATT_CHRC_NOTIFY,
+                           BT_GATT_PERM_READ,
+                           read_activity, NULL, activity_value),
+    BT_GATT_CCC(activity_ccc_changed, BT_GATT_PERM_READ | BT_GATT_PERM_WRITE),
+
+    /* Alerte chute (voir ble_indicate_fall) */
+    BT_GATT_CHARACTERISTIC(&fall_uuid.uuid,
+                           BT_GATT_CHRC_READ | BT_GATT_CHRC_INDICATE,
+                           BT_GATT_PERM_READ,
+                           read_fall, NULL, fall_value),
+    BT_GATT_CCC(fall_ccc_changed, BT_GATT_PERM_READ | BT_GATT_PERM_WRITE),
+
+    /* Prévision météo (voir ble_update_forecast) */
+    BT_GATT_CHARACTERISTIC(&forecast_uuid.uuid,
+                           BT_GATT_CHRC_READ | BT_GATT_CHRC_NOTIFY,
+                           BT_GATT_PERM_READ,
+                           read_forecast, NULL, forecast_value),
+    BT_GATT_CCC(forecast_ccc_changed, BT_GATT_PERM_READ | BT_GATT_PERM_WRITE),
+
+    /* Grandeurs dérivées (voir ble_update_derived) */
+    BT_GATT_CHARACTERISTIC(&derived_uuid.uuid,
+                           BT_GATT_CHRC_READ | BT_GATT_CHRC_NOTIFY,
+                           BT_GATT_PERM_READ,
+                           read_derived, NULL, derived_value),
+    BT_GATT_CCC(derived_ccc_changed, BT_GATT_PERM_READ | BT_GATT_PERM_WRITE),
 );
 
 /* Récupération des attributs pour les notifications (ESS) */
@@ -180,6 +471,239 @@ BT_GATT_SERVICE_DEFINE(cts_svc,
 #define PRESS_ATTR (&sensor_svc.attrs[8])
 #define MAG_ATTR   (&sensor_svc.attrs[11])
 #define ACCEL_ATTR (&sensor_svc.attrs[14])
+#define FRAME_ATTR (&frame_svc.attrs[2])
+#define IMU_STREAM_ATTR (&frame_svc.attrs[5])
+#define STEPS_ATTR (&frame_svc.attrs[10])
+#define ORIENTATION_ATTR (&frame_svc.attrs[13])
+#define ALTITUDE_ATTR (&frame_svc.attrs[16])
+#define ACTIVITY_ATTR (&frame_svc.attrs[19])
+#define FALL_ATTR (&frame_svc.attrs[22])
+#define FORECAST_ATTR (&frame_svc.attrs[25])
+#define DERIVED_ATTR (&frame_svc.attrs[28])
+
+/* ==================== Ordonnanceur d'émission ==================== */
+/*
+ * Les notifications passent par bt_gatt_notify_cb() : chaque envoi consomme
+ * un crédit, rendu par le callback de fin d'émission. Les voies "dernière
+ * valeur" (trame, ESS) n'ont qu'un emplacement : une nouvelle valeur
+ * remplace celle en attente. Le streaming passe par une file bornée.
+ * Priorité : voies dernière valeur (dans l'ordre de l'enum), puis streaming.
+ */
+#define TX_CREDITS        (CONFIG_BT_BUF_ACL_TX_COUNT - 2)  // marge pour ATT/L2CAP
+#define TX_STREAM_DEPTH   8
+#define TX_STREAM_MAX     244
+#define TX_LATEST_MAX     BLE_SENSOR_FRAME_SIZE
+#define TX_RETRY_MS       10
+
+enum tx_latest {
+    TX_FRAME,
+    TX_ACCEL,
+    TX_MAG,
+    TX_TEMP,
+    TX_HUMI,
+    TX_PRESS,
+    TX_STEPS,
+    TX_ORIENTATION,
+    TX_ALTITUDE,
+    TX_ACTIVITY,
+    TX_FORECAST,
+    TX_DERIVED,
+    TX_LATEST_COUNT,
+};
+
+struct tx_slot {
+    const struct bt_gatt_attr *attr;
+    uint8_t data[TX_LATEST_MAX];
+    uint8_t len;
+    bool pending;
+    uint8_t version;  // change à chaque remplacement
+};
+
+struct tx_packet {
+    uint8_t data[TX_STREAM_MAX];
+    uint16_t len;
+};
+
+static struct tx_slot tx_slots[TX_LATEST_COUNT];
+static struct tx_packet tx_stream[TX_STREAM_DEPTH];
+static uint8_t tx_stream_head;
+static uint8_t tx_stream_count;
+static struct k_spinlock tx_lock;
+static atomic_t tx_credits = ATOMIC_INIT(TX_CREDITS);
+static BleTxStats tx_stats;
+
+static void tx_process(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(tx_work, tx_process);
+
+static void tx_sent(struct bt_conn *conn, void *user_data)
+{
+    atomic_val_t credits;
+
+    // Jamais plus de TX_CREDITS, même si la pile rend un crédit en double
+    do {
+        credits = atomic_get(&tx_credits);
+        if (credits >= TX_CREDITS) {
+            break;
+        }
+    } while (!atomic_cas(&tx_credits, credits, credits + 1));
+    k_work_reschedule(&tx_work, K_NO_WAIT);
+}
+
+/* Référence sur la connexion courante, à rendre par bt_conn_unref() */
+static struct bt_conn *tx_conn_get(void)
+{
+    k_spinlock_key_t key = k_spin_lock(&tx_lock);
+    struct bt_conn *conn = current_conn ? bt_conn_ref(current_conn) : NULL;
+
+    k_spin_unlock(&tx_lock, key);
+    return conn;
+}
+
+static void tx_reset(void)
+{
+    k_spinlock_key_t key = k_spin_lock(&tx_lock);
+
+    for (int i = 0; i < TX_LATEST_COUNT; i++) {
+        tx_slots[i].pending = false;
+    }
+    tx_stream_count = 0;
+    // Crédits des envois en vol : rendus par tx_sent() quand la pile libère leurs buffers
+    k_spin_unlock(&tx_lock, key);
+}
+
+/* Voie dernière valeur : remplace la valeur encore en attente */
+static void tx_post_latest(enum tx_latest ch, const struct bt_gatt_attr *attr,
+                           const void *data, uint8_t len)
+{
+    if (!current_conn || !bt_gatt_is_subscribed(current_conn, attr, BT_GATT_CCC_NOTIFY)) {
+        return;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&tx_lock);
+    struct tx_slot *slot = &tx_slots[ch];
+
+    if (slot->pending) {
+        tx_stats.merged++;
+    } else {
+        tx_stats.queued++;
+    }
+    slot->attr = attr;
+    memcpy(slot->data, data, len);
+    slot->len = len;
+    slot->pending = true;
+    slot->version++;
+    k_spin_unlock(&tx_lock, key);
+
+    k_work_reschedule(&tx_work, K_NO_WAIT);
+}
+
+/* Streaming : file bornée, le paquet entrant est perdu si elle est pleine */
+static void tx_post_stream(const uint8_t *data, uint16_t len)
+{
+    if (!current_conn || len > TX_STREAM_MAX) {
+        return;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&tx_lock);
+
+    if (tx_stream_count == TX_STREAM_DEPTH) {
+        tx_stats.dropped++;
+        k_spin_unlock(&tx_lock, key);
+        return;
+    }
+    struct tx_packet *pkt = &tx_stream[(tx_stream_head + tx_stream_count) % TX_STREAM_DEPTH];
+    memcpy(pkt->data, data, len);
+    pkt->len = len;
+    tx_stream_count++;
+    tx_stats.queued++;
+    k_spin_unlock(&tx_lock, key);
+
+    k_work_reschedule(&tx_work, K_NO_WAIT);
+}
+
+static void tx_process(struct k_work *work)
+{
+    static uint8_t buf[TX_STREAM_MAX];
+    struct bt_conn *conn = tx_conn_get();
+
+    if (!conn) {
+        return;
+    }
+
+    while (atomic_get(&tx_credits) > 0) {
+        const struct bt_gatt_attr *attr = NULL;
+        uint16_t len = 0;
+        int ch = -1;
+        uint8_t version = 0;
+
+        // Copie de l'élément le plus prioritaire, envoi hors section critique
+        k_spinlock_key_t key = k_spin_lock(&tx_lock);
+        for (int i = 0; i < TX_LATEST_COUNT; i++) {
+            if (tx_slots[i].pending) {
+                ch = i;
+                attr = tx_slots[i].attr;
+                len = tx_slots[i].len;
+                version = tx_slots[i].version;
+                memcpy(buf, tx_slots[i].data, len);
+                break;
+            }
+        }
+        if (ch < 0 && tx_stream_count > 0) {
+            attr = IMU_STREAM_ATTR;
+            len = tx_stream[tx_stream_head].len;
+            memcpy(buf, tx_stream[tx_stream_head].data, len);
+        }
+        k_spin_unlock(&tx_lock, key);
+
+        if (attr == NULL) {
+            break;
+        }
+
+        struct bt_gatt_notify_params params = {
+            .attr = attr,
+            .data = buf,
+            .len = len,
+            .func = tx_sent,
+        };
+        int err = bt_gatt_notify_cb(conn, &params);
+
+        if (err == -ENOMEM || err == -ENOBUFS) {
+            // Plus de buffer dans la pile : nouvel essai au prochain crédit
+            k_work_schedule(&tx_work, K_MSEC(TX_RETRY_MS));
+            break;
+        }
+        if (err == -ENOTCONN) {
+            // Déconnexion pendant le passage : les files sont vidées par tx_reset()
+            break;
+        }
+
+        key = k_spin_lock(&tx_lock);
+        if (ch >= 0) {
+            // Une valeur plus récente arrivée pendant l'envoi reste en attente
+            if (tx_slots[ch].version == version) {
+                tx_slots[ch].pending = false;
+            }
+        } else {
+            tx_stream_head = (tx_stream_head + 1) % TX_STREAM_DEPTH;
+            tx_stream_count--;
+        }
+        if (err == 0) {
+            atomic_dec(&tx_credits);
+            tx_stats.sent++;
+        } else {
+            tx_stats.dropped++;
+        }
+        k_spin_unlock(&tx_lock, key);
+    }
+    bt_conn_unref(conn);
+}
+
+void ble_get_tx_stats(BleTxStats *stats)
+{
+    k_spinlock_key_t key = k_spin_lock(&tx_lock);
+    *stats = tx_stats;
+    k_spin_unlock(&tx_lock, key);
+}
 
 /* ==================== Callbacks de connexion ==================== */
 static void connected(struct bt_conn *conn, uint8_t err)
@@ -188,12 +712,27 @@ static void connected(struct bt_conn *conn, uint8_t err)
         LOG_ERR("Échec de connexion (err %u)", err);
     } else {
         LOG_INF("Connecté");
+        k_spinlock_key_t key = k_spin_lock(&tx_lock);
+        current_conn = bt_conn_ref(conn);
+        k_spin_unlock(&tx_lock, key);
     }
 }
 
 static void disconnected(struct bt_conn *conn, uint8_t reason)
 {
     LOG_INF("Déconnecté (raison %u)", reason);
+    imu_stream_control(false, 0);
+    tx_reset();
+    atomic_clear(&subscriptions);
+
+    k_spinlock_key_t key = k_spin_lock(&tx_lock);
+    struct bt_conn *old = current_conn;
+
+    current_conn = NULL;
+    k_spin_unlock(&tx_lock, key);
+    if (old) {
+        bt_conn_unref(old);
+    }
 }
 
 BT_CONN_CB_DEFINE(conn_callbacks) = {
@@ -211,6 +750,7 @@ static const struct bt_data sd[] = {
     BT_DATA_BYTES(BT_DATA_UUID16_ALL,
                   BT_UUID_ESS_VAL & 0xFF, BT_UUID_ESS_VAL >> 8,
                   BT_UUID_CTS_VAL & 0xFF, BT_UUID_CTS_VAL >> 8),
+    BT_DATA_BYTES(BT_DATA_UUID128_ALL, BT_UUID_ZSW_FRAME_SVC_VAL),
 };
 
 /* ==================== Initialisation ==================== */
@@ -226,6 +766,12 @@ void ble_init(void)
 
     LOG_INF("Bluetooth initialisé");
 
+    /* Négociation MTU / DLE / PHY à chaque connexion */
+    ble_link_init();
+
+    /* Téléchargement du journal par canal L2CAP (CONFIG_ZSWATCH_LOG_TRANSFER) */
+    ble_bulk_init();
+
     /* Charger les settings (bonding) */
     settings_load();
 
@@ -238,12 +784,22 @@ void ble_init(void)
 }
 
 /* ==================== Mise à jour des données capteurs ==================== */
+/* Voie ESS : valeur toujours lisible, notification inutile si la trame la porte déjà */
+static void tx_post_ess(enum tx_latest ch, const struct bt_gatt_attr *attr,
+                        const void *data, uint8_t len)
+{
+    if (ble_is_subscribed(BLE_CH_FRAME)) {
+        return;
+    }
+    tx_post_latest(ch, attr, data, len);
+}
+
 void ble_update_temperature(int16_t temp_100)
 {
     temp_value = temp_100;
     uint8_t buf[2];
     sys_put_le16(temp_value, buf);
-    bt_gatt_notify(NULL, TEMP_ATTR, buf, sizeof(buf));
+    tx_post_ess(TX_TEMP, TEMP_ATTR, buf, sizeof(buf));
 }
 
 void ble_update_humidity(uint16_t humi_100)
@@ -251,7 +807,7 @@ void ble_update_humidity(uint16_t humi_100)
     humi_value = humi_100;
     uint8_t buf[2];
     sys_put_le16(humi_value, buf);
-    bt_gatt_notify(NULL, HUMI_ATTR, buf, sizeof(buf));
+    tx_post_ess(TX_HUMI, HUMI_ATTR, buf, sizeof(buf));
 }
 
 void ble_update_pressure(uint32_t pressure)
@@ -259,7 +815,7 @@ void ble_update_pressure(uint32_t pressure)
     press_value = pressure;
     uint8_t buf[4];
     sys_put_le32(press_value, buf);
-    bt_gatt_notify(NULL, PRESS_ATTR, buf, sizeof(buf));
+    tx_post_ess(TX_PRESS, PRESS_ATTR, buf, sizeof(buf));
 }
 
 void ble_update_magnetometer(int16_t x_100, int16_t y_100, int16_t z_100)
@@ -267,7 +823,7 @@ void ble_update_magnetometer(int16_t x_100, int16_t y_100, int16_t z_100)
     mag_value[0] = x_100;
     mag_value[1] = y_100;
     mag_value[2] = z_100;
-    bt_gatt_notify(NULL, MAG_ATTR, mag_value, sizeof(mag_value));
+    tx_post_ess(TX_MAG, MAG_ATTR, mag_value, sizeof(mag_value));
 }
 
 void ble_update_acceleration(int16_t x_100, int16_t y_100, int16_t z_100)
@@ -275,11 +831,186 @@ void ble_update_acceleration(int16_t x_100, int16_t y_100, int16_t z_100)
     accel_value[0] = x_100;
     accel_value[1] = y_100;
     accel_value[2] = z_100;
-    bt_gatt_notify(NULL, ACCEL_ATTR, accel_value, sizeof(accel_value));
+    tx_post_ess(TX_ACCEL, ACCEL_ATTR, accel_value, sizeof(accel_value));
+}
+
+void ble_update_frame(const BleSensorFrame *f)
+{
+    if (!current_conn || !bt_gatt_is_subscribed(current_conn, FRAME_ATTR, BT_GATT_CCC_NOTIFY)) {
+        return;
+    }
+
+    // La trame ne se fragmente pas : refusée avant de consommer un numéro de séquence
+    if (ble_link_max_payload() < sizeof(frame_value)) {
+        LOG_WRN("MTU %u trop petit pour la trame (%zu octets)",
+                ble_link_max_payload() + 3, sizeof(frame_value));
+        return;
+    }
+    ble_frame_pack(frame_value, frame_seq++, k_uptime_get_32(), f);
+    tx_post_latest(TX_FRAME, FRAME_ATTR, frame_value, sizeof(frame_value));
+}
+
+void ble_update_steps(uint32_t steps, uint16_t cadence_spm, uint32_t distance_dm)
+{
+    sys_put_le32(steps, steps_value);
+    sys_put_le16(cadence_spm, &steps_value[4]);
+    sys_put_le32(distance_dm, &steps_value[6]);
+    tx_post_latest(TX_STEPS, STEPS_ATTR, steps_value, sizeof(steps_value));
+}
+
+void ble_update_orientation(const BleOrientation *o)
+{
+    uint8_t *p = orientation_value;
+
+    for (int i = 0; i < 4; i++) {
+        sys_put_le16(o->q_14[i], p);           p += 2;
+    }
+    for (int i = 0; i < 3; i++) {
+        sys_put_le16(o->euler_100[i], p);      p += 2;
+    }
+    for (int i = 0; i < 3; i++) {
+        sys_put_le16(o->lin_accel_100[i], p);  p += 2;
+    }
+    tx_post_latest(TX_ORIENTATION, ORIENTATION_ATTR, orientation_value, sizeof(orientation_value));
+}
+
+void ble_update_altitude(int32_t altitude_cm, int16_t vspeed_cms,
+                         uint16_t floors_up, uint16_t floors_down)
+{
+    sys_put_le32(altitude_cm, altitude_value);
+    sys_put_le16(vspeed_cms, &altitude_value[4]);
+    sys_put_le16(floors_up, &altitude_value[6]);
+    sys_put_le16(floors_down, &altitude_value[8]);
+    tx_post_latest(TX_ALTITUDE, ALTITUDE_ATTR, altitude_value, sizeof(altitude_value));
+}
+
+void ble_update_activity(uint8_t state, uint32_t since_ms)
+{
+    activity_value[0] = state;
+    sys_put_le32(since_ms, &activity_value[1]);
+    tx_post_latest(TX_ACTIVITY, ACTIVITY_ATTR, activity_value, sizeof(activity_value));
+}
+
+void ble_update_forecast(uint32_t sea_level_pa, int16_t delta_3h_pa, int16_t delta_24h_pa,
+                         uint8_t trend, uint8_t code, uint16_t span_24h_10)
+{
+    sys_put_le32(sea_level_pa, forecast_value);
+    sys_put_le16(delta_3h_pa, &forecast_value[4]);
+    sys_put_le16(delta_24h_pa, &forecast_value[6]);
+    forecast_value[8] = trend;
+    forecast_value[9] = code;
+    sys_put_le16(span_24h_10, &forecast_value[10]);
+    tx_post_latest(TX_FORECAST, FORECAST_ATTR, forecast_value, sizeof(forecast_value));
+}
+
+void ble_update_derived(const BleDerived *d)
+{
+    sys_put_le16(d->dew_point_100, derived_value);
+    sys_put_le16(d->abs_humidity_100, &derived_value[2]);
+    sys_put_le16(d->heat_index_100, &derived_value[4]);
+    sys_put_le16(d->accel_mg, &derived_value[6]);
+    sys_put_le16(d->pitch_100, &derived_value[8]);
+    sys_put_le16(d->roll_100, &derived_value[10]);
+    tx_post_latest(TX_DERIVED, DERIVED_ATTR, derived_value, sizeof(derived_value));
+}
+
+void ble_notify_imu_stream(const uint8_t *data, uint16_t len)
+{
+    tx_post_stream(data, len);
+}
+
+/* ==================== Alerte chute (indication) ==================== */
+/*
+ * Hors ordonnanceur de notifications : une indication attend l'acquittement
+ * du central, une seule à la fois. L'alerte suivante (confirmation) attend
+ * dans fall_value et part à la destruction des paramètres précédents.
+ */
+static uint8_t fall_tx[BLE_FALL_MAX_SIZE];
+static struct bt_gatt_indicate_params fall_ind;
+static struct k_spinlock fall_lock;
+static atomic_t fall_busy;
+static bool fall_pending;
+
+static void fall_send(void);
+
+static void fall_indicated(struct bt_conn *conn, struct bt_gatt_indicate_params *params,
+                           uint8_t err)
+{
+    if (err) {
+        LOG_WRN("Alerte chute non acquittée (err %u)", err);
+    }
+}
+
+static void fall_ind_destroy(struct bt_gatt_indicate_params *params)
+{
+    atomic_clear(&fall_busy);
+    fall_send();
+}
+
+static void fall_send(void)
+{
+    if (!current_conn || !bt_gatt_is_subscribed(current_conn, FALL_ATTR, BT_GATT_CCC_INDICATE) ||
+        !atomic_cas(&fall_busy, 0, 1)) {
+        return;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&fall_lock);
+    bool pending = fall_pending;
+    uint16_t len = fall_len;
+
+    memcpy(fall_tx, fall_value, len);
+    fall_pending = false;
+    k_spin_unlock(&fall_lock, key);
+
+    if (!pending) {
+        atomic_clear(&fall_busy);
+        return;
+    }
+    fall_ind = (struct bt_gatt_indicate_params){
+        .attr = FALL_ATTR,
+        .data = fall_tx,
+        .len = len,
+        .func = fall_indicated,
+        .destroy = fall_ind_destroy,
+    };
+    int err = bt_gatt_indicate(current_conn, &fall_ind);
+    if (err) {
+        LOG_WRN("Indication chute impossible (err %d)", err);
+        atomic_clear(&fall_busy);
+    }
+}
+
+void ble_indicate_fall(uint8_t phase, uint16_t peak_mg, uint16_t free_fall_ms,
+                       uint32_t impact_ms, uint16_t latency_100us,
+                       const int16_t (*snap)[3], uint8_t n_snap)
+{
+    // Instantané tronqué au MTU négocié : l'en-tête passe toujours
+    uint16_t room = ble_link_max_payload() - BLE_FALL_HEADER_SIZE;
+    n_snap = MIN(n_snap, MIN(BLE_FALL_SNAP_MAX, room / 6));
+
+    k_spinlock_key_t key = k_spin_lock(&fall_lock);
+    uint8_t *p = fall_value;
+
+    *p++ = phase;
+    *p++ = n_snap;
+    sys_put_le16(peak_mg, p);           p += 2;
+    sys_put_le16(free_fall_ms, p);      p += 2;
+    sys_put_le32(impact_ms, p);         p += 4;
+    sys_put_le16(latency_100us, p);     p += 2;
+    for (int i = 0; i < n_snap; i++) {
+        for (int k = 0; k < 3; k++) {
+            sys_put_le16(snap[i][k], p); p += 2;
+        }
+    }
+    fall_len = p - fall_value;
+    fall_pending = true;
+    k_spin_unlock(&fall_lock, key);
+
+    fall_send();
 }
 
 /* ==================== Fonction pour obtenir l'heure (pour la RTC) ==================== */
 uint32_t ble_get_current_time(void)
 {
-    return current_time;
+    return timebase_now_s();
 }
\ No newline at end of file
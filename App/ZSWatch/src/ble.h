@@ -1,6 +1,7 @@
 #ifndef BLE_H
 #define BLE_H
 
+#include <stdbool.h>
 #include <zephyr/types.h>
 
 /**
@@ -39,4 +40,183 @@ void ble_update_acceleration(int16_t x_100, int16_t y_100, int16_t z_100);
  */
 void ble_update_magnetometer(int16_t x_100, int16_t y_100, int16_t z_100);
 
+/**
+ * @brief Toutes les voies capteurs d'un cycle, mêmes unités que ble_update_*()
+ */
+typedef struct {
+    int16_t temp_100;      // °C * 100
+    uint16_t humi_100;     // % * 100
+    uint32_t pressure;     // Pa
+    int16_t accel_100[3];  // m/s² * 100
+    int16_t mag_100[3];    // gauss * 100
+} BleSensorFrame;
+
+/**
+ * @brief Envoie toutes les voies en une seule notification (service "sensor frame").
+ *
+ * Trame little-endian de BLE_SENSOR_FRAME_SIZE octets :
+ *   [0]  uint16 numéro de séquence (incrémenté à chaque trame)
+ *   [2]  uint32 horodatage (ms depuis le démarrage)
+ *   [6]  int16  température      [8]  uint16 humidité
+ *   [10] uint32 pression         [14] int16[3] accélération
+ *   [20] int16[3] magnétomètre
+ * Nécessite un ATT MTU >= BLE_SENSOR_FRAME_SIZE + 3 ; sinon seule la
+ * lecture de la caractéristique est possible. Les caractéristiques ESS
+ * restent disponibles pour les clients génériques ; tant que la trame est
+ * notifiée, elles ne sont plus notifiées mais restent lisibles.
+ */
+void ble_update_frame(const BleSensorFrame *f);
+
+#define BLE_SENSOR_FRAME_SIZE 26
+
+/**
+ * @brief Sérialise une trame au format ci-dessus (BLE_SENSOR_FRAME_SIZE
+ *        octets), sans effet de bord : partagé avec les tests de décodage.
+ */
+void ble_frame_pack(uint8_t *out, uint16_t seq, uint32_t time_ms, const BleSensorFrame *f);
+
+/**
+ * @brief Notifie un paquet de streaming IMU déjà encodé (voir imu_stream.h)
+ */
+void ble_notify_imu_stream(const uint8_t *data, uint16_t len);
+
+/**
+ * @brief Met à jour le podomètre (service "sensor frame", little-endian) :
+ *        [0] uint32 pas  [4] uint16 cadence (pas/min)  [6] uint32 distance (dm)
+ */
+void ble_update_steps(uint32_t steps, uint16_t cadence_spm, uint32_t distance_dm);
+
+#define BLE_STEPS_SIZE 10
+
+/**
+ * @brief Orientation issue de la fusion 9 axes (voir ahrs.h)
+ */
+typedef struct {
+    int16_t q_14[4];          // quaternion w, x, y, z * 16384
+    int16_t euler_100[3];     // roulis, tangage, lacet (° * 100)
+    int16_t lin_accel_100[3]; // accélération sans gravité (m/s² * 100)
+} BleOrientation;
+
+/**
+ * @brief Notifie l'orientation (service "sensor frame", little-endian) :
+ *        [0] int16[4] quaternion  [8] int16[3] Euler  [14] int16[3] accél. linéaire.
+ *        BLE_ORIENTATION_SIZE octets : tient dans le MTU par défaut.
+ */
+void ble_update_orientation(const BleOrientation *o);
+
+#define BLE_ORIENTATION_SIZE 20
+
+/**
+ * @brief Met à jour l'altimètre (service "sensor frame", little-endian) :
+ *        [0] int32 altitude relative (cm)  [4] int16 vitesse verticale (cm/s)
+ *        [6] uint16 étages montés  [8] uint16 étages descendus
+ */
+void ble_update_altitude(int32_t altitude_cm, int16_t vspeed_cms,
+                         uint16_t floors_up, uint16_t floors_down);
+
+#define BLE_ALTITUDE_SIZE 10
+
+/**
+ * @brief Publie un changement d'activité (service "sensor frame") :
+ *        [0] uint8 ActivityState  [1] uint32 instant du changement (ms depuis le démarrage)
+ *        Appelée aux changements d'état seulement.
+ */
+void ble_update_activity(uint8_t state, uint32_t since_ms);
+
+#define BLE_ACTIVITY_SIZE 5
+
+/**
+ * @brief Alerte chute par indication (acquittée par le central), little-endian :
+ *        [0] uint8 phase (1 impact, 2 confirmée, 3 relevé)  [1] uint8 n
+ *        [2] uint16 pic (mg)  [4] uint16 chute libre (ms)
+ *        [6] uint32 instant de l'impact (ms depuis le démarrage)
+ *        [10] uint16 latence impact -> alerte (0.1 ms)
+ *        [12] n x int16[3] accélération avant la chute (mg), tronqué au MTU
+ *        Appelable depuis un work ; une alerte arrivée pendant l'attente
+ *        d'acquittement remplace la précédente non envoyée.
+ */
+void ble_indicate_fall(uint8_t phase, uint16_t peak_mg, uint16_t free_fall_ms,
+                       uint32_t impact_ms, uint16_t latency_100us,
+                       const int16_t (*snap)[3], uint8_t n_snap);
+
+#define BLE_FALL_HEADER_SIZE 12
+#define BLE_FALL_SNAP_MAX    24
+#define BLE_FALL_MAX_SIZE    (BLE_FALL_HEADER_SIZE + BLE_FALL_SNAP_MAX * 6)
+
+/**
+ * @brief Met à jour la prévision météo (service "sensor frame", little-endian) :
+ *        [0] uint32 pression niveau mer (Pa)  [4] int16 tendance sur 3 h (Pa)
+ *        [6] int16 variation sur 24 h (Pa)  [8] uint8 ForecastTrend
+ *        [9] uint8 code Zambretti (0 .. 25, 0xFF sans historique)
+ *        [10] uint16 profondeur de l'historique 24 h (h * 10)
+ *        Appelée à chaque tranche close (5 min).
+ */
+void ble_update_forecast(uint32_t sea_level_pa, int16_t delta_3h_pa, int16_t delta_24h_pa,
+                         uint8_t trend, uint8_t code, uint16_t span_24h_10);
+
+#define BLE_FORECAST_SIZE 12
+
+/**
+ * @brief Grandeurs dérivées (voir derived.h)
+ */
+typedef struct {
+    int16_t dew_point_100;      // °C * 100
+    uint16_t abs_humidity_100;  // g/m³ * 100
+    int16_t heat_index_100;     // °C * 100
+    uint16_t accel_mg;          // |a|
+    int16_t pitch_100;          // degrés * 100
+    int16_t roll_100;
+} BleDerived;
+
+/**
+ * @brief Notifie les grandeurs dérivées (service "sensor frame", little-endian) :
+ *        [0] int16 rosée  [2] uint16 humidité absolue  [4] int16 ressenti
+ *        [6] uint16 |a|  [8] int16 tangage  [10] int16 roulis
+ */
+void ble_update_derived(const BleDerived *d);
+
+#define BLE_DERIVED_SIZE 12
+
+/**
+ * @brief Compteurs de l'ordonnanceur d'émission
+ */
+typedef struct {
+    uint32_t queued;   // notifications mises en file
+    uint32_t sent;     // notifications transmises à la pile
+    uint32_t merged;   // valeurs remplacées avant envoi (dernière valeur gagne)
+    uint32_t dropped;  // paquets perdus (file pleine ou erreur d'envoi)
+} BleTxStats;
+
+void ble_get_tx_stats(BleTxStats *stats);
+
+/**
+ * @brief Caractéristiques notifiables, suivies par leur CCC
+ */
+typedef enum {
+    BLE_CH_TEMP,
+    BLE_CH_HUMI,
+    BLE_CH_PRESS,
+    BLE_CH_MAG,
+    BLE_CH_ACCEL,
+    BLE_CH_FRAME,
+    BLE_CH_IMU_STREAM,
+    BLE_CH_STEPS,
+    BLE_CH_ORIENTATION,
+    BLE_CH_ALTITUDE,
+    BLE_CH_ACTIVITY,
+    BLE_CH_FALL,
+    BLE_CH_FORECAST,
+    BLE_CH_DERIVED,
+    BLE_CH_COUNT,
+} BleChannel;
+
+/* true si le central connecté a activé les notifications de la voie */
+bool ble_is_subscribed(BleChannel ch);
+
+/**
+ * @brief Heure courante (s depuis 1970), tenue par timebase.c depuis la
+ *        dernière écriture Current Time ; temps depuis le démarrage sinon.
+ */
+uint32_t ble_get_current_time(void);
+
 #endif /* BLE_H */
\ No newline at end of file
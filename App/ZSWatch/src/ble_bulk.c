@@ -0,0 +1,229 @@
+#include "ble_bulk.h"
+
+#ifdef CONFIG_ZSWATCH_LOG_TRANSFER
+
+#include <zephyr/kernel.h>
+#include <zephyr/bluetooth/bluetooth.h>
+#include <zephyr/bluetooth/conn.h>
+#include <zephyr/bluetooth/l2cap.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/logging/log.h>
+#include <string.h>
+#include "ble_link.h"
+#include "sensor_log.h"
+
+LOG_MODULE_REGISTER(ble_bulk, LOG_LEVEL_INF);
+
+#define BULK_SDU_MAX     1024  // SDU découpée en PDU de MPS octets par la pile
+#define BULK_BUF_COUNT   4     // SDU en vol : la pile les libère au fil des crédits
+#define BULK_HEADER_SIZE 1
+#define BULK_BLOCK_HDR   2
+#define BULK_REQ_SIZE    5
+
+NET_BUF_POOL_FIXED_DEFINE(bulk_pool, BULK_BUF_COUNT, BT_L2CAP_SDU_BUF_SIZE(BULK_SDU_MAX),
+                          CONFIG_BT_CONN_TX_USER_DATA_SIZE, NULL);
+
+static struct bt_l2cap_le_chan bulk_chan;
+static bool chan_busy;
+
+enum { STOP_NONE, STOP_CENTRAL, STOP_LINK };
+
+// Requêtes reçues dans le thread BT, appliquées par le work : lui seul
+// touche à l'état du transfert et au curseur
+static atomic_t busy;            // requête acceptée, jusqu'à la fin du transfert
+static atomic_t req_pending;
+static atomic_t stop_req;        // STOP_*
+static uint32_t req_from_s;
+
+// Transfert en cours (work de la workqueue système uniquement)
+static SensorLogCursor cursor;
+static bool running;
+static const uint8_t *block;     // bloc lu mais pas encore envoyé (dans cursor)
+static uint16_t block_len;
+static uint32_t records_sent;
+static uint32_t bytes_sent;
+static int64_t start_ms;
+
+static void bulk_fill(struct k_work *work);
+static K_WORK_DEFINE(bulk_work, bulk_fill);
+
+static void transfer_stop(const char *reason)
+{
+    if (running) {
+        running = false;
+        ble_link_set_demand(BLE_LINK_DEMAND_BULK, false);
+
+        uint32_t ms = MAX((uint32_t)(k_uptime_get() - start_ms), 1U);
+        LOG_INF("Transfert %s : %u enreg., %u octets en %u ms (%u kB/s)",
+                reason, records_sent, bytes_sent, ms, bytes_sent / ms);
+    }
+    atomic_clear(&busy);  // nouvelle requête acceptée
+}
+
+static void transfer_start(uint32_t from_s)
+{
+    records_sent = 0;
+    bytes_sent = 0;
+    start_ms = k_uptime_get();
+
+    // Échec : curseur vide, une SDU de fin est envoyée
+    block = NULL;
+    if (sensor_log_seek(from_s, &cursor) != 0 ||
+        sensor_log_next_block(&cursor, &block, &block_len) != 0) {
+        block = NULL;
+    }
+
+    LOG_INF("Transfert depuis %u s", from_s);
+    ble_link_set_demand(BLE_LINK_DEMAND_BULK, true);
+    running = true;
+}
+
+/* Remplit et envoie des SDU tant qu'un tampon est libre */
+static void bulk_fill(struct k_work *work)
+{
+    uint16_t sdu_max = MIN(bulk_chan.tx.mtu, BULK_SDU_MAX);
+    atomic_val_t stop = atomic_set(&stop_req, STOP_NONE);
+
+    if (stop != STOP_NONE) {
+        // Arrêt demandé avant ou pendant le transfert : requête en attente annulée
+        atomic_clear(&req_pending);
+        transfer_stop(stop == STOP_CENTRAL ? "arrêté" : "interrompu");
+        return;
+    }
+    if (atomic_cas(&req_pending, 1, 0)) {
+        transfer_start(req_from_s);
+    }
+
+    while (running) {
+        struct net_buf *buf = net_buf_alloc(&bulk_pool, K_NO_WAIT);
+
+        if (!buf) {
+            // Tous les tampons en vol : relancé par bulk_sent()
+            return;
+        }
+        net_buf_reserve(buf, BT_L2CAP_SDU_CHAN_SEND_RESERVE);
+
+        uint8_t *hdr = net_buf_add(buf, BULK_HEADER_SIZE);
+        uint8_t count = 0;
+
+        // Blocs entiers, copiés tels qu'écrits en flash
+        while (block && count < UINT8_MAX &&
+               buf->len + BULK_BLOCK_HDR + block_len <= sdu_max) {
+            net_buf_add_le16(buf, block_len);
+            net_buf_add_mem(buf, block, block_len);
+            records_sent += block[0];
+            count++;
+            if (sensor_log_next_block(&cursor, &block, &block_len) != 0) {
+                block = NULL;
+            }
+        }
+        hdr[0] = count;
+
+        if (count == 0 && block) {
+            // MTU du central plus petite qu'un bloc : transfert impossible
+            net_buf_unref(buf);
+            LOG_WRN("MTU %u trop petite pour un bloc de %u octets", sdu_max, block_len);
+            transfer_stop("interrompu");
+            return;
+        }
+
+        // La pile garde le tampon jusqu'à l'envoi effectif (crédits du central)
+        uint16_t len = buf->len;
+        int ret = bt_l2cap_chan_send(&bulk_chan.chan, buf);
+        if (ret < 0) {
+            net_buf_unref(buf);
+            transfer_stop("interrompu");
+            return;
+        }
+        bytes_sent += len;
+
+        if (count == 0) {
+            // SDU vide envoyée : fin du journal
+            transfer_stop("terminé");
+        }
+    }
+}
+
+/* ==================== Canal L2CAP ==================== */
+static int bulk_recv(struct bt_l2cap_chan *chan, struct net_buf *buf)
+{
+    if (buf->len >= 1 && buf->data[0] == BLE_BULK_OP_STOP) {
+        atomic_set(&stop_req, STOP_CENTRAL);
+        k_work_submit(&bulk_work);
+        return 0;
+    }
+    if (buf->len < BULK_REQ_SIZE || buf->data[0] != BLE_BULK_OP_READ) {
+        LOG_WRN("Requête invalide (%u octets)", buf->len);
+        return 0;
+    }
+    if (!atomic_cas(&busy, 0, 1)) {
+        LOG_WRN("Transfert déjà en cours");
+        return 0;
+    }
+    // Aucun transfert en cours : un arrêt encore en attente ne vise pas cette requête
+    atomic_clear(&stop_req);
+    req_from_s = sys_get_le32(&buf->data[1]);
+    atomic_set(&req_pending, 1);
+    k_work_submit(&bulk_work);
+    return 0;
+}
+
+static void bulk_sent(struct bt_l2cap_chan *chan)
+{
+    k_work_submit(&bulk_work);
+}
+
+static void bulk_connected(struct bt_l2cap_chan *chan)
+{
+    LOG_INF("Canal L2CAP ouvert (MTU TX %u, MPS %u)", bulk_chan.tx.mtu, bulk_chan.tx.mps);
+}
+
+static void bulk_disconnected(struct bt_l2cap_chan *chan)
+{
+    atomic_set(&stop_req, STOP_LINK);
+    k_work_submit(&bulk_work);
+    chan_busy = false;
+}
+
+static const struct bt_l2cap_chan_ops bulk_ops = {
+    .connected = bulk_connected,
+    .disconnected = bulk_disconnected,
+    .recv = bulk_recv,
+    .sent = bulk_sent,
+};
+
+static int bulk_accept(struct bt_conn *conn, struct bt_l2cap_server *server,
+                       struct bt_l2cap_chan **chan)
+{
+    if (chan_busy) {
+        return -ENOMEM;
+    }
+    memset(&bulk_chan, 0, sizeof(bulk_chan));
+    bulk_chan.chan.ops = &bulk_ops;
+    chan_busy = true;
+    *chan = &bulk_chan.chan;
+    return 0;
+}
+
+static struct bt_l2cap_server bulk_server = {
+    .psm = BLE_BULK_PSM,
+    .sec_level = BT_SECURITY_L1,
+    .accept = bulk_accept,
+};
+
+void ble_bulk_init(void)
+{
+    int err = bt_l2cap_server_register(&bulk_server);
+
+    if (err) {
+        LOG_ERR("Serveur L2CAP refusé (err %d)", err);
+    }
+}
+
+#else
+
+void ble_bulk_init(void)
+{
+}
+
+#endif /* CONFIG_ZSWATCH_LOG_TRANSFER */
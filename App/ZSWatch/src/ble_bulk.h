@@ -0,0 +1,30 @@
+#ifndef BLE_BULK_H
+#define BLE_BULK_H
+
+/*
+ * Téléchargement du journal capteurs sur un canal L2CAP orienté connexion
+ * (LE CoC, contrôle de flux par crédits), PSM BLE_BULK_PSM.
+ *
+ * Requête (central -> montre, little-endian) :
+ *   [0] uint8  BLE_BULK_OP_READ
+ *   [1] uint32 horodatage de départ (s, horloge du journal)
+ *   ou [0] uint8 BLE_BULK_OP_STOP
+ *
+ * Réponse : suite de SDU
+ *   [0] uint8  nombre de blocs n (0 = fin du journal)
+ *   puis n fois : uint16 longueur, bloc compressé (ts_codec.h, voies
+ *   SENSOR_LOG_CH_*), décodable indépendamment des autres.
+ * Le premier bloc peut contenir des enregistrements antérieurs à
+ * l'horodatage de départ : le central les ignore. Après une coupure, il
+ * reprend avec le dernier horodatage reçu + 1.
+ */
+#define BLE_BULK_PSM      0x0085
+#define BLE_BULK_OP_READ  0x01
+#define BLE_BULK_OP_STOP  0x02
+
+/**
+ * @brief Enregistre le serveur L2CAP (à appeler après bt_enable)
+ */
+void ble_bulk_init(void);
+
+#endif
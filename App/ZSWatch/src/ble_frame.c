@@ -0,0 +1,20 @@
+#include "ble.h"
+#include <zephyr/sys/byteorder.h>
+
+/* ==================== Trame "sensor frame" (format : ble.h) ==================== */
+void ble_frame_pack(uint8_t *out, uint16_t seq, uint32_t time_ms, const BleSensorFrame *f)
+{
+    uint8_t *p = out;
+
+    sys_put_le16(seq, p);                      p += 2;
+    sys_put_le32(time_ms, p);                  p += 4;
+    sys_put_le16(f->temp_100, p);              p += 2;
+    sys_put_le16(f->humi_100, p);              p += 2;
+    sys_put_le32(f->pressure, p);              p += 4;
+    for (int i = 0; i < 3; i++) {
+        sys_put_le16(f->accel_100[i], p);      p += 2;
+    }
+    for (int i = 0; i < 3; i++) {
+        sys_put_le16(f->mag_100[i], p);        p += 2;
+    }
+}
@@ -0,0 +1,286 @@
+#include "ble_link.h"
+#include <zephyr/kernel.h>
+#include <zephyr/bluetooth/bluetooth.h>
+#include <zephyr/bluetooth/conn.h>
+#include <zephyr/bluetooth/gatt.h>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(ble_link, LOG_LEVEL_INF);
+
+/* Valeurs par défaut du Bluetooth LE avant toute négociation */
+#define LINK_DEFAULT_MTU     23
+#define LINK_DEFAULT_LL_LEN  27
+
+static BleLinkInfo link = {
+    .mtu = LINK_DEFAULT_MTU,
+    .tx_len = LINK_DEFAULT_LL_LEN,
+    .rx_len = LINK_DEFAULT_LL_LEN,
+    .tx_phy = BT_GAP_LE_PHY_1M,
+    .rx_phy = BT_GAP_LE_PHY_1M,
+};
+
+static struct bt_gatt_exchange_params mtu_params;
+
+/* ==================== Politique des paramètres de connexion ==================== */
+// Intervalles en unités de 1.25 ms, supervision timeout en unités de 10 ms
+#define LINK_FAST_INTERVAL_MIN  6     // 7.5 ms
+#define LINK_FAST_INTERVAL_MAX  12    // 15 ms
+#define LINK_FAST_LATENCY       0
+#define LINK_FAST_TIMEOUT       400   // 4 s
+#define LINK_SLOW_INTERVAL_MIN  320   // 400 ms
+#define LINK_SLOW_INTERVAL_MAX  400   // 500 ms
+#define LINK_SLOW_LATENCY       3     // réveil au moins toutes les 2 s
+#define LINK_SLOW_TIMEOUT       600   // 6 s > 2 * (1 + latence) * intervalle max
+
+#define LINK_SLOW_HOLDOFF_MS    5000  // sans demande depuis ce délai : intervalle long
+#define LINK_RETRY_MS           1000  // nouvel essai si la demande n'a pu partir
+#define LINK_REJECT_RETRY_MS    30000 // la centrale a imposé d'autres valeurs
+
+#define LINK_INTERVAL_US(i)     ((uint32_t)(i) * 1250)
+
+enum link_profile {
+    LINK_PROFILE_NONE,  // paramètres choisis par la centrale
+    LINK_PROFILE_FAST,
+    LINK_PROFILE_SLOW,
+};
+
+static const struct bt_le_conn_param fast_param =
+    BT_LE_CONN_PARAM_INIT(LINK_FAST_INTERVAL_MIN, LINK_FAST_INTERVAL_MAX,
+                          LINK_FAST_LATENCY, LINK_FAST_TIMEOUT);
+static const struct bt_le_conn_param slow_param =
+    BT_LE_CONN_PARAM_INIT(LINK_SLOW_INTERVAL_MIN, LINK_SLOW_INTERVAL_MAX,
+                          LINK_SLOW_LATENCY, LINK_SLOW_TIMEOUT);
+
+static struct bt_conn *link_conn;
+static atomic_t demand;           // bit = BleLinkDemand
+static atomic_t demand_idle_ms;   // k_uptime_get_32() de la dernière demande relâchée
+static enum link_profile requested;
+
+// Estimation des événements de connexion : segments à paramètres constants
+static uint32_t events_base;
+static int64_t segment_start_ms;
+
+static void param_eval(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(param_work, param_eval);
+
+static void link_reset(void)
+{
+    link.mtu = LINK_DEFAULT_MTU;
+    link.tx_len = LINK_DEFAULT_LL_LEN;
+    link.rx_len = LINK_DEFAULT_LL_LEN;
+    link.tx_phy = BT_GAP_LE_PHY_1M;
+    link.rx_phy = BT_GAP_LE_PHY_1M;
+    link.interval = 0;
+    link.latency = 0;
+    link.timeout = 0;
+    requested = LINK_PROFILE_NONE;
+}
+
+/* Le périphérique peut sauter "latence" événements : un réveil tous les (latence + 1) */
+static uint32_t segment_events(int64_t now_ms)
+{
+    if (link.interval == 0) {
+        return 0;
+    }
+    return (uint32_t)((now_ms - segment_start_ms) * 1000 /
+                      ((int64_t)LINK_INTERVAL_US(link.interval) * (link.latency + 1)));
+}
+
+/* Nouveaux paramètres : on clôt le segment d'estimation en cours */
+static void params_set(uint16_t interval, uint16_t latency, uint16_t timeout)
+{
+    int64_t now = k_uptime_get();
+
+    events_base += segment_events(now);
+    segment_start_ms = now;
+    link.interval = interval;
+    link.latency = latency;
+    link.timeout = timeout;
+}
+
+static bool params_match(const struct bt_le_conn_param *p)
+{
+    return link.interval >= p->interval_min && link.interval <= p->interval_max &&
+           link.latency == p->latency;
+}
+
+/*
+ * Hystérésis : passage immédiat à l'intervalle court dès qu'une demande
+ * apparaît, retour à l'intervalle long seulement après LINK_SLOW_HOLDOFF_MS
+ * sans demande (évite de renégocier à chaque arrêt / reprise du streaming).
+ */
+static void param_eval(struct k_work *work)
+{
+    if (!link_conn) {
+        return;
+    }
+
+    bool fast = atomic_get(&demand) != 0;
+
+    if (!fast) {
+        int32_t idle = (int32_t)(k_uptime_get_32() - (uint32_t)atomic_get(&demand_idle_ms));
+
+        if (idle < LINK_SLOW_HOLDOFF_MS) {
+            k_work_reschedule(&param_work, K_MSEC(LINK_SLOW_HOLDOFF_MS - idle));
+            return;
+        }
+    }
+
+    enum link_profile want = fast ? LINK_PROFILE_FAST : LINK_PROFILE_SLOW;
+    const struct bt_le_conn_param *param = fast ? &fast_param : &slow_param;
+
+    if (want == requested) {
+        return;
+    }
+    if (params_match(param)) {
+        requested = want;
+        return;
+    }
+
+    int ret = bt_conn_le_param_update(link_conn, param);
+
+    if (ret) {
+        LOG_WRN("Demande de paramètres refusée (err %d)", ret);
+        k_work_reschedule(&param_work, K_MSEC(LINK_RETRY_MS));
+        return;
+    }
+    requested = want;
+    link.param_requests++;
+    LOG_INF("Demande intervalle %s", fast ? "court" : "long");
+}
+
+/* ==================== Négociation ==================== */
+static void mtu_exchanged(struct bt_conn *conn, uint8_t err,
+                          struct bt_gatt_exchange_params *params)
+{
+    if (err) {
+        LOG_WRN("Échange MTU échoué (err %u)", err);
+        return;
+    }
+    link.mtu = bt_gatt_get_mtu(conn);
+    LOG_INF("MTU négocié : %u", link.mtu);
+}
+
+static void connected(struct bt_conn *conn, uint8_t err)
+{
+    int ret;
+
+    struct bt_conn_info info;
+
+    if (err) {
+        return;
+    }
+    link_reset();
+
+    link_conn = bt_conn_ref(conn);
+    if (bt_conn_get_info(conn, &info) == 0) {
+        params_set(info.le.interval, info.le.latency, info.le.timeout);
+    }
+    // Laisse la centrale découvrir les services à son rythme avant de ralentir
+    atomic_set(&demand_idle_ms, k_uptime_get_32());
+    k_work_reschedule(&param_work, K_NO_WAIT);
+
+    // Les trois demandes sont indépendantes : un refus n'empêche pas les autres
+    ret = bt_conn_le_data_len_update(conn, BT_LE_DATA_LEN_PARAM_MAX);
+    if (ret) {
+        LOG_WRN("Demande DLE refusée (err %d)", ret);
+    }
+
+    ret = bt_conn_le_phy_update(conn, BT_CONN_LE_PHY_PARAM_2M);
+    if (ret) {
+        LOG_WRN("Demande PHY 2M refusée (err %d)", ret);
+    }
+
+    mtu_params.func = mtu_exchanged;
+    ret = bt_gatt_exchange_mtu(conn, &mtu_params);
+    if (ret) {
+        LOG_WRN("Échange MTU impossible (err %d)", ret);
+    }
+}
+
+static void disconnected(struct bt_conn *conn, uint8_t reason)
+{
+    k_work_cancel_delayable(&param_work);
+    params_set(0, 0, 0);
+    link_reset();
+    atomic_clear(&demand);
+    if (link_conn) {
+        bt_conn_unref(link_conn);
+        link_conn = NULL;
+    }
+}
+
+static void param_updated(struct bt_conn *conn, uint16_t interval,
+                          uint16_t latency, uint16_t timeout)
+{
+    params_set(interval, latency, timeout);
+    link.param_updates++;
+    LOG_INF("Connexion : intervalle %u us, latence %u, timeout %u ms",
+            LINK_INTERVAL_US(interval), latency, timeout * 10);
+
+    // La centrale a pu imposer d'autres valeurs : on réévalue plus tard
+    if (requested != LINK_PROFILE_NONE &&
+        !params_match(requested == LINK_PROFILE_FAST ? &fast_param : &slow_param)) {
+        requested = LINK_PROFILE_NONE;
+        k_work_reschedule(&param_work, K_MSEC(LINK_REJECT_RETRY_MS));
+    }
+}
+
+static void data_len_updated(struct bt_conn *conn, struct bt_conn_le_data_len_info *info)
+{
+    link.tx_len = info->tx_max_len;
+    link.rx_len = info->rx_max_len;
+    LOG_INF("Data length : TX %u / RX %u octets", link.tx_len, link.rx_len);
+}
+
+static void phy_updated(struct bt_conn *conn, struct bt_conn_le_phy_info *info)
+{
+    link.tx_phy = info->tx_phy;
+    link.rx_phy = info->rx_phy;
+    LOG_INF("PHY : TX %u / RX %u", link.tx_phy, link.rx_phy);
+}
+
+BT_CONN_CB_DEFINE(link_callbacks) = {
+    .connected = connected,
+    .disconnected = disconnected,
+    .le_data_len_updated = data_len_updated,
+    .le_phy_updated = phy_updated,
+    .le_param_updated = param_updated,
+};
+
+/* MTU mis à jour, y compris quand l'échange est initié par la centrale */
+static void att_mtu_updated(struct bt_conn *conn, uint16_t tx, uint16_t rx)
+{
+    link.mtu = MIN(tx, rx);
+}
+
+static struct bt_gatt_cb gatt_callbacks = {
+    .att_mtu_updated = att_mtu_updated,
+};
+
+/* ==================== API ==================== */
+void ble_link_init(void)
+{
+    bt_gatt_cb_register(&gatt_callbacks);
+}
+
+void ble_link_get(BleLinkInfo *info)
+{
+    *info = link;
+    info->conn_events = events_base + segment_events(k_uptime_get());
+}
+
+uint16_t ble_link_max_payload(void)
+{
+    return link.mtu - 3;
+}
+
+void ble_link_set_demand(BleLinkDemand src, bool active)
+{
+    if (active) {
+        atomic_set_bit(&demand, src);
+    } else if (atomic_test_and_clear_bit(&demand, src)) {
+        atomic_set(&demand_idle_ms, k_uptime_get_32());
+    }
+    k_work_reschedule(&param_work, K_NO_WAIT);
+}
@@ -0,0 +1,62 @@
+#ifndef BLE_LINK_H
+#define BLE_LINK_H
+
+#include <stdbool.h>
+#include <zephyr/types.h>
+
+/**
+ * @brief Paramètres du lien négociés avec la centrale
+ */
+typedef struct {
+    uint16_t mtu;     // ATT MTU
+    uint16_t tx_len;  // charge utile LL max en émission (DLE)
+    uint16_t rx_len;  // charge utile LL max en réception
+    uint8_t tx_phy;   // BT_GAP_LE_PHY_1M / BT_GAP_LE_PHY_2M
+    uint8_t rx_phy;
+    uint16_t interval;      // intervalle de connexion (unités de 1.25 ms)
+    uint16_t latency;       // latence périphérique (événements sautés)
+    uint16_t timeout;       // supervision timeout (unités de 10 ms)
+    uint32_t param_requests;  // demandes bt_conn_le_param_update() envoyées
+    uint32_t param_updates;   // changements de paramètres appliqués
+    uint32_t conn_events;     // événements de connexion du périphérique (estimés, latence comprise)
+} BleLinkInfo;
+
+/**
+ * @brief Sources de trafic demandant un intervalle de connexion court
+ */
+typedef enum {
+    BLE_LINK_DEMAND_STREAM,  // streaming IMU pleine cadence
+    BLE_LINK_DEMAND_BULK,    // transfert en masse
+} BleLinkDemand;
+
+/**
+ * @brief Enregistre les callbacks de négociation (à appeler après bt_enable).
+ *
+ * À chaque connexion, demande un échange de MTU, la Data Length Extension
+ * (251 octets) et le PHY 2M ; les valeurs obtenues sont mémorisées.
+ * Les paramètres de connexion suivent ensuite les demandes de trafic
+ * (voir ble_link_set_demand).
+ */
+void ble_link_init(void);
+
+/**
+ * @brief Copie les paramètres courants (valeurs par défaut hors connexion)
+ */
+void ble_link_get(BleLinkInfo *info);
+
+/**
+ * @brief Taille maximale d'une notification GATT (ATT MTU - 3)
+ */
+uint16_t ble_link_max_payload(void);
+
+/**
+ * @brief Signale le début / la fin d'un trafic soutenu.
+ *
+ * Tant qu'une demande est active, l'intervalle court (7.5-15 ms, sans
+ * latence) est demandé immédiatement. Sans demande depuis 5 s, on revient à
+ * l'intervalle long (400-500 ms, latence 3) suffisant pour les mises à jour
+ * toutes les 2 s.
+ */
+void ble_link_set_demand(BleLinkDemand src, bool active);
+
+#endif
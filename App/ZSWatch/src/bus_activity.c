@@ -0,0 +1,33 @@
+#include <stdio.h>
+#include "sensor_bus.h"
+#include "activity.h"
+#include "ble.h"
+
+#ifdef CONFIG_ZSWATCH_ACTIVITY
+
+/* Reconnaissance d'activité : publiée aux changements d'état seulement */
+static void activity_cb(const struct zbus_channel *chan)
+{
+    const SensorBatchMsg *b = zbus_chan_const_msg(chan);
+    ActivityInfo act;
+
+    if (activity_feed(b->imu, b->n_imu)) {
+        activity_get(&act);
+        ble_update_activity(act.state, act.since_ms);
+    }
+    if (!b->dashboard) {
+        return;
+    }
+    activity_get(&act);
+    printf("Activite: %s depuis %u s | ecart-type %d mg | SMA %d mg | ZCR %d.%d Hz | "
+           "pic %d.%02d Hz (%d %%)\n\n", activity_name(act.state),
+           (k_uptime_get_32() - act.since_ms) / 1000, (int)(act.features.std_g * 1000),
+           (int)(act.features.sma_g * 1000), (int)act.features.zcr_hz,
+           (int)(act.features.zcr_hz * 10) % 10, (int)act.features.dom_hz,
+           (int)(act.features.dom_hz * 100) % 100, (int)(act.features.periodicity * 100));
+}
+
+ZBUS_LISTENER_DEFINE(bus_activity, activity_cb);
+ZBUS_CHAN_ADD_OBS(sensor_batch_chan, bus_activity, SENSOR_BUS_PRIO_ALGO);
+
+#endif /* CONFIG_ZSWATCH_ACTIVITY */
@@ -0,0 +1,44 @@
+#include <stdio.h>
+#include "sensor_bus.h"
+#include "ahrs.h"
+#include "ble.h"
+
+#ifdef CONFIG_ZSWATCH_AHRS
+
+/* Fusion 9 axes, calculée et notifiée à chaque lot tant qu'un central est abonné */
+static void ahrs_cb(const struct zbus_channel *chan)
+{
+    const SensorBatchMsg *b = zbus_chan_const_msg(chan);
+    AhrsOutput o;
+
+    if (!ble_is_subscribed(BLE_CH_ORIENTATION)) {
+        return;
+    }
+    if (b->n_mag > 0) {
+        ahrs_set_mag(&b->mag[b->n_mag - 1]);
+    }
+    ahrs_feed(b->imu, b->n_imu);
+    ahrs_get(&o);
+
+    BleOrientation bo;
+    for (int i = 0; i < 4; i++) {
+        bo.q_14[i] = (int16_t)(o.q[i] * 16384.0f);
+    }
+    for (int i = 0; i < 3; i++) {
+        bo.euler_100[i] = (int16_t)(o.euler_deg[i] * 100.0f);
+        bo.lin_accel_100[i] = (int16_t)CLAMP(o.lin_accel[i] * 100.0f, INT16_MIN, INT16_MAX);
+    }
+    ble_update_orientation(&bo);
+
+    if (b->dashboard) {
+        printf("Orientation: roulis %d | tangage %d | cap %d deg | accel. lin. %d %d %d cm/s2\n\n",
+               (int)o.euler_deg[0], (int)o.euler_deg[1], (int)o.euler_deg[2],
+               (int)(o.lin_accel[0] * 100), (int)(o.lin_accel[1] * 100),
+               (int)(o.lin_accel[2] * 100));
+    }
+}
+
+ZBUS_LISTENER_DEFINE(bus_ahrs, ahrs_cb);
+ZBUS_CHAN_ADD_OBS(sensor_batch_chan, bus_ahrs, SENSOR_BUS_PRIO_ALGO);
+
+#endif /* CONFIG_ZSWATCH_AHRS */
@@ -0,0 +1,31 @@
+#include <stdio.h>
+#include "sensor_bus.h"
+#include "altimeter.h"
+#include "ble.h"
+
+#ifdef CONFIG_ZSWATCH_ALTIMETER
+
+/* Altimètre : flux pression complet (+ accéléro s'il tourne), notifié à chaque lot */
+static void altimeter_cb(const struct zbus_channel *chan)
+{
+    const SensorBatchMsg *b = zbus_chan_const_msg(chan);
+    AltimeterInfo alt;
+
+    altimeter_feed(b->imu, b->accel_on ? b->n_imu : 0, b->press, b->n_press);
+    altimeter_get(&alt);
+    if (ble_is_subscribed(BLE_CH_ALTITUDE)) {
+        ble_update_altitude((int32_t)(alt.altitude_m * 100.0f),
+                            (int16_t)CLAMP(alt.vspeed_ms * 100.0f, INT16_MIN, INT16_MAX),
+                            alt.floors_up, alt.floors_down);
+    }
+    if (b->dashboard) {
+        printf("Altimetre: %d cm | %d cm/s | etages +%u -%u | baro %d m\n\n",
+               (int)(alt.altitude_m * 100), (int)(alt.vspeed_ms * 100),
+               alt.floors_up, alt.floors_down, (int)alt.baro_alt_m);
+    }
+}
+
+ZBUS_LISTENER_DEFINE(bus_altimeter, altimeter_cb);
+ZBUS_CHAN_ADD_OBS(sensor_batch_chan, bus_altimeter, SENSOR_BUS_PRIO_ALGO);
+
+#endif /* CONFIG_ZSWATCH_ALTIMETER */
@@ -0,0 +1,99 @@
+#include "sensor_bus.h"
+#include "ble.h"
+
+/*
+ * BLE : caractéristiques ESS et trame "sensor frame" alimentées par le bus.
+ * Subscriber dans son propre thread : une notification lente ne retarde
+ * plus l'acquisition. Un capteur actif a toujours au moins un abonné
+ * (hors CONFIG_ZSWATCH_POWER_SAVE) : un message valide part tel quel.
+ */
+#define BLE_QUEUE_DEPTH   6      // deux acquisitions complètes d'avance
+#define BLE_PERIOD_MS     1000   // au plus une mise à jour par canal et par seconde
+#define BLE_STACK_SIZE    1024
+#define READ_TIMEOUT      K_MSEC(50)    // canal verrouillé pendant les listeners (console)
+
+ZBUS_SUBSCRIBER_DEFINE(bus_ble, BLE_QUEUE_DEPTH);
+ZBUS_CHAN_ADD_OBS(sensor_env_chan, bus_ble, SENSOR_BUS_PRIO_BLE);
+ZBUS_CHAN_ADD_OBS(sensor_motion_chan, bus_ble, SENSOR_BUS_PRIO_BLE);
+ZBUS_CHAN_ADD_OBS(sensor_mag_chan, bus_ble, SENSOR_BUS_PRIO_BLE);
+
+enum { CH_ENV, CH_MOTION, CH_MAG, CH_COUNT };
+
+static bool due(int ch)
+{
+    static int64_t next[CH_COUNT];
+    int64_t now = k_uptime_get();
+
+    if (now < next[ch]) {
+        return false;
+    }
+    next[ch] = now + BLE_PERIOD_MS;
+    return true;
+}
+
+/* Toutes les voies en une seule notification, si les trois messages sont de la même acquisition */
+static void send_frame(const SensorMagMsg *g)
+{
+    SensorEnvMsg e;
+    SensorMotionMsg m;
+
+    if (zbus_chan_read(&sensor_env_chan, &e, READ_TIMEOUT) != 0 ||
+        zbus_chan_read(&sensor_motion_chan, &m, READ_TIMEOUT) != 0 ||
+        e.hdr.seq != g->hdr.seq || m.hdr.seq != g->hdr.seq) {
+        return;  // acquisition suivante déjà publiée : la trame partira avec elle
+    }
+    BleSensorFrame frame = {
+        .temp_100 = e.temp_100,
+        .humi_100 = e.humi_100,
+        .pressure = e.pressure_pa,
+        .accel_100 = { m.accel_100[0], m.accel_100[1], m.accel_100[2] },
+        .mag_100 = { g->mag_100[0], g->mag_100[1], g->mag_100[2] },
+    };
+    ble_update_frame(&frame);
+}
+
+static void ble_sink_thread(void *p1, void *p2, void *p3)
+{
+    const struct zbus_channel *chan;
+
+    while (zbus_sub_wait(&bus_ble, &chan, K_FOREVER) == 0) {
+        if (chan == &sensor_env_chan) {
+            SensorEnvMsg e;
+
+            if (zbus_chan_read(chan, &e, READ_TIMEOUT) != 0 || !due(CH_ENV)) {
+                continue;
+            }
+            // Température HTS221 (°C * 100), humidité (% * 100), pression (Pa)
+            if (e.hts_valid) {
+                ble_update_temperature(e.temp_100);
+                ble_update_humidity(e.humi_100);
+            }
+            if (e.press_valid) {
+                ble_update_pressure(e.pressure_pa);
+            }
+        } else if (chan == &sensor_motion_chan) {
+            SensorMotionMsg m;
+
+            // Accélération (m/s² * 100)
+            if (zbus_chan_read(chan, &m, READ_TIMEOUT) == 0 && due(CH_MOTION) && m.valid) {
+                ble_update_acceleration(m.accel_100[0], m.accel_100[1], m.accel_100[2]);
+            }
+        } else if (chan == &sensor_mag_chan) {
+            SensorMagMsg g;
+
+            // Magnétomètre (gauss * 100), dernier canal de l'acquisition : trame complète
+            if (zbus_chan_read(chan, &g, READ_TIMEOUT) != 0 || !due(CH_MAG)) {
+                continue;
+            }
+            if (g.valid) {
+                ble_update_magnetometer(g.mag_100[0], g.mag_100[1], g.mag_100[2]);
+            }
+            if (ble_is_subscribed(BLE_CH_FRAME)) {
+                send_frame(&g);
+            }
+        }
+    }
+}
+
+K_THREAD_DEFINE(bus_ble_tid, BLE_STACK_SIZE, ble_sink_thread, NULL, NULL, NULL,
+                SENSOR_BUS_THREAD_PRIO, 0, 0);
@@ -0,0 +1,74 @@
+#include <stdio.h>
+#include <string.h>
+#include "sensor_bus.h"
+#include "mag_cal.h"
+
+#ifdef CONFIG_ZSWATCH_MAG_CAL
+
+/*
+ * Boussole : calibration en ligne sur chaque lot LIS2MDL, avant la fusion
+ * (SENSOR_BUS_PRIO_CALIB). Le cap affiché utilise le dernier échantillon
+ * brut des lots et l'accélération de la dernière acquisition, gardée au
+ * passage sur le bus (publiée avant le lot du dashboard).
+ */
+static int16_t accel_100[3];
+static bool accel_valid;
+static bool mag_valid;
+static MagSample last_mag;
+static bool has_mag;
+
+static void compass_acq_cb(const struct zbus_channel *chan)
+{
+    if (chan == &sensor_motion_chan) {
+        const SensorMotionMsg *m = zbus_chan_const_msg(chan);
+
+        accel_valid = m->valid;
+        memcpy(accel_100, m->accel_100, sizeof(accel_100));
+    } else {
+        mag_valid = ((const SensorMagMsg *)zbus_chan_const_msg(chan))->valid;
+    }
+}
+
+static void compass_batch_cb(const struct zbus_channel *chan)
+{
+    const SensorBatchMsg *b = zbus_chan_const_msg(chan);
+
+    mag_cal_feed(b->mag, b->n_mag);
+    if (b->n_mag > 0) {
+        last_mag = b->mag[b->n_mag - 1];
+        has_mag = true;
+    }
+    if (!b->dashboard) {
+        return;
+    }
+
+    MagCalInfo cal;
+    mag_cal_get_info(&cal);
+    if (!mag_valid) {
+        return;  // LIS2MDL en veille
+    }
+    if (has_mag && accel_valid && cal.valid) {
+        const float a[3] = { accel_100[0], accel_100[1], accel_100[2] };
+        float m_raw[3], m_cal[3], m_imu[3];
+
+        mag_gauss(last_mag.magn, m_raw);
+        mag_cal_apply(m_raw, m_cal);
+        mag_to_imu_axes(m_cal, m_imu);
+        printf("Boussole: cap %d deg | champ %d mG | fer dur %d %d %d mG | residu %d.%d %%\n",
+               (int)mag_cal_heading(a, m_imu), (int)(cal.cal.radius * 1000),
+               (int)(cal.cal.offset[0] * 1000), (int)(cal.cal.offset[1] * 1000),
+               (int)(cal.cal.offset[2] * 1000), (int)(cal.cal.rms * 100),
+               (int)(cal.cal.rms * 1000) % 10);
+    } else {
+        printf("Boussole: calibration en cours (%u points, %d/8 octants)\n",
+               cal.points, __builtin_popcount(cal.coverage));
+    }
+}
+
+ZBUS_LISTENER_DEFINE(bus_compass_acq, compass_acq_cb);
+ZBUS_LISTENER_DEFINE(bus_compass, compass_batch_cb);
+ZBUS_CHAN_ADD_OBS(sensor_motion_chan, bus_compass_acq, SENSOR_BUS_PRIO_CONSOLE);
+ZBUS_CHAN_ADD_OBS(sensor_mag_chan, bus_compass_acq, SENSOR_BUS_PRIO_CONSOLE);
+ZBUS_CHAN_ADD_OBS(sensor_batch_chan, bus_compass, SENSOR_BUS_PRIO_CALIB);
+
+#endif /* CONFIG_ZSWATCH_MAG_CAL */
@@ -0,0 +1,54 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "sensor_bus.h"
+#include "sensor_fixed.h"
+
+/*
+ * Console : lignes capteurs du dashboard. Listener, donc exécuté dans le
+ * thread qui publie : l'affichage reste dans l'ordre env, motion, mag,
+ * avant les lignes que main ajoute ensuite. Le canal reste verrouillé
+ * pendant l'affichage ; les subscribers attendent avec un délai de lecture.
+ */
+static void console_cb(const struct zbus_channel *chan)
+{
+    if (chan == &sensor_env_chan) {
+        const SensorEnvMsg *e = zbus_chan_const_msg(chan);
+
+        if (e->hts_valid) {
+            printf("HTS221 : Temp: " CENTI_FMT " C | Hum: " CENTI_FMT "%%\n",
+                   CENTI_ARG(e->temp_100), CENTI_ARG(e->humi_100));
+        } else {
+            printf("HTS221 : en veille\n");
+        }
+        if (e->press_valid) {
+            printf("LPS22HH: Press: %u.%03u kPa | Temp: " CENTI_FMT " C\n\n",
+                   e->pressure_pa / 1000, e->pressure_pa % 1000, CENTI_ARG(e->temp_lps_100));
+        } else {
+            printf("LPS22HH: en veille\n\n");
+        }
+    } else if (chan == &sensor_motion_chan) {
+        const SensorMotionMsg *m = zbus_chan_const_msg(chan);
+
+        if (m->valid) {
+            printf("LSM6DSO: Accel X: " CENTI_FMT " Y: " CENTI_FMT " Z: " CENTI_FMT "%s\n",
+                   CENTI_ARG(m->accel_100[0]), CENTI_ARG(m->accel_100[1]),
+                   CENTI_ARG(m->accel_100[2]), m->gyro_valid ? "" : " (gyro en veille)");
+        } else {
+            printf("LSM6DSO: en veille\n");
+        }
+    } else if (chan == &sensor_mag_chan) {
+        const SensorMagMsg *g = zbus_chan_const_msg(chan);
+
+        if (g->valid) {
+            printf("LIS2MDL: Magn  X: " CENTI_FMT " Y: " CENTI_FMT " Z: " CENTI_FMT "\n",
+                   CENTI_ARG(g->mag_100[0]), CENTI_ARG(g->mag_100[1]), CENTI_ARG(g->mag_100[2]));
+        } else {
+            printf("LIS2MDL: en veille\n");
+        }
+    }
+}
+
+ZBUS_LISTENER_DEFINE(bus_console, console_cb);
+ZBUS_CHAN_ADD_OBS(sensor_env_chan, bus_console, SENSOR_BUS_PRIO_CONSOLE);
+ZBUS_CHAN_ADD_OBS(sensor_motion_chan, bus_console, SENSOR_BUS_PRIO_CONSOLE);
+ZBUS_CHAN_ADD_OBS(sensor_mag_chan, bus_console, SENSOR_BUS_PRIO_CONSOLE);
@@ -0,0 +1,39 @@
+#include <stdio.h>
+#include "sensor_bus.h"
+#include "forecast.h"
+#include "ble.h"
+
+#ifdef CONFIG_ZSWATCH_FORECAST
+
+/* Prévision météo : une notification par tranche de 5 min close */
+static void forecast_cb(const struct zbus_channel *chan)
+{
+    const SensorBatchMsg *b = zbus_chan_const_msg(chan);
+    ForecastInfo fc;
+
+    if (forecast_feed(b->press, b->n_press)) {
+        forecast_get(&fc);
+        ble_update_forecast(fc.sea_level_pa,
+                            (int16_t)CLAMP(fc.delta_3h_pa, INT16_MIN, INT16_MAX),
+                            (int16_t)CLAMP(fc.delta_24h_pa, INT16_MIN, INT16_MAX),
+                            fc.trend, fc.code, fc.hours_24h_10);
+    }
+    if (!b->dashboard) {
+        return;
+    }
+    forecast_get(&fc);
+    if (fc.valid) {
+        printf("Meteo: %s | %u.%02u hPa mer | %s %d Pa/3 h | %d Pa sur %u.%u h\n\n",
+               forecast_text(fc.code), fc.sea_level_pa / 100, fc.sea_level_pa % 100,
+               forecast_trend_name(fc.trend), fc.delta_3h_pa, fc.delta_24h_pa,
+               fc.hours_24h_10 / 10, fc.hours_24h_10 % 10);
+    } else {
+        printf("Meteo: historique en cours (%u/%d tranches de %d min)\n\n",
+               fc.depth_bins, FORECAST_MIN_BINS, FORECAST_BIN_S / 60);
+    }
+}
+
+ZBUS_LISTENER_DEFINE(bus_forecast, forecast_cb);
+ZBUS_CHAN_ADD_OBS(sensor_batch_chan, bus_forecast, SENSOR_BUS_PRIO_ALGO);
+
+#endif /* CONFIG_ZSWATCH_FORECAST */
@@ -0,0 +1,67 @@
+#include "sensor_bus.h"
+#include "sensor_log.h"
+
+#ifdef CONFIG_ZSWATCH_SENSOR_LOG
+
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(bus_log, LOG_LEVEL_INF);
+
+/*
+ * Journal local : un enregistrement toutes les
+ * CONFIG_ZSWATCH_SENSOR_LOG_PERIOD_S, conservé hors connexion et après
+ * coupure. Thread propre : l'écriture flash (effacement de secteur
+ * compris) ne bloque plus l'acquisition.
+ */
+#define LOG_QUEUE_DEPTH   2
+#define LOG_STACK_SIZE    2048
+#define READ_TIMEOUT      K_MSEC(50)    // canal verrouillé pendant les listeners (console)
+
+// Le magnétomètre est publié en dernier : acquisition complète
+ZBUS_SUBSCRIBER_DEFINE(bus_log, LOG_QUEUE_DEPTH);
+ZBUS_CHAN_ADD_OBS(sensor_mag_chan, bus_log, SENSOR_BUS_PRIO_LOG);
+
+static void log_sink_thread(void *p1, void *p2, void *p3)
+{
+    const struct zbus_channel *chan;
+    int64_t next_log = k_uptime_get();
+
+    while (zbus_sub_wait(&bus_log, &chan, K_FOREVER) == 0) {
+        SensorEnvMsg e;
+        SensorMotionMsg m;
+        SensorMagMsg g;
+
+        if (!sensor_log_ready() || k_uptime_get() < next_log) {
+            continue;
+        }
+        if (zbus_chan_read(&sensor_mag_chan, &g, READ_TIMEOUT) != 0 ||
+            zbus_chan_read(&sensor_env_chan, &e, READ_TIMEOUT) != 0 ||
+            zbus_chan_read(&sensor_motion_chan, &m, READ_TIMEOUT) != 0) {
+            continue;
+        }
+        // Après une attente plus longue que la période (journal pas prêt,
+        // flash lente) : pas de rafale d'enregistrements pour rattraper
+        next_log = MAX(next_log + CONFIG_ZSWATCH_SENSOR_LOG_PERIOD_S * 1000, k_uptime_get());
+
+        SensorLogRecord rec = {
+            .time_s = sensor_log_time_s(),
+            .flags = (e.hts_valid ? SENSOR_LOG_HAS_ENV : 0) |
+                     (e.press_valid ? SENSOR_LOG_HAS_PRESS : 0) |
+                     (m.valid ? SENSOR_LOG_HAS_ACCEL : 0) |
+                     (g.valid ? SENSOR_LOG_HAS_MAG : 0),
+            .temp_100 = e.temp_100,
+            .humi_100 = e.humi_100,
+            .pressure = e.pressure_pa,
+            .accel_100 = { m.accel_100[0], m.accel_100[1], m.accel_100[2] },
+            .mag_100 = { g.mag_100[0], g.mag_100[1], g.mag_100[2] },
+        };
+        if (sensor_log_append(&rec) != 0) {
+            LOG_ERR("Erreur d'écriture du journal");
+        }
+    }
+}
+
+K_THREAD_DEFINE(bus_log_tid, LOG_STACK_SIZE, log_sink_thread, NULL, NULL, NULL,
+                SENSOR_BUS_THREAD_PRIO, 0, 0);
+
+#endif /* CONFIG_ZSWATCH_SENSOR_LOG */
@@ -0,0 +1,47 @@
+#include <stdio.h>
+#include "sensor_bus.h"
+#include "pedometer.h"
+#include "ble.h"
+
+#ifdef CONFIG_ZSWATCH_PEDOMETER
+
+/*
+ * Podomètre : échantillons de la FIFO (podomètre logiciel) ou compteur du
+ * LSM6DSO, à chaque lot. Notification seulement quand le compteur ou la
+ * cadence change, au rythme du dashboard.
+ */
+static uint32_t prev_steps = UINT32_MAX;
+static uint16_t prev_cadence;
+
+static void pedometer_cb(const struct zbus_channel *chan)
+{
+    const SensorBatchMsg *b = zbus_chan_const_msg(chan);
+
+    if (b->hw_steps_valid) {
+        pedometer_feed_steps(b->hw_steps, (uint32_t)(b->hdr.timestamp_us / 1000));
+    } else {
+        pedometer_feed(b->imu, b->n_imu);
+    }
+    if (!b->dashboard) {
+        return;
+    }
+
+    PedometerInfo ped;
+    pedometer_get(&ped);
+    printf("Podometre: %u pas | %u pas/min | %u.%02u km%s\n\n", ped.steps, ped.cadence_spm,
+           ped.distance_cm / 100000, ped.distance_cm / 1000 % 100,
+           ped.walking ? " | en marche" : "");
+
+    if (!ble_is_subscribed(BLE_CH_STEPS)) {
+        prev_steps = UINT32_MAX;  // renvoi complet au prochain abonnement
+    } else if (ped.steps != prev_steps || ped.cadence_spm != prev_cadence) {
+        ble_update_steps(ped.steps, ped.cadence_spm, ped.distance_cm / 10);
+        prev_steps = ped.steps;
+        prev_cadence = ped.cadence_spm;
+    }
+}
+
+ZBUS_LISTENER_DEFINE(bus_pedometer, pedometer_cb);
+ZBUS_CHAN_ADD_OBS(sensor_batch_chan, bus_pedometer, SENSOR_BUS_PRIO_ALGO);
+
+#endif /* CONFIG_ZSWATCH_PEDOMETER */
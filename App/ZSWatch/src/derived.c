@@ -0,0 +1,209 @@
+#include "derived.h"
+
+#ifdef CONFIG_ZSWATCH_DERIVED
+
+#include <zephyr/kernel.h>
+#include <string.h>
+#include <math.h>
+#include "sensor_bus.h"
+
+#define RAD_TO_CDEG   5729.578f   // degrés * 100
+
+typedef struct {
+    int32_t v[DERIVED_IN_COUNT][DERIVED_IN_MAX_LEN];
+} DerivedInputs;
+
+typedef struct {
+    const char *name;
+    uint32_t inputs;                          // BIT(DerivedInput)
+    int32_t (*compute)(const DerivedInputs *in);
+} DerivedDesc;
+
+/* ==================== Calculs ==================== */
+/* Magnus (Sonntag 1990), -45 .. 60 °C */
+static int32_t dew_point(const DerivedInputs *in)
+{
+    float t = in->v[DERIVED_IN_TEMP][0] / 100.0f;
+    float rh = MAX(in->v[DERIVED_IN_HUMI][0], 1) / 100.0f;
+    float g = logf(rh / 100.0f) + 17.62f * t / (243.12f + t);
+
+    return (int32_t)(243.12f * g / (17.62f - g) * 100.0f);
+}
+
+static int32_t abs_humidity(const DerivedInputs *in)
+{
+    float t = in->v[DERIVED_IN_TEMP][0] / 100.0f;
+    float rh = in->v[DERIVED_IN_HUMI][0] / 100.0f;
+    // Pression de vapeur (hPa) : saturante * RH (%), loi des gaz parfaits pour l'eau
+    float e = 6.112f * expf(17.67f * t / (t + 243.5f)) * rh;
+
+    return (int32_t)(e * 2.1674f / (273.15f + t) * 100.0f);
+}
+
+/* Indice de chaleur NOAA : formule simple, Rothfusz au-delà de 80 °F */
+static int32_t heat_index(const DerivedInputs *in)
+{
+    float t = in->v[DERIVED_IN_TEMP][0] / 100.0f * 1.8f + 32.0f;
+    float rh = in->v[DERIVED_IN_HUMI][0] / 100.0f;
+    float hi = 0.5f * (t + 61.0f + (t - 68.0f) * 1.2f + rh * 0.094f);
+
+    if ((hi + t) / 2.0f >= 80.0f) {
+        hi = -42.379f + 2.04901523f * t + 10.14333127f * rh - 0.22475541f * t * rh -
+             0.00683783f * t * t - 0.05481717f * rh * rh + 0.00122874f * t * t * rh +
+             0.00085282f * t * rh * rh - 0.00000199f * t * t * rh * rh;
+        if (rh < 13.0f && t <= 112.0f) {
+            hi -= (13.0f - rh) / 4.0f * sqrtf((17.0f - fabsf(t - 95.0f)) / 17.0f);
+        } else if (rh > 85.0f && t <= 87.0f) {
+            hi += (rh - 85.0f) / 10.0f * (87.0f - t) / 5.0f;
+        }
+    } else {
+        hi = (hi + t) / 2.0f;
+    }
+    return (int32_t)((hi - 32.0f) / 1.8f * 100.0f);
+}
+
+static int32_t accel_norm(const DerivedInputs *in)
+{
+    const int32_t *a = in->v[DERIVED_IN_ACCEL];
+    float n = sqrtf((float)a[0] * a[0] + (float)a[1] * a[1] + (float)a[2] * a[2]);
+
+    return (int32_t)(n * 10.0f / 9.80665f);  // cm/s² -> mg
+}
+
+/* Inclinaison statique (gravité seule), axes du LSM6DSO */
+static int32_t pitch(const DerivedInputs *in)
+{
+    const int32_t *a = in->v[DERIVED_IN_ACCEL];
+    float yz = sqrtf((float)a[1] * a[1] + (float)a[2] * a[2]);
+
+    return (int32_t)(atan2f(-a[0], yz) * RAD_TO_CDEG);
+}
+
+static int32_t roll(const DerivedInputs *in)
+{
+    const int32_t *a = in->v[DERIVED_IN_ACCEL];
+
+    return (int32_t)(atan2f(a[1], a[2]) * RAD_TO_CDEG);
+}
+
+#define IN(x) BIT(DERIVED_IN_##x)
+
+static const DerivedDesc metrics[DERIVED_COUNT] = {
+    [DERIVED_DEW_POINT]    = { "point de rosee",   IN(TEMP) | IN(HUMI), dew_point },
+    [DERIVED_ABS_HUMIDITY] = { "humidite absolue", IN(TEMP) | IN(HUMI), abs_humidity },
+    [DERIVED_HEAT_INDEX]   = { "indice de chaleur", IN(TEMP) | IN(HUMI), heat_index },
+    [DERIVED_ACCEL_NORM]   = { "|a|",              IN(ACCEL),           accel_norm },
+    [DERIVED_PITCH]        = { "tangage",          IN(ACCEL),           pitch },
+    [DERIVED_ROLL]         = { "roulis",           IN(ACCEL),           roll },
+};
+
+/* ==================== Registre ==================== */
+static struct {
+    DerivedInputs in;
+    uint32_t version[DERIVED_IN_COUNT];   // 0 : jamais publiée
+    // Cache : somme des versions des entrées au dernier calcul
+    uint32_t stamp[DERIVED_COUNT];
+    int32_t value[DERIVED_COUNT];
+    DerivedStats stats[DERIVED_COUNT];
+} reg;
+
+static struct k_spinlock lock;
+
+void derived_publish(DerivedInput in, const int32_t *values, int n)
+{
+    n = MIN(n, DERIVED_IN_MAX_LEN);
+
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    if (reg.version[in] == 0 || memcmp(reg.in.v[in], values, n * sizeof(int32_t)) != 0) {
+        memcpy(reg.in.v[in], values, n * sizeof(int32_t));
+        reg.version[in]++;
+    }
+    k_spin_unlock(&lock, key);
+}
+
+int derived_get(DerivedMetric m, int32_t *value)
+{
+    const DerivedDesc *d = &metrics[m];
+    DerivedInputs snap;
+    uint32_t stamp = 0;
+
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    reg.stats[m].reads++;
+    for (int i = 0; i < DERIVED_IN_COUNT; i++) {
+        if (!(d->inputs & BIT(i))) {
+            continue;
+        }
+        if (reg.version[i] == 0) {
+            k_spin_unlock(&lock, key);
+            return -1;
+        }
+        stamp += reg.version[i];
+    }
+    // Les versions ne font que croître : même somme = mêmes entrées
+    if (stamp == reg.stamp[m]) {
+        *value = reg.value[m];
+        k_spin_unlock(&lock, key);
+        return 0;
+    }
+    snap = reg.in;
+    k_spin_unlock(&lock, key);
+
+    // Calcul hors verrou (lecteurs possibles dans d'autres threads)
+    int32_t v = d->compute(&snap);
+
+    key = k_spin_lock(&lock);
+    reg.value[m] = v;
+    reg.stamp[m] = stamp;
+    reg.stats[m].evals++;
+    k_spin_unlock(&lock, key);
+
+    *value = v;
+    return 0;
+}
+
+const char *derived_name(DerivedMetric m)
+{
+    return m < DERIVED_COUNT ? metrics[m].name : "?";
+}
+
+void derived_get_stats(DerivedMetric m, DerivedStats *stats)
+{
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    *stats = reg.stats[m];
+    k_spin_unlock(&lock, key);
+}
+
+/* ==================== Entrées depuis le bus capteurs ==================== */
+/* Listener : simple copie des entrées, le calcul attend un lecteur */
+static void bus_cb(const struct zbus_channel *chan)
+{
+    if (chan == &sensor_env_chan) {
+        const SensorEnvMsg *e = zbus_chan_const_msg(chan);
+
+        if (e->hts_valid) {
+            derived_publish(DERIVED_IN_TEMP, &(int32_t){ e->temp_100 }, 1);
+            derived_publish(DERIVED_IN_HUMI, &(int32_t){ e->humi_100 }, 1);
+        }
+    } else if (chan == &sensor_motion_chan) {
+        const SensorMotionMsg *m = zbus_chan_const_msg(chan);
+
+        if (m->valid) {
+            const int32_t a[3] = { m->accel_100[0], m->accel_100[1], m->accel_100[2] };
+
+            derived_publish(DERIVED_IN_ACCEL, a, 3);
+        }
+    }
+}
+
+ZBUS_LISTENER_DEFINE(bus_derived, bus_cb);
+ZBUS_CHAN_ADD_OBS(sensor_env_chan, bus_derived, SENSOR_BUS_PRIO_DERIVED);
+ZBUS_CHAN_ADD_OBS(sensor_motion_chan, bus_derived, SENSOR_BUS_PRIO_DERIVED);
+
+void derived_reset(void)
+{
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    memset(&reg, 0, sizeof(reg));
+    k_spin_unlock(&lock, key);
+}
+
+#endif /* CONFIG_ZSWATCH_DERIVED */
@@ -0,0 +1,62 @@
+#ifndef DERIVED_H
+#define DERIVED_H
+
+#include <stdint.h>
+
+/*
+ * Grandeurs dérivées (point de rosée, humidité absolue, indice de chaleur,
+ * |a|, tangage / roulis), déclarées dans une table : entrées utilisées et
+ * fonction de calcul.
+ *
+ * Les entrées arrivent du bus capteurs (sensor_bus.h) ou de
+ * derived_publish() : copie et compteur de version, sans rien calculer.
+ * Une grandeur n'est évaluée qu'à la lecture (derived_get) et seulement
+ * si une de ses entrées a changé depuis le dernier calcul ; sinon la
+ * valeur en cache est rendue.
+ * Une grandeur que personne ne lit ne coûte rien.
+ */
+
+typedef enum {
+    DERIVED_IN_TEMP,     // HTS221, °C * 100
+    DERIVED_IN_HUMI,     // %HR * 100
+    DERIVED_IN_ACCEL,    // 3 axes, m/s² * 100
+    DERIVED_IN_COUNT,
+} DerivedInput;
+
+#define DERIVED_IN_MAX_LEN 3
+
+typedef enum {
+    DERIVED_DEW_POINT,      // °C * 100
+    DERIVED_ABS_HUMIDITY,   // g/m³ * 100
+    DERIVED_HEAT_INDEX,     // °C * 100 (température ressentie)
+    DERIVED_ACCEL_NORM,     // mg
+    DERIVED_PITCH,          // degrés * 100
+    DERIVED_ROLL,           // degrés * 100
+    DERIVED_COUNT,
+} DerivedMetric;
+
+typedef struct {
+    uint32_t reads;      // appels à derived_get
+    uint32_t evals;      // calculs effectifs (entrées modifiées)
+} DerivedStats;
+
+/**
+ * @brief Publie une entrée (n valeurs). La version n'avance que si une
+ *        valeur change : les grandeurs dépendantes restent en cache sinon.
+ */
+void derived_publish(DerivedInput in, const int32_t *values, int n);
+
+/**
+ * @brief Valeur d'une grandeur, calculée à la demande.
+ * @return 0, -1 si une de ses entrées n'a jamais été publiée
+ */
+int derived_get(DerivedMetric m, int32_t *value);
+
+const char *derived_name(DerivedMetric m);
+
+void derived_get_stats(DerivedMetric m, DerivedStats *stats);
+
+/* Oublie entrées, cache et compteurs */
+void derived_reset(void);
+
+#endif
@@ -1,5 +1,23 @@
 #include "env_sensor.h"
 #include <zephyr/device.h>
+#include "timebase.h"
+
+#ifdef CONFIG_LPS22HH_TRIGGER
+/* Exécuté dans le thread de trigger du driver LPS22HH (producteur unique) */
+static void env_press_ready(const struct device *dev, const struct sensor_trigger *trig)
+{
+    EnvSensor *s = CONTAINER_OF(trig, EnvSensor, press_trig);
+    EnvSample e;
+
+    if (sensor_sample_fetch(dev) < 0) {
+        return;
+    }
+    e.timestamp_us = timebase_now_us();
+    sensor_channel_get(dev, SENSOR_CHAN_PRESS, &e.pressure);
+    sensor_channel_get(dev, SENSOR_CHAN_AMBIENT_TEMP, &e.temp);
+    spsc_ring_put(&s->press_ring, &e);
+}
+#endif
 
 int env_init(EnvSensor *s) {
     // Récupération des instances depuis le Device Tree
@@ -11,23 +29,79 @@ int env_init(EnvSensor *s) {
     }
 
     // Configuration de la fréquence du LPS22HH à 100 Hz
-    struct sensor_value odr = { .val1 = 100, .val2 = 0 };
+    struct sensor_value odr = { .val1 = ENV_PRESS_ODR_HZ, .val2 = 0 };
     sensor_attr_set(s->lps22hh, SENSOR_CHAN_ALL, SENSOR_ATTR_SAMPLING_FREQUENCY, &odr);
+    s->hts_active = true;
+    s->press_active = true;
+
+#ifdef CONFIG_LPS22HH_TRIGGER
+    spsc_ring_init(&s->press_ring, s->press_buf, sizeof(EnvSample), ENV_RING_LEN);
+    s->press_trig.type = SENSOR_TRIG_DATA_READY;
+    s->press_trig.chan = SENSOR_CHAN_ALL;
+    if (sensor_trigger_set(s->lps22hh, &s->press_trig, env_press_ready) < 0) {
+        return -1;
+    }
+#endif
 
     return 0;
 }
 
 int env_update(EnvSensor *s) {
-    // Lecture des échantillons (Fetch)
-    if (sensor_sample_fetch(s->hts221) < 0 || sensor_sample_fetch(s->lps22hh) < 0) {
-        return -1;
+    // Lecture des échantillons (Fetch) puis extraction (Get), capteurs actifs seulement
+    if (s->hts_active) {
+        if (sensor_sample_fetch(s->hts221) < 0) {
+            return -1;
+        }
+        sensor_channel_get(s->hts221, SENSOR_CHAN_AMBIENT_TEMP, &s->temp_hts);
+        sensor_channel_get(s->hts221, SENSOR_CHAN_HUMIDITY, &s->humidity);
     }
+#ifndef CONFIG_LPS22HH_TRIGGER
+    // Avec trigger, le LPS22HH est lu par son handler (voir env_read_pressure)
+    if (s->press_active) {
+        if (sensor_sample_fetch(s->lps22hh) < 0) {
+            return -1;
+        }
+        sensor_channel_get(s->lps22hh, SENSOR_CHAN_PRESS, &s->pressure);
+        sensor_channel_get(s->lps22hh, SENSOR_CHAN_AMBIENT_TEMP, &s->temp_lps);
+        s->press_us = timebase_now_us();
+    }
+#endif
 
-    // Extraction des données (Get)
-    sensor_channel_get(s->hts221, SENSOR_CHAN_AMBIENT_TEMP, &s->temp_hts);
-    sensor_channel_get(s->hts221, SENSOR_CHAN_HUMIDITY, &s->humidity);
-    sensor_channel_get(s->lps22hh, SENSOR_CHAN_PRESS, &s->pressure);
-    sensor_channel_get(s->lps22hh, SENSOR_CHAN_AMBIENT_TEMP, &s->temp_lps);
+    return 0;
+}
+
+int env_set_active(EnvSensor *s, bool hts, bool press) {
+    if (press != s->press_active) {
+        // ODR 0 = power-down (mode one-shot) du LPS22HH
+        struct sensor_value odr = { .val1 = press ? ENV_PRESS_ODR_HZ : 0, .val2 = 0 };
 
+        if (sensor_attr_set(s->lps22hh, SENSOR_CHAN_ALL, SENSOR_ATTR_SAMPLING_FREQUENCY, &odr) < 0) {
+            return -1;
+        }
+#ifdef CONFIG_LPS22HH_TRIGGER
+        // Vide la mesure en attente pour que DRDY produise de nouveau un front
+        if (press) {
+            sensor_sample_fetch(s->lps22hh);
+        }
+#endif
+        s->press_active = press;
+    }
+    s->hts_active = hts;
     return 0;
-}
\ No newline at end of file
+}
+
+int env_read_pressure(EnvSensor *s, EnvSample *out, int max) {
+    int n = 0;
+
+#ifdef CONFIG_LPS22HH_TRIGGER
+    while (n < max && spsc_ring_get(&s->press_ring, &out[n])) {
+        n++;
+    }
+    if (n > 0) {
+        s->pressure = out[n - 1].pressure;
+        s->temp_lps = out[n - 1].temp;
+        s->press_us = out[n - 1].timestamp_us;
+    }
+#endif
+    return n;
+}
@@ -2,6 +2,18 @@
 #define ENV_SENSOR_H
 
 #include <zephyr/drivers/sensor.h>
+#include "spsc_ring.h"
+
+// Anneau d'échantillons LPS22HH (puissance de 2, ~2.5 s à 100 Hz)
+#define ENV_RING_LEN 256
+
+#define ENV_PRESS_ODR_HZ 100
+
+typedef struct {
+    int64_t timestamp_us;  // instant d'acquisition (k_uptime, µs)
+    struct sensor_value pressure;
+    struct sensor_value temp;
+} EnvSample;
 
 typedef struct {
     const struct device *hts221;
@@ -12,9 +24,39 @@ typedef struct {
     struct sensor_value humidity;
     struct sensor_value pressure;
     struct sensor_value temp_lps;
+    int64_t press_us;   // horodatage de pressure / temp_lps (0 : jamais lus)
+
+    bool hts_active;    // false : HTS221 plus lu
+    bool press_active;  // false : LPS22HH en power-down (ODR 0)
+
+#ifdef CONFIG_LPS22HH_TRIGGER
+    // Pression/température LPS22HH poussées par le handler data-ready
+    struct sensor_trigger press_trig;
+    struct spsc_ring press_ring;
+    EnvSample press_buf[ENV_RING_LEN];
+#endif
 } EnvSensor;
 
 int env_init(EnvSensor *s);
 int env_update(EnvSensor *s);
 
-#endif
\ No newline at end of file
+/**
+ * @brief Sélectionne les capteurs lus. Le LPS22HH passe en power-down ;
+ *        le HTS221 (ODR fixé par Kconfig) n'est simplement plus lu.
+ */
+int env_set_active(EnvSensor *s, bool hts, bool press);
+
+/* Accesseurs entiers (sans double) */
+int16_t env_temp_centi(const EnvSensor *s);      // HTS221, °C * 100
+uint16_t env_humidity_centi(const EnvSensor *s); // %HR * 100
+uint32_t env_pressure_pa(const EnvSensor *s);    // Pa
+int16_t env_temp_lps_centi(const EnvSensor *s);  // LPS22HH, °C * 100
+
+/**
+ * @brief Retire jusqu'à max échantillons LPS22HH de l'anneau (un seul consommateur).
+ *        pressure/temp_lps prennent la valeur du dernier retiré.
+ * @return nombre d'échantillons copiés (toujours 0 sans trigger LPS22HH)
+ */
+int env_read_pressure(EnvSensor *s, EnvSample *out, int max);
+
+#endif
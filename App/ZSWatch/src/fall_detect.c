@@ -0,0 +1,240 @@
+#include "fall_detect.h"
+
+#ifdef CONFIG_ZSWATCH_FALL_DETECT
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+LOG_MODULE_REGISTER(fall_detect, LOG_LEVEL_INF);
+
+#define MG_PER_LSB        (MOTION_ACCEL_UG_PER_LSB / 1000.0f)
+// Historique : instantané + la chute libre déjà écoulée à l'armement
+#define HIST_LEN          (FALL_SNAP_LEN * FALL_SNAP_DECIM + 32)
+
+typedef enum {
+    ST_IDLE,
+    ST_FREE_FALL,   // armé, impact attendu
+    ST_POST,        // impact vu, verdict à l'immobilité
+} FallState;
+
+static struct {
+    MotionSensor *imu;
+    FallHandler handler;
+    bool sw_arm;               // pas d'interruption : armement sur les échantillons
+    FallState state;
+    // Historique brut (avant la chute)
+    int16_t hist[HIST_LEN][3];
+    uint16_t hist_head;
+    uint16_t hist_fill;
+    uint32_t low_run;          // échantillons consécutifs sous FALL_FF_MG
+    int64_t low_start_us;
+    // Chute en cours
+    int64_t ff_start_us;
+    int32_t lp_mg;             // |a| lissée (4 échantillons) après l'impact
+    FallEvent event;
+    // Rafale en cours (latence)
+    int64_t batch_last_us;
+    uint32_t batch_cycles;
+    FallInfo info;
+} fall;
+
+static struct k_spinlock lock;
+
+/* Lecture FIFO rapprochée tant qu'un verdict est attendu */
+static void poll_handler(struct k_work *work)
+{
+    if (fall.state == ST_IDLE) {
+        return;
+    }
+    if (fall.imu) {
+        motion_fifo_kick(fall.imu);
+    }
+    k_work_schedule(k_work_delayable_from_work(work), K_MSEC(FALL_POLL_MS));
+}
+
+static K_WORK_DELAYABLE_DEFINE(poll_work, poll_handler);
+
+static void emit(FallPhase phase, int64_t t_us)
+{
+    FallEvent *e = &fall.event;
+
+    // Lecture FIFO (dernier échantillon de la rafale = instant de lecture) + traitement
+    e->phase = phase;
+    e->latency_us = (uint32_t)(fall.batch_last_us - t_us) +
+                    k_cyc_to_us_floor32(k_cycle_get_32() - fall.batch_cycles);
+
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    switch (phase) {
+    case FALL_PHASE_IMPACT:
+        fall.info.alerts++;
+        fall.info.last_latency_us = e->latency_us;
+        break;
+    case FALL_PHASE_CONFIRMED:
+        fall.info.confirmed++;
+        break;
+    case FALL_PHASE_RECOVERED:
+        fall.info.recovered++;
+        break;
+    }
+    fall.info.armed = (phase == FALL_PHASE_IMPACT);
+    k_spin_unlock(&lock, key);
+
+    if (fall.handler) {
+        fall.handler(e);
+    }
+    e->n_snap = 0;  // l'instantané ne part qu'avec l'alerte
+}
+
+/* Instantané des FALL_SNAP_LEN échantillons décimés précédant la chute libre */
+static void take_snapshot(void)
+{
+    FallEvent *e = &fall.event;
+    int avail = (int)fall.hist_fill - (int)MIN(fall.low_run, fall.hist_fill);
+    int n = avail > 0 ? MIN(FALL_SNAP_LEN, (avail - 1) / FALL_SNAP_DECIM + 1) : 0;
+    // Dernier échantillon avant la chute libre
+    int last = (int)fall.hist_head - 1 - (int)fall.low_run;
+
+    for (int i = 0; i < n; i++) {
+        int idx = last - (n - 1 - i) * FALL_SNAP_DECIM;
+
+        idx = ((idx % HIST_LEN) + HIST_LEN) % HIST_LEN;
+        for (int k = 0; k < 3; k++) {
+            e->snap[i][k] = (int16_t)(fall.hist[idx][k] * MG_PER_LSB);
+        }
+    }
+    e->n_snap = n;
+}
+
+static void arm(int64_t t_us)
+{
+    fall.ff_start_us = fall.low_run ? fall.low_start_us : t_us;
+    fall.state = ST_FREE_FALL;
+    memset(&fall.event, 0, sizeof(fall.event));
+    take_snapshot();
+
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    fall.info.armed = true;
+    k_spin_unlock(&lock, key);
+
+    k_work_reschedule(&poll_work, K_MSEC(FALL_POLL_MS));
+}
+
+static void disarm(bool false_alarm)
+{
+    fall.state = ST_IDLE;
+
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    fall.info.armed = false;
+    fall.info.false_alarms += false_alarm;
+    k_spin_unlock(&lock, key);
+}
+
+/* ==================== Machine d'états ==================== */
+static void step(const MotionSample *s, bool ff_irq)
+{
+    const float a0 = s->accel[0], a1 = s->accel[1], a2 = s->accel[2];
+    int32_t mg = (int32_t)(sqrtf(a0 * a0 + a1 * a1 + a2 * a2) * MG_PER_LSB);
+    int64_t t = s->timestamp_us;
+
+    memcpy(fall.hist[fall.hist_head], s->accel, sizeof(s->accel));
+    fall.hist_head = (fall.hist_head + 1) % HIST_LEN;
+    fall.hist_fill = MIN(fall.hist_fill + 1, HIST_LEN);
+    if (mg < FALL_FF_MG) {
+        if (fall.low_run++ == 0) {
+            fall.low_start_us = t;
+        }
+    } else {
+        fall.low_run = 0;
+    }
+
+    switch (fall.state) {
+    case ST_IDLE:
+        if ((ff_irq || fall.sw_arm) && fall.low_run >= FALL_FF_SAMPLES) {
+            arm(t);
+        }
+        break;
+
+    case ST_FREE_FALL:
+        if (mg >= FALL_IMPACT_MG) {
+            fall.event.peak_mg = MIN(mg, UINT16_MAX);
+            fall.event.free_fall_ms = (uint16_t)((t - fall.ff_start_us) / 1000);
+            fall.event.impact_us = t;
+            fall.lp_mg = mg;
+            fall.state = ST_POST;
+            emit(FALL_PHASE_IMPACT, t);
+        } else if (t - fall.ff_start_us > FALL_IMPACT_WINDOW_MS * 1000LL) {
+            disarm(true);  // saut, geste : pas d'impact
+        }
+        break;
+
+    case ST_POST: {
+        int64_t dt = t - fall.event.impact_us;
+
+        if (dt <= FALL_PEAK_MS * 1000LL && mg > fall.event.peak_mg) {
+            fall.event.peak_mg = MIN(mg, UINT16_MAX);
+        }
+        fall.lp_mg += (mg - fall.lp_mg) / 4;
+        if (dt < FALL_SETTLE_MS * 1000LL) {
+            break;
+        }
+        if (abs(fall.lp_mg - 1000) > FALL_STILL_DEV_MG) {
+            emit(FALL_PHASE_RECOVERED, t);
+            disarm(false);
+        } else if (dt >= (FALL_SETTLE_MS + FALL_STILL_MS) * 1000LL) {
+            LOG_WRN("Chute : pic %u mg apres %u ms de chute libre",
+                    fall.event.peak_mg, fall.event.free_fall_ms);
+            emit(FALL_PHASE_CONFIRMED, t);
+            disarm(false);
+        }
+        break;
+    }
+    }
+}
+
+void fall_detect_feed(const MotionSample *samples, int n, uint32_t events)
+{
+    bool ff_irq = events & MOTION_EVT_FREE_FALL;
+
+    fall.batch_cycles = k_cycle_get_32();
+    if (n > 0) {
+        fall.batch_last_us = samples[n - 1].timestamp_us;
+    }
+    for (int i = 0; i < n; i++) {
+        step(&samples[i], ff_irq);
+        if (fall.state != ST_IDLE) {
+            ff_irq = false;
+        }
+    }
+    // Interruption sans échantillon sous le seuil dans la rafale : armement quand même
+    if (ff_irq && fall.state == ST_IDLE) {
+        arm(fall.batch_last_us);
+    }
+}
+
+void fall_detect_get(FallInfo *info)
+{
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    *info = fall.info;
+    k_spin_unlock(&lock, key);
+}
+
+void fall_detect_init(MotionSensor *imu, FallHandler handler)
+{
+    k_work_cancel_delayable(&poll_work);
+
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    memset(&fall, 0, sizeof(fall));
+    k_spin_unlock(&lock, key);
+
+    fall.handler = handler;
+    if (imu) {
+        fall.imu = imu;
+        fall.sw_arm = !imu->free_fall_irq;
+        motion_set_listener(imu, fall_detect_feed);
+    }
+}
+
+#endif /* CONFIG_ZSWATCH_FALL_DETECT */
@@ -0,0 +1,73 @@
+#ifndef FALL_DETECT_H
+#define FALL_DETECT_H
+
+#include <stdbool.h>
+#include "motion_sensor.h"
+
+/*
+ * Détection de chute, hors de la boucle principale : la machine d'états
+ * tourne dans le work de la FIFO (MotionListener), échantillon par
+ * échantillon à 208 Hz.
+ *
+ *   repos --(chute libre INT1)--> chute libre --(|a| > FALL_IMPACT_MG)-->
+ *   impact : alerte immédiate --(FALL_SETTLE_MS puis FALL_STILL_MS immobile)-->
+ *   chute confirmée ; mouvement pendant l'immobilité : relevé.
+ *
+ * Armée par l'interruption chute libre du LSM6DSO (ou, sans elle, par le
+ * même critère sur les échantillons) ; tant qu'elle est armée, la FIFO est
+ * vidée toutes les FALL_POLL_MS au lieu d'attendre son seuil.
+ */
+#define FALL_FF_MG            312    // même seuil que le LSM6DSO
+#define FALL_FF_SAMPLES       6      // ~29 ms
+#define FALL_IMPACT_MG        3000
+#define FALL_IMPACT_WINDOW_MS 1000   // impact attendu après le début de la chute
+#define FALL_PEAK_MS          100    // pic d'impact cherché après le franchissement
+#define FALL_SETTLE_MS        500    // rebonds après l'impact
+#define FALL_STILL_MS         2000
+#define FALL_STILL_DEV_MG     200    // écart de |a| à 1 g toléré au sol
+#define FALL_POLL_MS          10
+
+// Instantané avant la chute : FALL_SNAP_LEN échantillons à 208 / FALL_SNAP_DECIM Hz
+#define FALL_SNAP_LEN         24
+#define FALL_SNAP_DECIM       4
+
+typedef enum {
+    FALL_PHASE_IMPACT = 1,   // chute probable (alerte au plus tôt)
+    FALL_PHASE_CONFIRMED,    // immobile après l'impact
+    FALL_PHASE_RECOVERED,    // mouvement après l'impact : fausse alerte ou relevé
+} FallPhase;
+
+typedef struct {
+    FallPhase phase;
+    uint16_t peak_mg;        // pic de |a| à l'impact
+    uint16_t free_fall_ms;   // du début de la chute libre à l'impact
+    int64_t impact_us;       // horodatage de l'échantillon d'impact
+    uint32_t latency_us;     // impact -> alerte (lecture FIFO + traitement)
+    uint8_t n_snap;
+    int16_t snap[FALL_SNAP_LEN][3];  // mg, du plus ancien au plus récent
+} FallEvent;
+
+// Appelé dans le work de la FIFO : doit rester court (ex. indication BLE)
+typedef void (*FallHandler)(const FallEvent *event);
+
+typedef struct {
+    bool armed;              // chute libre vue, verdict en attente
+    uint32_t alerts;         // impacts signalés
+    uint32_t confirmed;
+    uint32_t recovered;
+    uint32_t false_alarms;   // chute libre sans impact (saut, geste)
+    uint32_t last_latency_us;
+} FallInfo;
+
+/**
+ * @brief Branche le détecteur sur le work de la FIFO (imu NULL : pas de
+ *        branchement, alimenté par fall_detect_feed, ex. rejeu de traces).
+ */
+void fall_detect_init(MotionSensor *imu, FallHandler handler);
+
+/* Traitement d'une rafale (signature MotionListener) */
+void fall_detect_feed(const MotionSample *samples, int n, uint32_t events);
+
+void fall_detect_get(FallInfo *info);
+
+#endif
@@ -0,0 +1,281 @@
+#include "forecast.h"
+
+#ifdef CONFIG_ZSWATCH_FORECAST
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <string.h>
+#include <math.h>
+
+LOG_MODULE_REGISTER(forecast, LOG_LEVEL_INF);
+
+#define BIN_US            (FORECAST_BIN_S * 1000000LL)
+#define BINS_PER_H        (3600 / FORECAST_BIN_S)
+#define MAX_GAP_BINS      BINS_PER_H     // trou comblé au-delà : historique périmé
+
+// Zambretti : 950 .. 1050 hPa niveau mer en 22 classes
+#define Z_BOTTOM_PA       95000
+#define Z_RANGE_PA        10000
+#define Z_CLASSES         22
+
+static struct {
+    // Tranche en cours (pression en dPa)
+    int64_t bin_sum;
+    uint32_t bin_n;
+    int64_t bin_end_us;
+    int32_t last_dpa;
+    // Anneau 3 h et sommes des moindres carrés (indice 0 = plus ancien)
+    int32_t short_y[FORECAST_SHORT_LEN];
+    int short_head;
+    int short_fill;
+    int64_t sy;
+    int64_t sxy;
+    // Anneau 24 h
+    int64_t long_sum;
+    int long_n;
+    int32_t long_y[FORECAST_LONG_LEN];
+    int long_head;
+    int long_fill;
+    ForecastInfo info;
+} fc = { .info.code = FORECAST_NONE };
+
+static struct k_spinlock lock;
+
+// Pression station -> niveau mer (atmosphère standard), calculé une fois
+static float sea_level_factor;
+
+static void history_clear(void)
+{
+    fc.short_head = fc.short_fill = 0;
+    fc.sy = fc.sxy = 0;
+    fc.long_sum = 0;
+    fc.long_n = 0;
+    fc.long_head = fc.long_fill = 0;
+}
+
+/* ==================== Anneaux ==================== */
+/* Nouvelle tranche : retrait du plus ancien, décalage des indices en O(1) */
+static void short_push(int32_t y)
+{
+    const int n = FORECAST_SHORT_LEN;
+
+    if (fc.short_fill == n) {
+        int32_t old = fc.short_y[fc.short_head];
+
+        // Σi·y sur y1..yn réindexés 0..n-1 : Σi·y - (Σy - y0) + (n-1)·yn
+        fc.sxy += (int64_t)(n - 1) * y - (fc.sy - old);
+        fc.sy += y - old;
+    } else {
+        fc.sxy += (int64_t)fc.short_fill * y;
+        fc.sy += y;
+        fc.short_fill++;
+    }
+    fc.short_y[fc.short_head] = y;
+    fc.short_head = (fc.short_head + 1) % n;
+}
+
+static void long_push(int32_t y)
+{
+    fc.long_sum += y;
+    if (++fc.long_n < FORECAST_LONG_DECIM) {
+        return;
+    }
+    fc.long_y[fc.long_head] = (int32_t)(fc.long_sum / fc.long_n);
+    fc.long_head = (fc.long_head + 1) % FORECAST_LONG_LEN;
+    fc.long_fill = MIN(fc.long_fill + 1, FORECAST_LONG_LEN);
+    fc.long_sum = 0;
+    fc.long_n = 0;
+}
+
+/* Pente des moindres carrés en dPa par tranche, sommes exactes */
+static float short_slope(void)
+{
+    const int64_t n = fc.short_fill;
+
+    if (n < 2) {
+        return 0.0f;
+    }
+    // Σx = n(n-1)/2 ; n·Σx² - (Σx)² = n²(n²-1)/12
+    int64_t sx = n * (n - 1) / 2;
+    int64_t num = n * fc.sxy - sx * fc.sy;
+    int64_t den = n * n * (n * n - 1) / 12;
+
+    return (float)num / (float)den;
+}
+
+/* ==================== Prévision ==================== */
+static void update_info(void)
+{
+    ForecastInfo f = fc.info;
+    int32_t p_dpa = fc.short_y[(fc.short_head + FORECAST_SHORT_LEN - 1) % FORECAST_SHORT_LEN];
+
+    f.depth_bins = (uint8_t)fc.short_fill;
+    f.valid = fc.short_fill >= FORECAST_MIN_BINS;
+    f.pressure_pa = (uint32_t)(p_dpa / 10);
+    f.sea_level_pa = (uint32_t)(p_dpa * sea_level_factor / 10.0f);
+    f.slope_pa_h = short_slope() * BINS_PER_H / 10.0f;
+    f.delta_3h_pa = (int32_t)(f.slope_pa_h * 3.0f);
+    if (fc.long_fill >= 2) {
+        int newest = (fc.long_head + FORECAST_LONG_LEN - 1) % FORECAST_LONG_LEN;
+        int oldest = (fc.long_head + FORECAST_LONG_LEN - fc.long_fill) % FORECAST_LONG_LEN;
+
+        f.delta_24h_pa = (fc.long_y[newest] - fc.long_y[oldest]) / 10;
+        f.hours_24h_10 = (uint16_t)((fc.long_fill - 1) * 5);
+    } else {
+        f.delta_24h_pa = 0;
+        f.hours_24h_10 = 0;
+    }
+    f.trend = f.delta_3h_pa > FORECAST_TREND_PA_3H ? FORECAST_RISING :
+              f.delta_3h_pa < -FORECAST_TREND_PA_3H ? FORECAST_FALLING : FORECAST_STEADY;
+    f.code = f.valid ? forecast_zambretti(f.sea_level_pa, f.trend) : FORECAST_NONE;
+
+    if (f.valid && (f.code != fc.info.code || f.trend != fc.info.trend)) {
+        LOG_INF("Prévision : %s (%s, %d Pa / 3 h)", forecast_text(f.code),
+                forecast_trend_name(f.trend), f.delta_3h_pa);
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    fc.info = f;
+    k_spin_unlock(&lock, key);
+}
+
+static void close_bin(void)
+{
+    int32_t y = (int32_t)(fc.bin_sum / fc.bin_n);
+
+    fc.last_dpa = y;
+    fc.bin_sum = 0;
+    fc.bin_n = 0;
+    short_push(y);
+    long_push(y);
+    update_info();
+}
+
+bool forecast_feed(const EnvSample *samples, int n)
+{
+    bool closed = false;
+
+    if (sea_level_factor == 0.0f) {
+        sea_level_factor = powf(1.0f - CONFIG_ZSWATCH_FORECAST_ALTITUDE_M / 44330.77f,
+                                -5.25588f);
+    }
+    for (int i = 0; i < n; i++) {
+        const EnvSample *s = &samples[i];
+        // kPa -> dPa (résolution LPS22HH : ~0.02 Pa)
+        int32_t dpa = s->pressure.val1 * 10000 + s->pressure.val2 / 100;
+
+        if (fc.bin_n > 0 && s->timestamp_us >= fc.bin_end_us) {
+            close_bin();
+            closed = true;
+            int64_t missing = (s->timestamp_us - fc.bin_end_us) / BIN_US;
+
+            if (missing > MAX_GAP_BINS) {
+                LOG_WRN("Pression absente %d min : historique vidé",
+                        (int)(missing * FORECAST_BIN_S / 60));
+                history_clear();
+            } else {
+                // Trou court (capteur en veille) : dernière tranche reconduite
+                for (int k = 0; k < missing; k++) {
+                    fc.bin_sum = fc.last_dpa;
+                    fc.bin_n = 1;
+                    close_bin();
+                }
+            }
+            fc.bin_end_us += (missing + 1) * BIN_US;
+        }
+        if (fc.bin_n == 0 && s->timestamp_us >= fc.bin_end_us) {
+            fc.bin_end_us = s->timestamp_us + BIN_US;
+        }
+        fc.bin_sum += dpa;
+        fc.bin_n++;
+    }
+    return closed;
+}
+
+void forecast_get(ForecastInfo *info)
+{
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    *info = fc.info;
+    k_spin_unlock(&lock, key);
+}
+
+/* Variante de Zambretti en tables (Negretti & Zambra), sans vent ni saison */
+uint8_t forecast_zambretti(uint32_t sea_level_pa, ForecastTrend trend)
+{
+    static const uint8_t rising[Z_CLASSES] = {
+        25, 25, 25, 24, 24, 19, 16, 12, 11, 9, 8, 6, 5, 2, 1, 1, 0, 0, 0, 0, 0, 0,
+    };
+    static const uint8_t steady[Z_CLASSES] = {
+        25, 25, 25, 25, 25, 25, 23, 23, 22, 18, 15, 13, 10, 4, 1, 1, 0, 0, 0, 0, 0, 0,
+    };
+    static const uint8_t falling[Z_CLASSES] = {
+        25, 25, 25, 25, 25, 25, 25, 25, 23, 23, 21, 20, 17, 14, 7, 3, 1, 1, 1, 0, 0, 0,
+    };
+    int32_t cls = ((int32_t)sea_level_pa - Z_BOTTOM_PA) * Z_CLASSES / Z_RANGE_PA;
+
+    cls = CLAMP(cls, 0, Z_CLASSES - 1);
+    switch (trend) {
+    case FORECAST_RISING:
+        return rising[cls];
+    case FORECAST_FALLING:
+        return falling[cls];
+    default:
+        return steady[cls];
+    }
+}
+
+const char *forecast_text(uint8_t code)
+{
+    static const char *const texts[] = {
+        "Beau temps stable",
+        "Beau temps",
+        "Devenant beau",
+        "Beau, devenant moins stable",
+        "Beau, averses possibles",
+        "Assez beau, en amelioration",
+        "Assez beau, averses possibles au debut",
+        "Assez beau, averses plus tard",
+        "Averses puis amelioration",
+        "Variable, en amelioration",
+        "Assez beau, averses probables",
+        "Plutot instable, eclaircies plus tard",
+        "Instable, amelioration probable",
+        "Averses et eclaircies",
+        "Averses, devenant moins stable",
+        "Variable, un peu de pluie",
+        "Instable, courtes eclaircies",
+        "Instable, pluie plus tard",
+        "Instable, un peu de pluie",
+        "Tres instable",
+        "Pluie par moments, se degradant",
+        "Pluie par moments, tres instable",
+        "Pluie frequente",
+        "Pluie, tres instable",
+        "Tempete, amelioration possible",
+        "Tempete, fortes pluies",
+    };
+
+    return code < ARRAY_SIZE(texts) ? texts[code] : "historique insuffisant";
+}
+
+const char *forecast_trend_name(ForecastTrend trend)
+{
+    switch (trend) {
+    case FORECAST_RISING:
+        return "hausse";
+    case FORECAST_FALLING:
+        return "baisse";
+    default:
+        return "stable";
+    }
+}
+
+void forecast_reset(void)
+{
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    memset(&fc, 0, sizeof(fc));
+    fc.info.code = FORECAST_NONE;
+    k_spin_unlock(&lock, key);
+}
+
+#endif /* CONFIG_ZSWATCH_FORECAST */
@@ -0,0 +1,65 @@
+#ifndef FORECAST_H
+#define FORECAST_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "env_sensor.h"
+
+/*
+ * Prévision météo sur la tendance barométrique (LPS22HH), en mémoire fixe
+ * et O(1) par échantillon pour tourner en permanence.
+ *
+ * Les échantillons sont moyennés par tranches de FORECAST_BIN_S ; chaque
+ * tranche entre dans deux anneaux :
+ *   - 3 h à 5 min : pente des moindres carrés, entretenue en O(1) par
+ *     des sommes entières exactes (Σy, Σi·y) ;
+ *   - 24 h à 30 min : variation sur la journée.
+ * La pression ramenée au niveau de la mer (altitude de la station en
+ * Kconfig) et la tendance sur 3 h donnent une prévision de Zambretti
+ * (26 libellés, 0 = beau temps stable .. 25 = tempête).
+ */
+#define FORECAST_BIN_S         300                      // tranche de 5 min
+#define FORECAST_SHORT_LEN     36                       // 3 h
+#define FORECAST_LONG_DECIM    6                        // 30 min
+#define FORECAST_LONG_LEN      48                       // 24 h
+#define FORECAST_MIN_BINS      12                       // 1 h avant la première prévision
+#define FORECAST_TREND_PA_3H   160                      // ±1.6 hPa / 3 h : stable
+#define FORECAST_NONE          0xFF
+
+typedef enum {
+    FORECAST_STEADY = 0,
+    FORECAST_RISING,
+    FORECAST_FALLING,
+} ForecastTrend;
+
+typedef struct {
+    bool valid;               // au moins FORECAST_MIN_BINS tranches
+    uint32_t pressure_pa;     // dernière tranche (station)
+    uint32_t sea_level_pa;    // ramenée au niveau de la mer
+    float slope_pa_h;         // pente des moindres carrés sur l'anneau 3 h
+    int32_t delta_3h_pa;      // pente ramenée à 3 h
+    int32_t delta_24h_pa;     // dernière tranche 30 min - plus ancienne
+    uint16_t hours_24h_10;    // profondeur de l'anneau 24 h (h * 10)
+    ForecastTrend trend;
+    uint8_t code;             // Zambretti 0 .. 25, FORECAST_NONE sans historique
+    uint8_t depth_bins;       // tranches dans l'anneau 3 h
+} ForecastInfo;
+
+/**
+ * @brief Traite des échantillons LPS22HH (du plus ancien au plus récent).
+ *        Un seul appelant (boucle principale).
+ * @return true si au moins une tranche a été close (nouvelle prévision)
+ */
+bool forecast_feed(const EnvSample *samples, int n);
+
+void forecast_get(ForecastInfo *info);
+
+/* Prévision de Zambretti pour une pression niveau mer et une tendance */
+uint8_t forecast_zambretti(uint32_t sea_level_pa, ForecastTrend trend);
+
+const char *forecast_text(uint8_t code);
+const char *forecast_trend_name(ForecastTrend trend);
+
+void forecast_reset(void);
+
+#endif
@@ -0,0 +1,133 @@
+#include "imu_stream.h"
+#include "ble.h"
+#include "ble_link.h"
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/logging/log.h>
+#include <string.h>
+
+LOG_MODULE_REGISTER(imu_stream, LOG_LEVEL_INF);
+
+// Pire cas d'un échantillon delta : 6 varints de 3 octets
+#define SAMPLE_MAX_SIZE 18
+#define PACKET_MAX_SIZE 244
+
+// Écrits par le thread BT (caractéristique de contrôle), appliqués par feed()
+static volatile bool enabled;
+static volatile uint8_t requested_decimation = 1;
+
+static uint8_t decimation = 1;
+static uint8_t skip;
+
+static uint8_t packet[PACKET_MAX_SIZE];
+static uint16_t pos;
+static uint8_t count;
+static uint16_t seq;
+static int16_t prev[6];
+
+/* ==================== Encodage ==================== */
+static uint16_t put_varint(uint8_t *p, int32_t delta)
+{
+    uint32_t v = ((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31);  // zig-zag
+    uint16_t n = 0;
+
+    while (v >= 0x80) {
+        p[n++] = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    p[n++] = (uint8_t)v;
+    return n;
+}
+
+static void flush(void)
+{
+    if (count == 0) {
+        return;
+    }
+    packet[8] = count;
+    ble_notify_imu_stream(packet, pos);
+    count = 0;
+}
+
+static void add(const MotionSample *m, uint16_t cap)
+{
+    int16_t cur[6] = {
+        m->accel[0], m->accel[1], m->accel[2],
+        m->gyro[0], m->gyro[1], m->gyro[2],
+    };
+
+    if (count > 0 && (pos + SAMPLE_MAX_SIZE > cap || count == UINT8_MAX)) {
+        flush();
+    }
+
+    if (count == 0) {
+        // Nouveau paquet : en-tête + échantillon de référence complet
+        sys_put_le16(seq++, &packet[0]);
+        sys_put_le32((uint32_t)(m->timestamp_us / 1000), &packet[2]);
+        sys_put_le16(10000 * decimation / MOTION_ODR_HZ, &packet[6]);
+        pos = 9;
+        for (int i = 0; i < 6; i++) {
+            sys_put_le16(cur[i], &packet[pos]);
+            pos += 2;
+        }
+    } else {
+        for (int i = 0; i < 6; i++) {
+            pos += put_varint(&packet[pos], (int32_t)cur[i] - prev[i]);
+        }
+    }
+
+    memcpy(prev, cur, sizeof(prev));
+    count++;
+}
+
+/* ==================== API ==================== */
+void imu_stream_control(bool enable, uint16_t rate_hz)
+{
+    if (!enable) {
+        enabled = false;
+        ble_link_set_demand(BLE_LINK_DEMAND_STREAM, false);
+        LOG_INF("Streaming IMU arrêté");
+        return;
+    }
+
+    if (rate_hz == 0 || rate_hz > MOTION_ODR_HZ) {
+        rate_hz = MOTION_ODR_HZ;
+    }
+    requested_decimation = MOTION_ODR_HZ / rate_hz;
+    enabled = true;
+    ble_link_set_demand(BLE_LINK_DEMAND_STREAM, true);
+    LOG_INF("Streaming IMU démarré : %u Hz", MOTION_ODR_HZ / requested_decimation);
+}
+
+bool imu_stream_enabled(void)
+{
+    return enabled;
+}
+
+void imu_stream_feed(const MotionSample *samples, int n)
+{
+    uint16_t cap = MIN(ble_link_max_payload(), PACKET_MAX_SIZE);
+
+    if (!enabled) {
+        flush();  // dernier paquet partiel à l'arrêt
+        return;
+    }
+    if (cap < IMU_STREAM_HEADER_SIZE) {
+        return;
+    }
+
+    if (decimation != requested_decimation) {
+        flush();
+        decimation = requested_decimation;
+        skip = 0;
+    }
+
+    for (int i = 0; i < n; i++) {
+        // Décimation : un échantillon sur "decimation"
+        if (skip > 0) {
+            skip--;
+            continue;
+        }
+        skip = decimation - 1;
+        add(&samples[i], cap);
+    }
+}
@@ -0,0 +1,33 @@
+#ifndef IMU_STREAM_H
+#define IMU_STREAM_H
+
+#include <stdbool.h>
+#include "motion_sensor.h"
+
+/*
+ * Paquet de streaming IMU (little-endian) :
+ *   [0]  uint16 numéro de séquence
+ *   [2]  uint32 horodatage du premier échantillon (ms depuis le démarrage)
+ *   [6]  uint16 période entre échantillons (ms * 10, ex: 48 = 4.8 ms à 208 Hz,
+ *               10000 à 1 Hz)
+ *   [8]  uint8  nombre d'échantillons n
+ *   [9]  int16[6] échantillon de référence : accel X/Y/Z puis gyro X/Y/Z (LSB bruts)
+ *   [21] n-1 échantillons : 6 deltas avec le précédent, zig-zag + varint (1 à 3 octets)
+ * Sensibilités : MOTION_ACCEL_UG_PER_LSB, MOTION_GYRO_10UDPS_PER_LSB.
+ */
+#define IMU_STREAM_HEADER_SIZE 21
+
+/**
+ * @brief Démarre ou arrête le streaming (écriture de la caractéristique de contrôle).
+ * @param rate_hz fréquence demandée, arrondie à un diviseur de MOTION_ODR_HZ
+ */
+void imu_stream_control(bool enable, uint16_t rate_hz);
+
+bool imu_stream_enabled(void);
+
+/**
+ * @brief Ajoute des échantillons pleine cadence ; les paquets pleins sont notifiés.
+ */
+void imu_stream_feed(const MotionSample *samples, int n);
+
+#endif
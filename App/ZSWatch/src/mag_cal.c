@@ -0,0 +1,407 @@
+#include "mag_cal.h"
+
+#ifdef CONFIG_ZSWATCH_MAG_CAL
+
+#include <zephyr/kernel.h>
+#include <zephyr/settings/settings.h>
+#include <zephyr/logging/log.h>
+#include <errno.h>
+#include <string.h>
+#include <math.h>
+
+LOG_MODULE_REGISTER(mag_cal, LOG_LEVEL_INF);
+
+#define NPARAM            9
+#define SAVE_MIN_OFFSET_G 0.005f  // variation justifiant une écriture flash
+#define SAVE_MIN_RADIUS   0.01f
+#define FIELD_MIN_G       0.15f   // champ terrestre : 0.25 .. 0.65 G
+#define FIELD_MAX_G       1.0f
+#define SOFT_MAX_RATIO    4.0f    // anisotropie maximale plausible (valeurs propres)
+
+/*
+ * Modèle : p0 x² + p1 y² + p2 z² + 2 p3 xy + 2 p4 xz + 2 p5 yz
+ *          + 2 p6 x + 2 p7 y + 2 p8 z = 1
+ * Équations normales en double : les termes de degré 4 perdent trop de
+ * précision en float quand le fer dur dépasse le champ terrestre.
+ */
+static struct {
+    double ata[NPARAM][NPARAM];
+    double atb[NPARAM];
+    double weight;         // somme des poids (pour le résidu)
+    uint32_t points;
+    uint32_t since_fit;
+    float last[3];
+    bool has_last;
+    float lo[3], hi[3];    // boîte englobante : centre grossier pour les octants
+    uint8_t coverage;
+    uint32_t fits;
+    bool valid;
+    MagCal cal;
+} mc;
+
+// Copie à écrire, partagée avec le work de sauvegarde
+static MagCal save_copy;
+static MagCal saved;
+static bool has_saved;
+static struct k_spinlock save_lock;
+
+/* ==================== Persistance (settings) ==================== */
+static void save_work_handler(struct k_work *work)
+{
+    MagCal copy;
+    k_spinlock_key_t key = k_spin_lock(&save_lock);
+    copy = save_copy;
+    k_spin_unlock(&save_lock, key);
+
+    if (settings_save_one("magcal/fit", &copy, sizeof(copy)) < 0) {
+        LOG_WRN("Sauvegarde de la calibration impossible");
+    }
+}
+
+static K_WORK_DEFINE(save_work, save_work_handler);
+
+static int magcal_set(const char *name, size_t len, settings_read_cb read_cb, void *cb_arg)
+{
+    const char *next;
+    MagCal cal;
+
+    if (!settings_name_steq(name, "fit", &next) || next) {
+        return -ENOENT;
+    }
+    if (len != sizeof(cal) || read_cb(cb_arg, &cal, sizeof(cal)) != sizeof(cal)) {
+        return -EINVAL;
+    }
+    mc.cal = cal;
+    mc.valid = true;
+    saved = cal;
+    has_saved = true;
+    LOG_INF("Calibration magnétomètre rechargée (champ %d mG)", (int)(cal.radius * 1000));
+    return 0;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(magcal, "magcal", NULL, magcal_set, NULL, NULL);
+
+static void save_if_changed(void)
+{
+    bool changed = !has_saved ||
+                   fabsf(mc.cal.radius - saved.radius) > SAVE_MIN_RADIUS * saved.radius;
+
+    for (int i = 0; i < 3 && !changed; i++) {
+        changed = fabsf(mc.cal.offset[i] - saved.offset[i]) > SAVE_MIN_OFFSET_G;
+    }
+    if (!changed) {
+        return;
+    }
+    saved = mc.cal;
+    has_saved = true;
+
+    k_spinlock_key_t key = k_spin_lock(&save_lock);
+    save_copy = mc.cal;
+    k_spin_unlock(&save_lock, key);
+    k_work_submit(&save_work);
+}
+
+/* ==================== Algèbre ==================== */
+/* Résolution de A p = b (Gauss, pivot partiel) ; A et b détruits */
+static int solve(double a[NPARAM][NPARAM], double b[NPARAM], double p[NPARAM])
+{
+    for (int c = 0; c < NPARAM; c++) {
+        int piv = c;
+        for (int r = c + 1; r < NPARAM; r++) {
+            if (fabs(a[r][c]) > fabs(a[piv][c])) {
+                piv = r;
+            }
+        }
+        if (fabs(a[piv][c]) < 1e-12) {
+            return -1;  // points dégénérés (mouvement dans un plan)
+        }
+        if (piv != c) {
+            for (int k = 0; k < NPARAM; k++) {
+                double t = a[c][k];
+                a[c][k] = a[piv][k];
+                a[piv][k] = t;
+            }
+            double t = b[c];
+            b[c] = b[piv];
+            b[piv] = t;
+        }
+        for (int r = c + 1; r < NPARAM; r++) {
+            double f = a[r][c] / a[c][c];
+            for (int k = c; k < NPARAM; k++) {
+                a[r][k] -= f * a[c][k];
+            }
+            b[r] -= f * b[c];
+        }
+    }
+    for (int r = NPARAM - 1; r >= 0; r--) {
+        double s = b[r];
+        for (int k = r + 1; k < NPARAM; k++) {
+            s -= a[r][k] * p[k];
+        }
+        p[r] = s / a[r][r];
+    }
+    return 0;
+}
+
+/* Valeurs / vecteurs propres d'une matrice 3x3 symétrique (Jacobi) */
+static void eigen_sym3(double a[3][3], double val[3], double vec[3][3])
+{
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            vec[i][j] = (i == j) ? 1.0 : 0.0;
+        }
+    }
+    for (int sweep = 0; sweep < 10; sweep++) {
+        double off = a[0][1] * a[0][1] + a[0][2] * a[0][2] + a[1][2] * a[1][2];
+        if (off < 1e-20) {
+            break;
+        }
+        for (int p = 0; p < 2; p++) {
+            for (int q = p + 1; q < 3; q++) {
+                if (fabs(a[p][q]) < 1e-30) {
+                    continue;
+                }
+                double theta = (a[q][q] - a[p][p]) / (2.0 * a[p][q]);
+                double t = (theta >= 0 ? 1.0 : -1.0) / (fabs(theta) + sqrt(theta * theta + 1.0));
+                double c = 1.0 / sqrt(t * t + 1.0), s = t * c;
+
+                for (int k = 0; k < 3; k++) {
+                    double akp = a[k][p], akq = a[k][q];
+                    a[k][p] = c * akp - s * akq;
+                    a[k][q] = s * akp + c * akq;
+                }
+                for (int k = 0; k < 3; k++) {
+                    double apk = a[p][k], aqk = a[q][k];
+                    a[p][k] = c * apk - s * aqk;
+                    a[q][k] = s * apk + c * aqk;
+                }
+                for (int k = 0; k < 3; k++) {
+                    double vkp = vec[k][p], vkq = vec[k][q];
+                    vec[k][p] = c * vkp - s * vkq;
+                    vec[k][q] = s * vkp + c * vkq;
+                }
+            }
+        }
+    }
+    for (int i = 0; i < 3; i++) {
+        val[i] = a[i][i];
+    }
+}
+
+/* ==================== Ajustement ==================== */
+static void fit(void)
+{
+    // Copies de travail statiques : la pile de main reste petite
+    static double a[NPARAM][NPARAM], b[NPARAM];
+    double p[NPARAM], m[3][3], val[3], vec[3][3];
+
+    memcpy(a, mc.ata, sizeof(a));
+    memcpy(b, mc.atb, sizeof(b));
+    if (solve(a, b, p) != 0) {
+        return;
+    }
+
+    // Résidu algébrique sans relire les points : n - p.b (A p = b)
+    double rss = mc.weight;
+    for (int i = 0; i < NPARAM; i++) {
+        rss -= p[i] * mc.atb[i];
+    }
+    // e = |x|²/r² - 1 ~ 2 dr/r
+    float rms = 0.5f * sqrtf((float)MAX(rss, 0.0) / (float)mc.weight);
+
+    m[0][0] = p[0]; m[1][1] = p[1]; m[2][2] = p[2];
+    m[0][1] = m[1][0] = p[3];
+    m[0][2] = m[2][0] = p[4];
+    m[1][2] = m[2][1] = p[5];
+    eigen_sym3(m, val, vec);
+
+    // Origine hors de l'ellipsoïde (fer dur > champ) : forme négative, x'Mx + 2v'x = -1
+    double d = 1.0;
+    if (val[0] < 0.0 && val[1] < 0.0 && val[2] < 0.0) {
+        for (int i = 0; i < NPARAM; i++) {
+            p[i] = -p[i];
+        }
+        for (int i = 0; i < 3; i++) {
+            val[i] = -val[i];
+        }
+        d = -1.0;
+    }
+    if (val[0] <= 0.0 || val[1] <= 0.0 || val[2] <= 0.0) {
+        return;  // pas un ellipsoïde
+    }
+
+    // Centre c = -M^-1 v, puis normalisation (x-c)' M/k (x-c) = 1, k = d - v'c
+    double c[3] = { 0 }, k = d;
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            double inv = 0.0;
+            for (int e = 0; e < 3; e++) {
+                inv += vec[i][e] * vec[j][e] / val[e];
+            }
+            c[i] -= inv * p[6 + j];
+        }
+    }
+    for (int i = 0; i < 3; i++) {
+        k -= p[6 + i] * c[i];
+    }
+    if (k <= 0.0) {
+        return;
+    }
+
+    // Rayon moyen géométrique : R^-2 = (produit des valeurs propres / k^3)^(1/3)
+    double radius = pow(val[0] * val[1] * val[2] / (k * k * k), -1.0 / 6.0);
+    double vmin = MIN(val[0], MIN(val[1], val[2])), vmax = MAX(val[0], MAX(val[1], val[2]));
+    if (radius < FIELD_MIN_G || radius > FIELD_MAX_G || vmax > SOFT_MAX_RATIO * vmin ||
+        rms > MAG_CAL_MAX_RMS) {
+        return;
+    }
+
+    // Fer doux : R * racine(M/k), ramène l'ellipsoïde sur la sphère de rayon R
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            double s = 0.0;
+            for (int e = 0; e < 3; e++) {
+                s += vec[i][e] * vec[j][e] * sqrt(val[e] / k);
+            }
+            mc.cal.soft[i][j] = (float)(radius * s);
+        }
+        mc.cal.offset[i] = (float)c[i];
+    }
+    mc.cal.radius = (float)radius;
+    mc.cal.rms = rms;
+    mc.valid = true;
+    mc.fits++;
+    save_if_changed();
+}
+
+static void add_point(const float v[3])
+{
+    double phi[NPARAM] = {
+        v[0] * v[0], v[1] * v[1], v[2] * v[2],
+        2.0 * v[0] * v[1], 2.0 * v[0] * v[2], 2.0 * v[1] * v[2],
+        2.0 * v[0], 2.0 * v[1], 2.0 * v[2],
+    };
+
+    // Fenêtre glissante approchée : on divise le poids du passé
+    if (mc.points >= MAG_CAL_WINDOW) {
+        for (int i = 0; i < NPARAM; i++) {
+            for (int j = i; j < NPARAM; j++) {
+                mc.ata[i][j] *= 0.5;
+            }
+            mc.atb[i] *= 0.5;
+        }
+        mc.weight *= 0.5;
+        mc.points /= 2;
+    }
+    // Triangle supérieur seulement (45 produits), complété avant résolution
+    for (int i = 0; i < NPARAM; i++) {
+        for (int j = i; j < NPARAM; j++) {
+            mc.ata[i][j] += phi[i] * phi[j];
+        }
+        mc.atb[i] += phi[i];
+    }
+    mc.weight += 1.0;
+    mc.points++;
+}
+
+void mag_cal_feed(const MagSample *samples, int n)
+{
+    for (int s = 0; s < n; s++) {
+        float v[3], d2 = 0.0f;
+
+        mag_gauss(samples[s].magn, v);
+        if (mc.has_last) {
+            for (int i = 0; i < 3; i++) {
+                d2 += (v[i] - mc.last[i]) * (v[i] - mc.last[i]);
+            }
+            if (d2 < MAG_CAL_MIN_STEP_G * MAG_CAL_MIN_STEP_G) {
+                continue;  // montre immobile : pas de sur-pondération
+            }
+        } else {
+            memcpy(mc.lo, v, sizeof(v));
+            memcpy(mc.hi, v, sizeof(v));
+        }
+        memcpy(mc.last, v, sizeof(v));
+        mc.has_last = true;
+
+        uint8_t octant = 0;
+        for (int i = 0; i < 3; i++) {
+            mc.lo[i] = MIN(mc.lo[i], v[i]);
+            mc.hi[i] = MAX(mc.hi[i], v[i]);
+            if (v[i] > 0.5f * (mc.lo[i] + mc.hi[i])) {
+                octant |= BIT(i);
+            }
+        }
+        mc.coverage |= BIT(octant);
+
+        add_point(v);
+        if (++mc.since_fit >= MAG_CAL_FIT_EVERY && mc.points >= MAG_CAL_MIN_POINTS &&
+            mc.coverage == 0xFF) {
+            mc.since_fit = 0;
+            for (int i = 0; i < NPARAM; i++) {
+                for (int j = 0; j < i; j++) {
+                    mc.ata[i][j] = mc.ata[j][i];
+                }
+            }
+            fit();
+        }
+    }
+}
+
+void mag_cal_apply(const float in[3], float out[3])
+{
+    float d[3];
+
+    if (!mc.valid) {
+        if (out != in) {
+            memcpy(out, in, sizeof(d));
+        }
+        return;
+    }
+    for (int i = 0; i < 3; i++) {
+        d[i] = in[i] - mc.cal.offset[i];
+    }
+    for (int i = 0; i < 3; i++) {
+        out[i] = mc.cal.soft[i][0] * d[0] + mc.cal.soft[i][1] * d[1] + mc.cal.soft[i][2] * d[2];
+    }
+}
+
+void mag_cal_get_info(MagCalInfo *info)
+{
+    info->valid = mc.valid;
+    info->coverage = mc.coverage;
+    info->points = mc.points;
+    info->fits = mc.fits;
+    info->cal = mc.cal;
+}
+
+float mag_cal_heading(const float accel[3], const float mag[3])
+{
+    float an = sqrtf(accel[0] * accel[0] + accel[1] * accel[1] + accel[2] * accel[2]);
+    if (an == 0.0f) {
+        return -1.0f;
+    }
+    float u[3] = { accel[0] / an, accel[1] / an, accel[2] / an };
+
+    // Nord : champ projeté sur l'horizontale ; est = nord x haut
+    float d = mag[0] * u[0] + mag[1] * u[1] + mag[2] * u[2];
+    float n[3] = { mag[0] - d * u[0], mag[1] - d * u[1], mag[2] - d * u[2] };
+    float e[3] = {
+        n[1] * u[2] - n[2] * u[1],
+        n[2] * u[0] - n[0] * u[2],
+        n[0] * u[1] - n[1] * u[0],
+    };
+    // Axe x de la montre dans le plan horizontal
+    if (n[0] == 0.0f && e[0] == 0.0f) {
+        return -1.0f;
+    }
+    float h = atan2f(e[0], n[0]) * 57.29578f;
+    return h < 0.0f ? h + 360.0f : h;
+}
+
+void mag_cal_reset(void)
+{
+    memset(&mc, 0, sizeof(mc));
+}
+
+#endif /* CONFIG_ZSWATCH_MAG_CAL */
@@ -0,0 +1,63 @@
+#ifndef MAG_CAL_H
+#define MAG_CAL_H
+
+#include <stdbool.h>
+#include "mag_sensor.h"
+
+/*
+ * Calibration en ligne du LIS2MDL (fer dur + fer doux).
+ *
+ * Chaque échantillon assez éloigné du précédent entre dans les équations
+ * normales d'un ajustement d'ellipsoïde à 9 paramètres (mémoire fixe :
+ * matrice 9x9, O(1) par échantillon ; poids des anciens points divisé par
+ * deux tous les MAG_CAL_WINDOW points). Toutes les MAG_CAL_FIT_EVERY
+ * nouvelles mesures, une fois les 8 octants couverts, le système est
+ * résolu (quelques µs) : centre = fer dur, racine de la forme quadratique
+ * = fer doux. Un ajustement accepté est sauvegardé par les settings (hors
+ * de la boucle d'acquisition) et rechargé au démarrage par settings_load().
+ */
+#define MAG_CAL_MIN_STEP_G   0.03f  // écart minimal entre deux points retenus
+#define MAG_CAL_MIN_POINTS   150
+#define MAG_CAL_FIT_EVERY    50
+#define MAG_CAL_WINDOW       1000
+#define MAG_CAL_MAX_RMS      0.03f  // écart radial relatif maximal accepté
+
+typedef struct {
+    float offset[3];       // fer dur (gauss, repère LIS2MDL)
+    float soft[3][3];      // fer doux (symétrique) : m_cal = soft * (m - offset)
+    float radius;          // intensité du champ terrestre estimée (gauss)
+    float rms;             // écart radial relatif résiduel de l'ajustement
+} MagCal;
+
+typedef struct {
+    bool valid;            // calibration disponible (ajustée ou rechargée)
+    uint8_t coverage;      // octants couverts (bit par octant)
+    uint32_t points;       // points retenus dans la fenêtre
+    uint32_t fits;         // ajustements acceptés depuis le démarrage
+    MagCal cal;
+} MagCalInfo;
+
+/**
+ * @brief Ajoute des échantillons au fit (un seul appelant, boucle
+ *        principale). Ne bloque jamais : la sauvegarde passe par la workqueue.
+ */
+void mag_cal_feed(const MagSample *samples, int n);
+
+/* Applique la calibration (gauss, repère LIS2MDL) ; identité sans calibration. in == out permis. */
+void mag_cal_apply(const float in[3], float out[3]);
+
+void mag_cal_get_info(MagCalInfo *info);
+
+/**
+ * @brief Cap compensé en inclinaison, repère IMU (voir mag_to_imu_axes).
+ * @param accel accélération au repos (+z vers le haut, unité quelconque)
+ * @param mag champ calibré
+ * @return cap de l'axe x en degrés, sens horaire depuis le nord magnétique
+ *         [0, 360[, ou -1 si indéterminé (chute libre, champ vertical)
+ */
+float mag_cal_heading(const float accel[3], const float mag[3]);
+
+/* Oublie les points accumulés et la calibration courante */
+void mag_cal_reset(void);
+
+#endif
@@ -1,17 +1,82 @@
 #include "mag_sensor.h"
 #include <zephyr/device.h>
+#include <zephyr/pm/device.h>
+#include "timebase.h"
+
+#ifdef CONFIG_LIS2MDL_TRIGGER
+/* Exécuté dans le thread de trigger du driver LIS2MDL (producteur unique) */
+static void mag_data_ready(const struct device *dev, const struct sensor_trigger *trig)
+{
+    MagSensor *s = CONTAINER_OF(trig, MagSensor, drdy_trig);
+    MagSample m;
+
+    if (sensor_sample_fetch(dev) < 0) {
+        return;
+    }
+    m.timestamp_us = timebase_now_us();
+    sensor_channel_get(dev, SENSOR_CHAN_MAGN_XYZ, m.magn);
+    spsc_ring_put(&s->ring, &m);
+}
+#endif
 
 int mag_init(MagSensor *s) {
     s->dev = DEVICE_DT_GET_ONE(st_lis2mdl);
     if (!device_is_ready(s->dev)) return -1;
 
-    struct sensor_value odr = { .val1 = 100, .val2 = 0 };
+    struct sensor_value odr = { .val1 = MAG_ODR_HZ, .val2 = 0 };
     sensor_attr_set(s->dev, SENSOR_CHAN_ALL, SENSOR_ATTR_SAMPLING_FREQUENCY, &odr);
+    s->active = true;
+
+#ifdef CONFIG_LIS2MDL_TRIGGER
+    spsc_ring_init(&s->ring, s->buf, sizeof(MagSample), MAG_RING_LEN);
+    s->drdy_trig.type = SENSOR_TRIG_DATA_READY;
+    s->drdy_trig.chan = SENSOR_CHAN_MAGN_XYZ;
+    if (sensor_trigger_set(s->dev, &s->drdy_trig, mag_data_ready) < 0) return -1;
+#endif
     return 0;
 }
 
 int mag_update(MagSensor *s) {
+    if (!s->active) return 0;
+#ifdef CONFIG_LIS2MDL_TRIGGER
+    // Lu par le handler data-ready : voir mag_read()
+    return 0;
+#else
     if (sensor_sample_fetch(s->dev) < 0) return -1;
     sensor_channel_get(s->dev, SENSOR_CHAN_MAGN_XYZ, s->magn);
+    s->magn_us = timebase_now_us();
+    return 0;
+#endif
+}
+
+int mag_set_active(MagSensor *s, bool on) {
+    int ret = pm_device_action_run(s->dev, on ? PM_DEVICE_ACTION_RESUME : PM_DEVICE_ACTION_SUSPEND);
+
+    if (ret < 0 && ret != -EALREADY) return -1;
+    s->active = on;
+
+#ifdef CONFIG_LIS2MDL_TRIGGER
+    // Une mesure non lue laisse DRDY haut : plus de front sans cette lecture
+    if (on) {
+        sensor_sample_fetch(s->dev);
+    }
+#endif
     return 0;
-}
\ No newline at end of file
+}
+
+int mag_read(MagSensor *s, MagSample *out, int max) {
+    int n = 0;
+
+#ifdef CONFIG_LIS2MDL_TRIGGER
+    while (n < max && spsc_ring_get(&s->ring, &out[n])) {
+        n++;
+    }
+    if (n > 0) {
+        for (int i = 0; i < 3; i++) {
+            s->magn[i] = out[n - 1].magn[i];
+        }
+        s->magn_us = out[n - 1].timestamp_us;
+    }
+#endif
+    return n;
+}
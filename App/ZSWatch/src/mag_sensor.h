@@ -2,13 +2,65 @@
 #define MAG_SENSOR_H
 
 #include <zephyr/drivers/sensor.h>
+#include "spsc_ring.h"
+
+// Anneau d'échantillons LIS2MDL (puissance de 2, ~2.5 s à 100 Hz)
+#define MAG_RING_LEN 256
+
+#define MAG_ODR_HZ 100
+
+typedef struct {
+    int64_t timestamp_us;  // instant d'acquisition (k_uptime, µs)
+    struct sensor_value magn[3];
+} MagSample;
 
 typedef struct {
     const struct device *dev;
     struct sensor_value magn[3];
+    int64_t magn_us;  // horodatage de magn (0 : jamais lu)
+    bool active;  // false : LIS2MDL en power-down
+
+#ifdef CONFIG_LIS2MDL_TRIGGER
+    // Échantillons poussés par le handler data-ready
+    struct sensor_trigger drdy_trig;
+    struct spsc_ring ring;
+    MagSample buf[MAG_RING_LEN];
+#endif
 } MagSensor;
 
 int mag_init(MagSensor *s);
 int mag_update(MagSensor *s);
 
-#endif
\ No newline at end of file
+/* Mode continu (MAG_ODR_HZ) ou power-down via la gestion d'énergie du driver */
+int mag_set_active(MagSensor *s, bool on);
+
+/* Accesseur entier (sans double) : gauss * 100 */
+void mag_magn_centi(const MagSensor *s, int16_t out[3]);
+
+/**
+ * @brief Retire jusqu'à max échantillons de l'anneau (un seul consommateur).
+ *        magn prend la valeur du dernier retiré.
+ * @return nombre d'échantillons copiés (toujours 0 sans trigger LIS2MDL)
+ */
+int mag_read(MagSensor *s, MagSample *out, int max);
+
+/* Champ en gauss (float) */
+static inline void mag_gauss(const struct sensor_value magn[3], float out[3])
+{
+    for (int i = 0; i < 3; i++) {
+        out[i] = magn[i].val1 + magn[i].val2 * 1e-6f;
+    }
+}
+
+/*
+ * Axes LIS2MDL -> axes LSM6DSO sur l'IKS01A3 : LSM6DSO en "ENU",
+ * LIS2MDL en "NWU" (conventions MotionFX de ST).
+ */
+static inline void mag_to_imu_axes(const float m[3], float out[3])
+{
+    out[0] = -m[1];
+    out[1] = m[0];
+    out[2] = m[2];
+}
+
+#endif
@@ -4,74 +4,324 @@
 #include "mag_sensor.h"
 #include "env_sensor.h"
 #include "ble.h"
+#include "ble_link.h"
+#include "sensor_async.h"
+#include "imu_stream.h"
+#include "sensor_log.h"
+#include "bench.h"
+#include "timebase.h"
+#include "fall_detect.h"
+#include "derived.h"
+#include "sensor_bus.h"
+#include "sensor_fixed.h"
+
+#define DRAIN_PERIOD_MS      100   // consommateurs pleine cadence (streaming...)
+#define DASHBOARD_PERIOD_MS  2000  // acquisition publiée sur le bus capteurs
+
+// Échantillons pleine cadence retirés des anneaux à chaque passage
+static MotionSample imu_samples[MOTION_BUF_LEN];
+static EnvSample press_samples[ENV_RING_LEN];
+static MagSample mag_samples[MAG_RING_LEN];
+
+// Pas comptés par le LSM6DSO : plus besoin de l'accéléromètre pleine cadence
+static bool hw_pedometer;
+
+#ifdef CONFIG_ZSWATCH_FALL_DETECT
+/* Dans le work de la FIFO : l'alerte part sans attendre la boucle principale */
+static void fall_alert(const FallEvent *e)
+{
+    ble_indicate_fall(e->phase, e->peak_mg, e->free_fall_ms, (uint32_t)(e->impact_us / 1000),
+                      MIN(e->latency_us / 100, UINT16_MAX), e->snap, e->n_snap);
+}
+#endif
+
+// Blocs capteurs ayant au moins un consommateur
+typedef struct {
+    bool hts;
+    bool press;
+    bool mag;
+    bool accel;
+    bool gyro;
+} SensorNeeds;
+
+static SensorNeeds sensor_needs(void)
+{
+#ifdef CONFIG_ZSWATCH_POWER_SAVE
+    bool frame = ble_is_subscribed(BLE_CH_FRAME);
+    // Le journal enregistre l'environnement en permanence
+    bool log = IS_ENABLED(CONFIG_ZSWATCH_SENSOR_LOG);
+    // Le podomètre logiciel consomme l'accéléromètre en continu
+    bool steps = IS_ENABLED(CONFIG_ZSWATCH_PEDOMETER) && !hw_pedometer;
+    // Idem pour la reconnaissance d'activité
+    bool act = IS_ENABLED(CONFIG_ZSWATCH_ACTIVITY);
+    // La détection de chute surveille l'accéléromètre en permanence
+    bool fall = IS_ENABLED(CONFIG_ZSWATCH_FALL_DETECT);
+    // La fusion 9 axes a besoin des trois blocs à pleine cadence
+    bool orient = IS_ENABLED(CONFIG_ZSWATCH_AHRS) && ble_is_subscribed(BLE_CH_ORIENTATION);
+    // Altimètre en direct : pression et accéléromètre (latence réduite)
+    bool alti = IS_ENABLED(CONFIG_ZSWATCH_ALTIMETER) && ble_is_subscribed(BLE_CH_ALTITUDE);
+    // La prévision météo suit la pression jour et nuit
+    bool weather = IS_ENABLED(CONFIG_ZSWATCH_FORECAST);
+    // Grandeurs dérivées : HTS221 et accéléromètre
+    bool derived = IS_ENABLED(CONFIG_ZSWATCH_DERIVED) && ble_is_subscribed(BLE_CH_DERIVED);
+    bool stream = false;
+#ifdef CONFIG_ZSWATCH_IMU_STREAM
+    stream = imu_stream_enabled();
+#endif
+    return (SensorNeeds){
+        .hts = derived || log || frame || ble_is_subscribed(BLE_CH_TEMP) || ble_is_subscribed(BLE_CH_HUMI),
+        .press = weather || alti || log || frame || ble_is_subscribed(BLE_CH_PRESS),
+        .mag = orient || frame || ble_is_subscribed(BLE_CH_MAG),
+        .accel = derived || fall || act || alti || orient || steps || frame || ble_is_subscribed(BLE_CH_ACCEL) || stream,
+        .gyro = orient || stream,
+    };
+#else
+    return (SensorNeeds){ .hts = true, .press = true, .mag = true, .accel = true, .gyro = true };
+#endif
+}
+
+// Alimente ou met en power-down les blocs dont le besoin a changé.
+// En cas d'échec, l'état actif n'est pas modifié : nouvel essai au cycle suivant.
+static void apply_needs(const SensorNeeds *need, SensorNeeds *active,
+                        EnvSensor *env, MotionSensor *imu, MagSensor *mag)
+{
+    if (need->hts != active->hts || need->press != active->press) {
+        if (env_set_active(env, need->hts, need->press) != 0) {
+            printf("Erreur mise en veille HTS221/LPS22HH\n");
+        } else {
+            active->hts = need->hts;
+            active->press = need->press;
+        }
+    }
+    if (need->mag != active->mag) {
+        if (mag_set_active(mag, need->mag) != 0) {
+            printf("Erreur mise en veille LIS2MDL\n");
+        } else {
+            active->mag = need->mag;
+        }
+    }
+    if (need->accel != active->accel || need->gyro != active->gyro) {
+        if (motion_set_active(imu, need->accel, need->gyro) != 0) {
+            printf("Erreur mise en veille LSM6DSO\n");
+        } else {
+            active->accel = need->accel;
+            active->gyro = need->gyro;
+        }
+    }
+}
 
 int main(void) {
-    MotionSensor imu;
-    MagSensor mag;
-    EnvSensor env;
+    // Statiques : le tampon FIFO de MotionSensor ne tient pas sur la pile de main
+    static MotionSensor imu;
+    static MagSensor mag;
+    static EnvSensor env;
 
     // Initialisation des capteurs
     if (motion_init(&imu) != 0 || mag_init(&mag) != 0 || env_init(&env) != 0) {
         printf("Erreur d'initialisation des capteurs.\n");
         return -1;
     }
+    hw_pedometer = motion_embedded_active(&imu);
+
+#ifdef CONFIG_ZSWATCH_SENSOR_LOG
+    // Sans journal, l'application continue (BLE et console seulement)
+    if (sensor_log_init() != 0) {
+        printf("Erreur d'initialisation du journal.\n");
+    }
+#endif
 
     // Initialisation BLE
     ble_init(); // Ne retourne pas de code d'erreur (log interne)
 
+    // Mesures de performance (CONFIG_ZSWATCH_BENCH uniquement)
+    bench_run(&env, &imu, &mag);
+
+#ifdef CONFIG_ZSWATCH_FALL_DETECT
+    // Après le bench : il rejoue ses traces dans le même détecteur
+    fall_detect_init(&imu, fall_alert);
+#endif
+
+    int n_imu = 0, n_press = 0, n_mag = 0;
+    int64_t next_dashboard = k_uptime_get();
+    uint32_t prev_events = 0, prev_sent = 0;
+#ifdef CONFIG_ZSWATCH_MOTION_EMBEDDED
+    uint32_t n_tap = 0, n_double_tap = 0, n_tilt = 0, n_sig_motion = 0;
+    uint8_t orientation = 0;
+#endif
+    SensorNeeds active = { .hts = true, .press = true, .mag = true, .accel = true, .gyro = true };
+
     while (1) {
+        // --- Capteurs alimentés selon les abonnements ---
+        SensorNeeds need = sensor_needs();
+        apply_needs(&need, &active, &env, &imu, &mag);
+
+        // --- Vidage des anneaux remplis par les triggers / la FIFO ---
+        SensorBatchMsg batch = {
+            .imu = imu_samples,
+            .press = press_samples,
+            .mag = mag_samples,
+            .accel_on = active.accel,
+        };
+#ifdef CONFIG_ZSWATCH_MOTION_FIFO
+        int n = motion_fifo_read(&imu, imu_samples, ARRAY_SIZE(imu_samples));
+#ifdef CONFIG_ZSWATCH_IMU_STREAM
+        imu_stream_feed(imu_samples, n);
+#endif
+        batch.n_imu = n;
+        n_imu += n;
+#endif
+#ifdef CONFIG_ZSWATCH_MOTION_EMBEDDED
+        // --- Événements des fonctions embarquées (plus d'échantillons bruts) ---
+        if (hw_pedometer) {
+            uint32_t evt = motion_take_events(&imu, &orientation);
+
+            n_tap += !!(evt & MOTION_EVT_SINGLE_TAP);
+            n_double_tap += !!(evt & MOTION_EVT_DOUBLE_TAP);
+            n_tilt += !!(evt & MOTION_EVT_TILT);
+            n_sig_motion += !!(evt & MOTION_EVT_SIG_MOTION);
+            batch.hw_steps_valid = true;
+            batch.hw_steps = motion_step_count(&imu);
+        }
+#endif
+        batch.n_press = env_read_pressure(&env, press_samples, ARRAY_SIZE(press_samples));
+        n_press += batch.n_press;
+        batch.n_mag = mag_read(&mag, mag_samples, ARRAY_SIZE(mag_samples));
+        n_mag += batch.n_mag;
+
+        // Acquisition (bus capteurs) et console au rythme du dashboard seulement
+        batch.dashboard = k_uptime_get() >= next_dashboard;
+        if (!batch.dashboard) {
+            // --- Algorithmes (bus_*.c) : lot pleine cadence ---
+            sensor_bus_publish_batch(&batch);
+            k_sleep(K_MSEC(DRAIN_PERIOD_MS));
+            continue;
+        }
+        next_dashboard += DASHBOARD_PERIOD_MS;
+
         printf("\033[H\033[J"); // Rafraîchit la console
-        printf("=== IKS01A3 DASHBOARD FULL ===\n\n");
+        printf("=== IKS01A3 DASHBOARD FULL ===\n");
+        TimebaseInfo tb;
+        timebase_get_info(&tb);
+        if (tb.synced) {
+            printf("Heure: %u s (epoch) | derive %d ppb sur %u synchros | ecart %d ms | "
+                   "prochaine synchro %u s\n\n", timebase_now_s(), tb.drift_ppb, tb.points,
+                   tb.last_step_ms, tb.next_sync_s);
+        } else {
+            printf("Heure: %u s (depuis le demarrage, en attente de synchro CTS)\n\n",
+                   timebase_now_s());
+        }
 
         // Mise à jour des capteurs
+#ifdef CONFIG_ZSWATCH_SENSOR_ASYNC
+        sensor_async_update(&env, &imu, &mag);
+#else
         env_update(&env);
-        motion_update(&imu);
         mag_update(&mag);
+#endif
+#if defined(CONFIG_ZSWATCH_MOTION_FIFO) || !defined(CONFIG_ZSWATCH_SENSOR_ASYNC)
+        motion_update(&imu);
+#endif
+
+        // --- Publication sur le bus : console, BLE, journal, grandeurs dérivées ---
+        sensor_bus_publish(&env, &imu, &mag);
+
+        printf("Echantillons/cycle: IMU %d | Press %d | Magn %d\n\n", n_imu, n_press, n_mag);
+        n_imu = n_press = n_mag = 0;
+
+        // --- Algorithmes : lot du passage, avec leurs lignes console ---
+        sensor_bus_publish_batch(&batch);
+
+#ifdef CONFIG_ZSWATCH_MOTION_EMBEDDED
+        if (hw_pedometer) {
+            printf("Gestes: tap %u | double tap %u | tilt %u | mouvement %u | 6D 0x%02x\n\n",
+                   n_tap, n_double_tap, n_tilt, n_sig_motion, orientation);
+        }
+#endif
+#ifdef CONFIG_ZSWATCH_FALL_DETECT
+        FallInfo fall;
+        fall_detect_get(&fall);
+        printf("Chutes: alertes %u | confirmees %u | releves %u | fausses alertes %u | "
+               "latence %u.%u ms%s\n\n", fall.alerts, fall.confirmed, fall.recovered,
+               fall.false_alarms, fall.last_latency_us / 1000, fall.last_latency_us / 100 % 10,
+               fall.armed ? " | EN COURS" : "");
+#endif
+#ifdef CONFIG_ZSWATCH_DERIVED
+        // Lecture à la demande : seules les grandeurs affichées sont calculées
+        if (active.hts) {
+            int32_t dew = 0, ah = 0, hi = 0;
+
+            derived_get(DERIVED_DEW_POINT, &dew);
+            derived_get(DERIVED_ABS_HUMIDITY, &ah);
+            derived_get(DERIVED_HEAT_INDEX, &hi);
+            printf("Derives: rosee " CENTI_FMT " C | hum. abs. " CENTI_FMT " g/m3 | ressenti "
+                   CENTI_FMT " C\n", CENTI_ARG(dew), CENTI_ARG(ah), CENTI_ARG(hi));
+        }
+        if (active.accel) {
+            int32_t norm = 0, p = 0, r = 0;
+
+            derived_get(DERIVED_ACCEL_NORM, &norm);
+            derived_get(DERIVED_PITCH, &p);
+            derived_get(DERIVED_ROLL, &r);
+            printf("Inclinaison: |a| %d mg | tangage " CENTI_FMT " | roulis " CENTI_FMT " deg\n",
+                   norm, CENTI_ARG(p), CENTI_ARG(r));
+        }
+        printf("\n");
+#endif
+        SensorBusStats bus;
+        sensor_bus_get_stats(&bus);
+        printf("Bus capteurs: %u acquisitions | %u lots | %u echecs de publication\n",
+               bus.published, bus.batches, bus.failed);
+
+#ifdef CONFIG_ZSWATCH_SENSOR_LOG
+        SensorLogStats log_stats;
+        sensor_log_get_stats(&log_stats);
+        // Taux de compression (x10), en-têtes FCB compris
+        uint32_t ratio_10 = log_stats.flash_bytes ?
+                            log_stats.raw_bytes * 10 / log_stats.flash_bytes : 0;
+        printf("Journal: %u enregistrements | %u blocs | %u octets flash (x%u.%u) | %u effacements\n",
+               log_stats.appends, log_stats.blocks, log_stats.flash_bytes,
+               ratio_10 / 10, ratio_10 % 10, log_stats.rotations);
+#endif
+
+        BleTxStats tx;
+        ble_get_tx_stats(&tx);
+        printf("BLE TX: file %u | envoyees %u | fusionnees %u | perdues %u\n",
+               tx.queued, tx.sent, tx.merged, tx.dropped);
+
+        // Compromis énergie / latence : événements de connexion par notification
+        BleLinkInfo link;
+        ble_link_get(&link);
+        uint32_t events = link.conn_events - prev_events;
+        uint32_t sent = tx.sent - prev_sent;
+        uint32_t per_notif_10 = sent ? events * 10 / sent : 0;
+        prev_events = link.conn_events;
+        prev_sent = tx.sent;
+        printf("Lien: intervalle %u.%02u ms | latence %u | maj %u (demandes %u) | evt/notif %u.%u\n\n",
+               link.interval * 125 / 100, link.interval * 125 % 100, link.latency,
+               link.param_updates, link.param_requests,
+               per_notif_10 / 10, per_notif_10 % 10);
+
+#ifdef CONFIG_ZSWATCH_DERIVED
+        // Grandeurs dérivées : lues (donc calculées) seulement pour un abonné
+        if (ble_is_subscribed(BLE_CH_DERIVED)) {
+            int32_t v[DERIVED_COUNT] = { 0 };
+
+            for (int i = 0; i < DERIVED_COUNT; i++) {
+                derived_get(i, &v[i]);
+            }
+            BleDerived d = {
+                .dew_point_100 = (int16_t)v[DERIVED_DEW_POINT],
+                .abs_humidity_100 = (uint16_t)v[DERIVED_ABS_HUMIDITY],
+                .heat_index_100 = (int16_t)v[DERIVED_HEAT_INDEX],
+                .accel_mg = (uint16_t)MIN(v[DERIVED_ACCEL_NORM], UINT16_MAX),
+                .pitch_100 = (int16_t)v[DERIVED_PITCH],
+                .roll_100 = (int16_t)v[DERIVED_ROLL],
+            };
+            ble_update_derived(&d);
+        }
+#endif
 
-        // --- Affichage console ---
-        printf("HTS221 : Temp: %.1f C | Hum: %.1f%%\n",
-               sensor_value_to_double(&env.temp_hts),
-               sensor_value_to_double(&env.humidity));
-        printf("LPS22HH: Press: %.3f kPa | Temp: %.1f C\n\n",
-               sensor_value_to_double(&env.pressure),
-               sensor_value_to_double(&env.temp_lps));
-
-        printf("LSM6DSO: Accel X: %.2f Y: %.2f Z: %.2f\n",
-               sensor_value_to_double(&imu.accel[0]),
-               sensor_value_to_double(&imu.accel[1]),
-               sensor_value_to_double(&imu.accel[2]));
-
-        printf("LIS2MDL: Magn  X: %.3f Y: %.3f Z: %.3f\n",
-               sensor_value_to_double(&mag.magn[0]),
-               sensor_value_to_double(&mag.magn[1]),
-               sensor_value_to_double(&mag.magn[2]));
-
-        // --- Envoi des données via BLE (caractéristiques standard) ---
-
-        // Température HTS221 (°C * 100)
-        ble_update_temperature((int16_t)(sensor_value_to_double(&env.temp_hts) * 100));
-
-        // Humidité (% * 100)
-        ble_update_humidity((uint16_t)(sensor_value_to_double(&env.humidity) * 100));
-
-        // Pression : conversion kPa -> Pa (x1000)
-        ble_update_pressure((uint32_t)(sensor_value_to_double(&env.pressure) * 1000));
-
-        // Accélération (G * 100, à ajuster selon l'unité souhaitée)
-        ble_update_acceleration(
-            (int16_t)(sensor_value_to_double(&imu.accel[0]) * 100),
-            (int16_t)(sensor_value_to_double(&imu.accel[1]) * 100),
-            (int16_t)(sensor_value_to_double(&imu.accel[2]) * 100)
-        );
-
-        // Magnétomètre (µT * 100, à ajuster)
-        ble_update_magnetometer(
-            (int16_t)(sensor_value_to_double(&mag.magn[0]) * 100),
-            (int16_t)(sensor_value_to_double(&mag.magn[1]) * 100),
-            (int16_t)(sensor_value_to_double(&mag.magn[2]) * 100)
-        );
-
-        k_sleep(K_MSEC(2000));
+        k_sleep(K_MSEC(DRAIN_PERIOD_MS));
     }
     return 0;
 }
\ No newline at end of file
@@ -1,20 +1,565 @@
 #include "motion_sensor.h"
 #include <zephyr/device.h>
+#include <zephyr/drivers/i2c.h>
+#include <zephyr/sys/byteorder.h>
 #include <stdio.h>
+#include "timebase.h"
+
+#ifdef CONFIG_ZSWATCH_MOTION_FIFO
+/* ==================== Registres FIFO du LSM6DSO ==================== */
+#define LSM6DSO_FIFO_CTRL1        0x07  // WTM[7:0]
+#define LSM6DSO_FIFO_CTRL2        0x08  // WTM[8]
+#define LSM6DSO_FIFO_CTRL3        0x09  // BDR_GY[7:4] | BDR_XL[3:0]
+#define LSM6DSO_FIFO_CTRL4        0x0A  // FIFO_MODE[2:0]
+#define LSM6DSO_INT1_CTRL         0x0D
+#define LSM6DSO_FIFO_STATUS1      0x3A  // DIFF_FIFO[7:0]
+#define LSM6DSO_FIFO_DATA_OUT_TAG 0x78  // TAG puis X/Y/Z (7 octets par mot)
+
+#define LSM6DSO_BDR_OFF           0x0
+#define LSM6DSO_BDR_208HZ         0x5
+#define LSM6DSO_FIFO_MODE_BYPASS  0x0
+#define LSM6DSO_FIFO_MODE_STREAM  0x6
+#define LSM6DSO_INT1_FIFO_TH      BIT(3)
+
+// Sources d'interruption et routage INT1 (chute libre, fonctions embarquées)
+#define LSM6DSO_ALL_INT_SRC       0x1A  // lecture = acquittement (LIR)
+#define LSM6DSO_TAP_CFG0          0x56
+#define LSM6DSO_TAP_CFG2          0x58
+#define LSM6DSO_FREE_FALL         0x5D  // FF_DUR[4:0] | FF_THS[2:0]
+#define LSM6DSO_MD1_CFG           0x5E
+#define LSM6DSO_FF_IA             BIT(0)  // ALL_INT_SRC
+#define LSM6DSO_LIR               BIT(0)  // TAP_CFG0
+#define LSM6DSO_INTERRUPTS_ENABLE BIT(7)  // TAP_CFG2
+#define LSM6DSO_INT1_FF           BIT(4)  // MD1_CFG
+
+#define LSM6DSO_TAG_GYRO          0x01
+#define LSM6DSO_TAG_ACCEL         0x02
+
+#define FIFO_WORD_SIZE            7
+// Mots lus par rafale : un accéléro + un gyro par échantillon
+#define FIFO_BURST_WORDS          (2 * CONFIG_ZSWATCH_MOTION_FIFO_WATERMARK)
+
+#define MOTION_PERIOD_US          (1000000 / MOTION_ODR_HZ)
+
+static const struct i2c_dt_spec fifo_bus = I2C_DT_SPEC_GET(DT_INST(0, st_lsm6dso));
+static const struct gpio_dt_spec fifo_irq = GPIO_DT_SPEC_GET(DT_INST(0, st_lsm6dso), irq_gpios);
+
+static uint8_t fifo_raw[FIFO_BURST_WORDS * FIFO_WORD_SIZE];
+static MotionSample fifo_samples[FIFO_BURST_WORDS];
+
+#ifdef CONFIG_ZSWATCH_MOTION_EMBEDDED
+/* ==================== Fonctions embarquées du LSM6DSO ==================== */
+// Banque principale
+#define LSM6DSO_FUNC_CFG_ACCESS   0x01  // bit 7 : accès à la banque embarquée
+#define LSM6DSO_TAP_SRC           0x1C
+#define LSM6DSO_D6D_SRC           0x1D
+#define LSM6DSO_EMB_STATUS_MAIN   0x35  // EMB_FUNC_STATUS_MAINPAGE
+#define LSM6DSO_TAP_CFG1          0x57
+#define LSM6DSO_TAP_THS_6D        0x59
+#define LSM6DSO_INT_DUR2          0x5A
+#define LSM6DSO_WAKE_UP_THS       0x5B
+// Banque embarquée
+#define LSM6DSO_EMB_FUNC_EN_A     0x04
+#define LSM6DSO_EMB_FUNC_INT1     0x0A
+#define LSM6DSO_EMB_FUNC_STATUS   0x12  // lecture = acquittement (EMB_FUNC_LIR)
+#define LSM6DSO_PAGE_RW           0x17
+#define LSM6DSO_STEP_COUNTER_L    0x62
+#define LSM6DSO_EMB_FUNC_SRC      0x64  // bit 7 : remise à zéro du compteur de pas
+#define LSM6DSO_EMB_FUNC_INIT_A   0x66
+
+#define LSM6DSO_EMB_PEDO          BIT(3)  // mêmes positions dans EN_A, INT1, STATUS, INIT_A
+#define LSM6DSO_EMB_TILT          BIT(4)
+#define LSM6DSO_EMB_SIGMOT        BIT(5)
+#define LSM6DSO_EMB_ALL           (LSM6DSO_EMB_PEDO | LSM6DSO_EMB_TILT | LSM6DSO_EMB_SIGMOT)
+#define LSM6DSO_EMB_FUNC_LIR      BIT(7)
+
+#define LSM6DSO_TAP_IA            BIT(6)
+#define LSM6DSO_TAP_SINGLE        BIT(5)
+#define LSM6DSO_TAP_DOUBLE        BIT(4)
+#define LSM6DSO_D6D_IA            BIT(6)
+#define LSM6DSO_TAP_THS           (16 / MOTION_ACCEL_FS_G)
+
+/*
+ * Tap sur les 3 axes, seuil 0.5 g (pas de pleine échelle / 32),
+ * simple + double tap ; 6D à 60° ; sources verrouillées (LIR) et
+ * acquittées par lecture. Routage INT1 : fonctions embarquées, tap, 6D.
+ */
+static const uint8_t emb_main_cfg[][2] = {
+    { LSM6DSO_TAP_CFG0,    BIT(6) | BIT(3) | BIT(2) | BIT(1) | BIT(0) },
+    { LSM6DSO_TAP_CFG1,    LSM6DSO_TAP_THS },
+    { LSM6DSO_TAP_CFG2,    LSM6DSO_INTERRUPTS_ENABLE | LSM6DSO_TAP_THS },
+    { LSM6DSO_TAP_THS_6D,  (0x2 << 5) | LSM6DSO_TAP_THS },
+    { LSM6DSO_INT_DUR2,    0x7F },            // fenêtre double tap, quiet, shock
+    { LSM6DSO_WAKE_UP_THS, BIT(7) },          // simple et double tap
+    { LSM6DSO_MD1_CFG,     BIT(6) | BIT(3) | BIT(2) | BIT(1) },
+};
+
+// Les deux banques partagent les adresses : pas d'accès concurrent au LSM6DSO
+static K_MUTEX_DEFINE(emb_lock);
+
+/* Accès à la banque embarquée (emb_lock tenu) */
+static int emb_bank(bool on)
+{
+    return i2c_reg_write_byte_dt(&fifo_bus, LSM6DSO_FUNC_CFG_ACCESS, on ? BIT(7) : 0);
+}
+
+static int emb_program(void)
+{
+    uint8_t en = 0;
+    int ret;
+
+    for (size_t i = 0; i < ARRAY_SIZE(emb_main_cfg); i++) {
+        if (i2c_reg_write_byte_dt(&fifo_bus, emb_main_cfg[i][0], emb_main_cfg[i][1]) < 0) {
+            return -1;
+        }
+    }
+
+    if (emb_bank(true) < 0) {
+        return -1;
+    }
+    ret = i2c_reg_write_byte_dt(&fifo_bus, LSM6DSO_EMB_FUNC_EN_A, LSM6DSO_EMB_ALL);
+    if (ret == 0) {
+        ret = i2c_reg_write_byte_dt(&fifo_bus, LSM6DSO_EMB_FUNC_INT1, LSM6DSO_EMB_ALL);
+    }
+    if (ret == 0) {
+        ret = i2c_reg_update_byte_dt(&fifo_bus, LSM6DSO_PAGE_RW,
+                                     LSM6DSO_EMB_FUNC_LIR, LSM6DSO_EMB_FUNC_LIR);
+    }
+    if (ret == 0) {
+        ret = i2c_reg_write_byte_dt(&fifo_bus, LSM6DSO_EMB_FUNC_INIT_A, LSM6DSO_EMB_ALL);
+    }
+    if (ret == 0) {
+        ret = i2c_reg_write_byte_dt(&fifo_bus, LSM6DSO_EMB_FUNC_SRC, BIT(7));
+    }
+    // Relecture : un émulateur ou un autre composant ne garde pas la valeur
+    if (ret == 0) {
+        ret = i2c_reg_read_byte_dt(&fifo_bus, LSM6DSO_EMB_FUNC_EN_A, &en);
+    }
+    emb_bank(false);
+
+    return (ret == 0 && en == LSM6DSO_EMB_ALL) ? 0 : -1;
+}
+
+static void emb_start(MotionSensor *s)
+{
+    s->embedded = false;
+    if (IS_ENABLED(CONFIG_EMUL)) {
+        printf("LSM6DSO emule : podometre logiciel\n");
+        return;
+    }
+
+    k_mutex_lock(&emb_lock, K_FOREVER);
+    if (emb_program() == 0) {
+        s->embedded = true;
+        s->hw_steps = 0;
+        atomic_clear(&s->steps);
+        atomic_clear(&s->events);
+    } else {
+        // Moteurs partiellement programmés : on coupe tout
+        emb_bank(true);
+        i2c_reg_write_byte_dt(&fifo_bus, LSM6DSO_EMB_FUNC_EN_A, 0);
+        emb_bank(false);
+        i2c_reg_write_byte_dt(&fifo_bus, LSM6DSO_MD1_CFG, 0);
+        printf("Fonctions embarquees LSM6DSO indisponibles : podometre logiciel\n");
+    }
+    k_mutex_unlock(&emb_lock);
+}
+
+/*
+ * Lit et acquitte les sources d'interruption (work d'INT1).
+ * Retourne ALL_INT_SRC (chute libre, traitée par motion_fifo_drain).
+ */
+static uint8_t emb_poll(MotionSensor *s)
+{
+    uint8_t emb = 0, src[4] = { 0 };
+    uint32_t evt = 0;
+
+    k_mutex_lock(&emb_lock, K_FOREVER);
+    // ALL_INT_SRC .. D6D_SRC en une lecture ; acquitte tap, 6D et chute libre
+    if (i2c_burst_read_dt(&fifo_bus, LSM6DSO_ALL_INT_SRC, src, sizeof(src)) < 0 ||
+        i2c_reg_read_byte_dt(&fifo_bus, LSM6DSO_EMB_STATUS_MAIN, &emb) < 0) {
+        k_mutex_unlock(&emb_lock);
+        return 0;
+    }
+
+    if ((emb & LSM6DSO_EMB_ALL) && emb_bank(true) == 0) {
+        uint8_t ack, cnt[2];
+
+        // Acquitte les fonctions embarquées, puis relit le compteur de pas
+        i2c_reg_read_byte_dt(&fifo_bus, LSM6DSO_EMB_FUNC_STATUS, &ack);
+        if ((emb & LSM6DSO_EMB_PEDO) &&
+            i2c_burst_read_dt(&fifo_bus, LSM6DSO_STEP_COUNTER_L, cnt, sizeof(cnt)) == 0) {
+            uint16_t hw = sys_get_le16(cnt);
+
+            // Compteur 16 bits : l'écart modulo 2^16 reste juste au rebouclage
+            atomic_add(&s->steps, (uint16_t)(hw - s->hw_steps));
+            s->hw_steps = hw;
+            evt |= MOTION_EVT_STEP;
+        }
+        emb_bank(false);
+    }
+    k_mutex_unlock(&emb_lock);
+
+    if (emb & LSM6DSO_EMB_SIGMOT) {
+        evt |= MOTION_EVT_SIG_MOTION;
+    }
+    if (emb & LSM6DSO_EMB_TILT) {
+        evt |= MOTION_EVT_TILT;
+    }
+    uint8_t tap = src[LSM6DSO_TAP_SRC - LSM6DSO_ALL_INT_SRC];
+    if (tap & LSM6DSO_TAP_IA) {
+        evt |= (tap & LSM6DSO_TAP_DOUBLE) ? MOTION_EVT_DOUBLE_TAP : 0;
+        evt |= (tap & LSM6DSO_TAP_SINGLE) ? MOTION_EVT_SINGLE_TAP : 0;
+    }
+    uint8_t d6d = src[LSM6DSO_D6D_SRC - LSM6DSO_ALL_INT_SRC];
+    if (d6d & LSM6DSO_D6D_IA) {
+        atomic_set(&s->orientation, d6d & 0x3F);
+        evt |= MOTION_EVT_6D;
+    }
+    if (evt) {
+        atomic_or(&s->events, evt);
+    }
+    return src[0];
+}
+
+uint32_t motion_take_events(MotionSensor *s, uint8_t *orientation)
+{
+    if (orientation) {
+        *orientation = atomic_get(&s->orientation);
+    }
+    return atomic_clear(&s->events);
+}
+
+uint32_t motion_step_count(const MotionSensor *s)
+{
+    return atomic_get(&s->steps);
+}
+#endif /* CONFIG_ZSWATCH_MOTION_EMBEDDED */
+
+#ifdef CONFIG_ZSWATCH_FALL_DETECT
+/* ==================== Chute libre du LSM6DSO ==================== */
+/*
+ * |a| < 312 mg pendant 6 échantillons (~29 ms à 208 Hz), verrouillée (LIR)
+ * et routée sur INT1 : le work de la FIFO part aussitôt, sans attendre le
+ * seuil de la FIFO.
+ */
+#define LSM6DSO_FF_THS_312MG      0x3
+#define LSM6DSO_FF_DUR            6
+
+static void ff_start(MotionSensor *s)
+{
+    int ret;
+
+    s->free_fall_irq = false;
+    if (IS_ENABLED(CONFIG_EMUL)) {
+        return;
+    }
+
+#ifdef CONFIG_ZSWATCH_MOTION_EMBEDDED
+    k_mutex_lock(&emb_lock, K_FOREVER);
+#endif
+    ret = i2c_reg_write_byte_dt(&fifo_bus, LSM6DSO_FREE_FALL,
+                                (LSM6DSO_FF_DUR << 3) | LSM6DSO_FF_THS_312MG);
+    if (ret == 0) {
+        ret = i2c_reg_update_byte_dt(&fifo_bus, LSM6DSO_TAP_CFG0, LSM6DSO_LIR, LSM6DSO_LIR);
+    }
+    if (ret == 0) {
+        ret = i2c_reg_update_byte_dt(&fifo_bus, LSM6DSO_TAP_CFG2, LSM6DSO_INTERRUPTS_ENABLE,
+                                     LSM6DSO_INTERRUPTS_ENABLE);
+    }
+    if (ret == 0) {
+        ret = i2c_reg_update_byte_dt(&fifo_bus, LSM6DSO_MD1_CFG, LSM6DSO_INT1_FF, LSM6DSO_INT1_FF);
+    }
+#ifdef CONFIG_ZSWATCH_MOTION_EMBEDDED
+    k_mutex_unlock(&emb_lock);
+#endif
+
+    s->free_fall_irq = (ret == 0);
+    if (!s->free_fall_irq) {
+        printf("Interruption chute libre LSM6DSO indisponible : detection logicielle\n");
+    }
+}
+#endif /* CONFIG_ZSWATCH_FALL_DETECT */
+
+/* Vide la FIFO en une ou plusieurs lectures I2C en rafale */
+static void motion_fifo_drain(struct k_work *work)
+{
+    MotionSensor *s = CONTAINER_OF(work, MotionSensor, fifo_work);
+    uint8_t status[2];
+    uint8_t int_src = 0;  // ALL_INT_SRC
+
+#ifdef CONFIG_ZSWATCH_MOTION_EMBEDDED
+    // INT1 partagée : événements embarqués d'abord, puis la FIFO
+    if (s->embedded) {
+        int_src = emb_poll(s);
+    }
+#endif
+#ifdef CONFIG_ZSWATCH_FALL_DETECT
+    // Sans fonctions embarquées, la source de chute libre est acquittée ici
+    if (s->free_fall_irq && !motion_embedded_active(s)) {
+        i2c_reg_read_byte_dt(&fifo_bus, LSM6DSO_ALL_INT_SRC, &int_src);
+    }
+#endif
+    uint32_t evt = (int_src & LSM6DSO_FF_IA) ? MOTION_EVT_FREE_FALL : 0;
+
+    while (1) {
+        if (i2c_burst_read_dt(&fifo_bus, LSM6DSO_FIFO_STATUS1, status, sizeof(status)) < 0) {
+            break;
+        }
+
+        // Gyroscope coupé : un mot accéléro par échantillon
+        bool gyro_on = s->gyro_on;
+        int per_sample = gyro_on ? 2 : 1;
+        uint16_t total = status[0] | ((status[1] & 0x03) << 8);
+        total -= total % per_sample;  // on ne lit que des échantillons complets
+        if (total == 0) {
+            break;
+        }
+
+        /*
+         * Horodatage à rebours depuis le niveau lu une seule fois : le
+         * dernier des total mots est le plus récent, même s'il faut
+         * plusieurs rafales pour les lire (FIFO remplie pendant un blocage).
+         */
+        int64_t now_us = timebase_now_us();
+        int n = total / per_sample;
+        int idx = 0;
+        bool failed = false;
+
+        for (uint16_t done = 0; done < total; ) {
+            uint16_t words = MIN(total - done, FIFO_BURST_WORDS);
+
+            // L'adresse revient automatiquement de 0x7E à 0x78 : une seule transaction
+            if (i2c_burst_read_dt(&fifo_bus, LSM6DSO_FIFO_DATA_OUT_TAG,
+                                  fifo_raw, words * FIFO_WORD_SIZE) < 0) {
+                failed = true;
+                break;
+            }
+            done += words;
+            s->bursts++;
+
+            MotionSample m = { 0 };
+            bool has_xl = false, has_gy = false;
+            int first = idx;
+
+            for (int w = 0; w < words; w++) {
+                const uint8_t *p = &fifo_raw[w * FIFO_WORD_SIZE];
+                uint8_t tag = p[0] >> 3;
+                int16_t *dst;
+
+                if (tag == LSM6DSO_TAG_ACCEL) {
+                    dst = m.accel;
+                    has_xl = true;
+                } else if (tag == LSM6DSO_TAG_GYRO) {
+                    dst = m.gyro;
+                    has_gy = true;
+                } else {
+                    continue;
+                }
+
+                dst[0] = (int16_t)sys_get_le16(&p[1]);
+                dst[1] = (int16_t)sys_get_le16(&p[3]);
+                dst[2] = (int16_t)sys_get_le16(&p[5]);
+
+                if (has_xl && (has_gy || !gyro_on)) {
+                    m.timestamp_us = now_us - (int64_t)(n - 1 - idx) * MOTION_PERIOD_US;
+                    spsc_ring_put(&s->ring, &m);
+                    fifo_samples[idx - first] = m;
+                    has_xl = has_gy = false;
+                    idx++;
+                }
+            }
+
+            // Consommateur à faible latence : dans ce work, avant la boucle principale
+            MotionListener listener = s->listener;
+            if (listener) {
+                listener(fifo_samples, idx - first, evt);
+                evt = 0;
+            }
+        }
+        if (failed) {
+            break;
+        }
+    }
+
+    // Chute libre signalée sans nouvel échantillon dans la FIFO
+    MotionListener listener = s->listener;
+    if (listener && evt) {
+        listener(NULL, 0, evt);
+    }
+
+    gpio_pin_interrupt_configure_dt(&fifo_irq, GPIO_INT_EDGE_TO_ACTIVE);
+    // Seuil de nouveau atteint pendant la lecture : pas de nouveau front
+    if (gpio_pin_get_dt(&fifo_irq) > 0) {
+        k_work_submit(&s->fifo_work);
+    }
+}
+
+static void motion_fifo_irq(const struct device *port, struct gpio_callback *cb,
+                            gpio_port_pins_t pins)
+{
+    MotionSensor *s = CONTAINER_OF(cb, MotionSensor, irq_cb);
+
+    // Lecture I2C impossible en ISR : délégation à la workqueue système
+    gpio_pin_interrupt_configure_dt(&fifo_irq, GPIO_INT_DISABLE);
+    k_work_submit(&s->fifo_work);
+}
+
+static int motion_fifo_start(MotionSensor *s)
+{
+    const uint16_t wtm = FIFO_BURST_WORDS;
+
+    if (!i2c_is_ready_dt(&fifo_bus) || !gpio_is_ready_dt(&fifo_irq)) {
+        return -1;
+    }
+
+    k_work_init(&s->fifo_work, motion_fifo_drain);
+    s->listener = NULL;
+    spsc_ring_init(&s->ring, s->buf, sizeof(MotionSample), MOTION_BUF_LEN);
+    s->bursts = 0;
+
+    // Remise à zéro de la FIFO, puis seuil et débits de batch
+    if (i2c_reg_write_byte_dt(&fifo_bus, LSM6DSO_FIFO_CTRL4, LSM6DSO_FIFO_MODE_BYPASS) < 0 ||
+        i2c_reg_write_byte_dt(&fifo_bus, LSM6DSO_FIFO_CTRL1, wtm & 0xFF) < 0 ||
+        i2c_reg_update_byte_dt(&fifo_bus, LSM6DSO_FIFO_CTRL2, BIT(0), (wtm >> 8) & 0x01) < 0 ||
+        i2c_reg_write_byte_dt(&fifo_bus, LSM6DSO_FIFO_CTRL3,
+                              (LSM6DSO_BDR_208HZ << 4) | LSM6DSO_BDR_208HZ) < 0 ||
+        i2c_reg_update_byte_dt(&fifo_bus, LSM6DSO_INT1_CTRL,
+                               LSM6DSO_INT1_FIFO_TH, LSM6DSO_INT1_FIFO_TH) < 0) {
+        return -1;
+    }
+
+    if (gpio_pin_configure_dt(&fifo_irq, GPIO_INPUT) < 0) {
+        return -1;
+    }
+    gpio_init_callback(&s->irq_cb, motion_fifo_irq, BIT(fifo_irq.pin));
+    if (gpio_add_callback(fifo_irq.port, &s->irq_cb) < 0) {
+        return -1;
+    }
+    if (gpio_pin_interrupt_configure_dt(&fifo_irq, GPIO_INT_EDGE_TO_ACTIVE) < 0) {
+        return -1;
+    }
+
+    return i2c_reg_write_byte_dt(&fifo_bus, LSM6DSO_FIFO_CTRL4, LSM6DSO_FIFO_MODE_STREAM);
+}
+
+/* Batch des seuls blocs actifs ; le passage en bypass vide la FIFO */
+static int motion_fifo_set_bdr(bool accel, bool gyro)
+{
+    uint8_t bdr = ((gyro ? LSM6DSO_BDR_208HZ : LSM6DSO_BDR_OFF) << 4) |
+                  (accel ? LSM6DSO_BDR_208HZ : LSM6DSO_BDR_OFF);
+
+    if (i2c_reg_write_byte_dt(&fifo_bus, LSM6DSO_FIFO_CTRL4, LSM6DSO_FIFO_MODE_BYPASS) < 0 ||
+        i2c_reg_write_byte_dt(&fifo_bus, LSM6DSO_FIFO_CTRL3, bdr) < 0) {
+        return -1;
+    }
+    return i2c_reg_write_byte_dt(&fifo_bus, LSM6DSO_FIFO_CTRL4, LSM6DSO_FIFO_MODE_STREAM);
+}
+
+void motion_set_listener(MotionSensor *s, MotionListener listener)
+{
+    s->listener = listener;
+}
+
+void motion_fifo_kick(MotionSensor *s)
+{
+    k_work_submit(&s->fifo_work);
+}
+
+int motion_fifo_read(MotionSensor *s, MotionSample *out, int max)
+{
+    int n = 0;
+
+    while (n < max && spsc_ring_get(&s->ring, &out[n])) {
+        n++;
+    }
+    if (n > 0) {
+        s->last = out[n - 1];
+    }
+    return n;
+}
+#endif /* CONFIG_ZSWATCH_MOTION_FIFO */
 
 int motion_init(MotionSensor *s) {
     s->dev = DEVICE_DT_GET_ONE(st_lsm6dso);
     if (!device_is_ready(s->dev)) return -1;
-    
+
     // Configuration optionnelle (Fréquence à 208Hz comme dans l'original)
-    struct sensor_value odr = { .val1 = 208, .val2 = 0 };
+    struct sensor_value odr = { .val1 = MOTION_ODR_HZ, .val2 = 0 };
     sensor_attr_set(s->dev, SENSOR_CHAN_ACCEL_XYZ, SENSOR_ATTR_SAMPLING_FREQUENCY, &odr);
+
+    // Pleine échelle : MOTION_ACCEL_UG_PER_LSB en dépend
+    struct sensor_value fs;
+    sensor_g_to_ms2(MOTION_ACCEL_FS_G, &fs);
+    if (sensor_attr_set(s->dev, SENSOR_CHAN_ACCEL_XYZ, SENSOR_ATTR_FULL_SCALE, &fs) < 0) return -1;
+    s->accel_on = true;
+    s->gyro_on = true;
+
+#ifdef CONFIG_ZSWATCH_MOTION_FIFO
+    // Le gyroscope doit aussi tourner pour être batché dans la FIFO
+    sensor_attr_set(s->dev, SENSOR_CHAN_GYRO_XYZ, SENSOR_ATTR_SAMPLING_FREQUENCY, &odr);
+    if (motion_fifo_start(s) != 0) return -1;
+#endif
+#ifdef CONFIG_ZSWATCH_MOTION_EMBEDDED
+    emb_start(s);
+#endif
+#ifdef CONFIG_ZSWATCH_FALL_DETECT
+    ff_start(s);
+#endif
     return 0;
 }
 
+bool motion_embedded_active(const MotionSensor *s) {
+#ifdef CONFIG_ZSWATCH_MOTION_EMBEDDED
+    return s->embedded;
+#else
+    return false;
+#endif
+}
+
 int motion_update(MotionSensor *s) {
+#ifdef CONFIG_ZSWATCH_MOTION_FIFO
+    // Pas de lecture I2C : on expose le dernier échantillon retiré de l'anneau
+    for (int i = 0; i < 3; i++) {
+        sensor_ug_to_ms2(s->last.accel[i] * MOTION_ACCEL_UG_PER_LSB, &s->accel[i]);
+        sensor_10udegrees_to_rad(s->last.gyro[i] * MOTION_GYRO_10UDPS_PER_LSB, &s->gyro[i]);
+    }
+    return 0;
+#else
+    if (!s->accel_on && !s->gyro_on) return 0;
     if (sensor_sample_fetch(s->dev) < 0) return -1;
     sensor_channel_get(s->dev, SENSOR_CHAN_ACCEL_XYZ, s->accel);
     sensor_channel_get(s->dev, SENSOR_CHAN_GYRO_XYZ, s->gyro);
     return 0;
-}
\ No newline at end of file
+#endif
+}
+
+int motion_set_active(MotionSensor *s, bool accel, bool gyro) {
+    // ODR 0 = power-down du bloc
+    struct sensor_value xl_odr = { .val1 = accel ? MOTION_ODR_HZ : 0, .val2 = 0 };
+    struct sensor_value gy_odr = { .val1 = gyro ? MOTION_ODR_HZ : 0, .val2 = 0 };
+    int ret = 0;
+
+#ifdef CONFIG_ZSWATCH_MOTION_EMBEDDED
+    // Fonctions embarquées : accéléro maintenu à bas débit, FIFO coupée
+    if (s->embedded && !accel) {
+        xl_odr.val1 = MOTION_EMB_ODR_HZ;
+    }
+    k_mutex_lock(&emb_lock, K_FOREVER);
+#endif
+    if (sensor_attr_set(s->dev, SENSOR_CHAN_ACCEL_XYZ, SENSOR_ATTR_SAMPLING_FREQUENCY, &xl_odr) < 0 ||
+        sensor_attr_set(s->dev, SENSOR_CHAN_GYRO_XYZ, SENSOR_ATTR_SAMPLING_FREQUENCY, &gy_odr) < 0) {
+        ret = -1;
+    }
+    if (ret == 0) {
+        s->accel_on = accel;
+        s->gyro_on = gyro;
+#ifdef CONFIG_ZSWATCH_MOTION_FIFO
+        ret = motion_fifo_set_bdr(accel, gyro);
+#endif
+    }
+#ifdef CONFIG_ZSWATCH_MOTION_EMBEDDED
+    k_mutex_unlock(&emb_lock);
+#endif
+    return ret;
+}
@@ -1,15 +1,131 @@
-            #ifndef MOTION_SENSOR_H
+#ifndef MOTION_SENSOR_H
 #define MOTION_SENSOR_H
 
+#include <zephyr/kernel.h>
 #include <zephyr/drivers/sensor.h>
+#include <zephyr/drivers/gpio.h>
+#include "spsc_ring.h"
+
+// Fréquence d'échantillonnage accéléro/gyro (Hz)
+#define MOTION_ODR_HZ 208
+
+// Pleine échelle accéléro : ±4 g pour mesurer les impacts de chute
+#ifdef CONFIG_ZSWATCH_FALL_DETECT
+#define MOTION_ACCEL_FS_G           4
+#else
+#define MOTION_ACCEL_FS_G           2
+#endif
+
+// Sensibilités (±MOTION_ACCEL_FS_G, ±250 dps)
+#define MOTION_ACCEL_UG_PER_LSB     (61 * MOTION_ACCEL_FS_G / 2)  // µg / LSB
+#define MOTION_GYRO_10UDPS_PER_LSB  875  // 10 µdps / LSB (8.75 mdps)
+
+// ODR minimal des moteurs embarqués quand aucun échantillon brut n'est demandé
+#define MOTION_EMB_ODR_HZ 26
+
+// Événements des moteurs embarqués (motion_take_events)
+#define MOTION_EVT_STEP        BIT(0)
+#define MOTION_EVT_SIG_MOTION  BIT(1)
+#define MOTION_EVT_TILT        BIT(2)
+#define MOTION_EVT_SINGLE_TAP  BIT(3)
+#define MOTION_EVT_DOUBLE_TAP  BIT(4)
+#define MOTION_EVT_6D          BIT(5)
+// Chute libre (INT1), remise au MotionListener seulement
+#define MOTION_EVT_FREE_FALL   BIT(6)
+
+// Tampon d'échantillons horodatés (puissance de 2, ~2.4 s à 208 Hz)
+#define MOTION_BUF_LEN 512
+
+typedef struct {
+    int64_t timestamp_us;  // instant d'acquisition (k_uptime, µs)
+    int16_t accel[3];      // brut, LSB
+    int16_t gyro[3];       // brut, LSB
+} MotionSample;
+
+/*
+ * Appelé par le work de la FIFO à chaque rafale (samples du plus ancien au
+ * plus récent, déjà dans l'anneau) ; events : MOTION_EVT_FREE_FALL. Doit
+ * rester court : il retarde la lecture suivante.
+ */
+typedef void (*MotionListener)(const MotionSample *samples, int n, uint32_t events);
 
 typedef struct {
     const struct device *dev;
     struct sensor_value accel[3];
     struct sensor_value gyro[3];
+    bool accel_on;  // blocs alimentés (voir motion_set_active)
+    bool gyro_on;
+
+#ifdef CONFIG_ZSWATCH_MOTION_FIFO
+    // Mode FIFO : anneau rempli par la lecture en rafale sur interruption
+    struct k_work fifo_work;
+    struct gpio_callback irq_cb;
+    struct spsc_ring ring;
+    MotionSample buf[MOTION_BUF_LEN];
+    MotionSample last;  // dernier échantillon retiré par le consommateur
+    uint32_t bursts;    // lectures en rafale effectuées
+    MotionListener listener;
+#endif
+#ifdef CONFIG_ZSWATCH_FALL_DETECT
+    bool free_fall_irq;      // chute libre programmée sur INT1
+#endif
+
+#ifdef CONFIG_ZSWATCH_MOTION_EMBEDDED
+    // Moteurs embarqués : remplis par le work d'INT1, lus par la boucle principale
+    bool embedded;           // programmés (sinon repli sur le podomètre logiciel)
+    atomic_t events;         // MOTION_EVT_* en attente
+    atomic_t orientation;    // dernier D6D_SRC (bits ZH ZL YH YL XH XL)
+    atomic_t steps;          // compteur matériel étendu à 32 bits
+    uint16_t hw_steps;       // dernière valeur du compteur 16 bits
+#endif
 } MotionSensor;
 
 int motion_init(MotionSensor *s);
 int motion_update(MotionSensor *s);
 
-#endif
\ No newline at end of file
+/**
+ * @brief Met en marche (MOTION_ODR_HZ) ou en power-down chaque bloc du LSM6DSO.
+ *        En mode FIFO, seuls les blocs actifs sont batchés.
+ */
+int motion_set_active(MotionSensor *s, bool accel, bool gyro);
+
+/* Accesseurs entiers (sans double) */
+void motion_accel_centi(const MotionSensor *s, int16_t out[3]); // m/s² * 100
+void motion_gyro_centi(const MotionSensor *s, int16_t out[3]);  // rad/s * 100
+
+#ifdef CONFIG_ZSWATCH_MOTION_FIFO
+/**
+ * @brief Récupère jusqu'à max échantillons du tampon (du plus ancien au plus récent).
+ *        Un seul consommateur ; motion_update() expose ensuite le dernier retiré.
+ * @return nombre d'échantillons copiés dans out
+ */
+int motion_fifo_read(MotionSensor *s, MotionSample *out, int max);
+
+/* Consommateur appelé dans le work de la FIFO (NULL : aucun) */
+void motion_set_listener(MotionSensor *s, MotionListener listener);
+
+/* Vide la FIFO sans attendre son seuil (lecture rapprochée) */
+void motion_fifo_kick(MotionSensor *s);
+#endif
+
+/**
+ * @brief true si podomètre, mouvement significatif, inclinaison, tap et 6D
+ *        tournent dans le LSM6DSO (CONFIG_ZSWATCH_MOTION_EMBEDDED). Sinon
+ *        (désactivé, émulateur, échec de programmation), le podomètre
+ *        logiciel doit être alimenté par la FIFO.
+ */
+bool motion_embedded_active(const MotionSensor *s);
+
+#ifdef CONFIG_ZSWATCH_MOTION_EMBEDDED
+/**
+ * @brief Récupère et efface les événements survenus depuis le dernier appel.
+ * @param orientation dernier état 6D (D6D_SRC), peut être NULL
+ * @return masque MOTION_EVT_*
+ */
+uint32_t motion_take_events(MotionSensor *s, uint8_t *orientation);
+
+/* Pas comptés par le LSM6DSO depuis le démarrage */
+uint32_t motion_step_count(const MotionSensor *s);
+#endif
+
+#endif
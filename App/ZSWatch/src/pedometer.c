@@ -0,0 +1,226 @@
+#include "pedometer.h"
+
+#ifdef CONFIG_ZSWATCH_PEDOMETER
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <string.h>
+
+LOG_MODULE_REGISTER(pedometer, LOG_LEVEL_INF);
+
+// 1 g (LSB, selon la pleine échelle)
+#define G_LSB             (1000000 / MOTION_ACCEL_UG_PER_LSB)
+#define AMP_MIN           (G_LSB / 12)   // ~0.08 g pic-creux minimum
+#define AMP_INIT          (G_LSB / 4)    // moyenne de départ des amplitudes
+#define STEP_MIN_MS       250            // 240 pas/min
+#define STEP_MAX_MS       2000           // au-delà : arrêt
+#define DC_SHIFT          8              // passe-haut : constante ~1.2 s à 208 Hz
+#define LP_SHIFT          2              // passe-bas : ~8 Hz à 208 Hz
+
+// Foulée en % de la taille : marche lente -> course
+#define STRIDE_PCT_WALK   41
+#define STRIDE_PCT_RUN    65
+#define CADENCE_WALK      100
+#define CADENCE_RUN       180
+
+static struct {
+    // Filtres (virgule fixe Q4 / Q2)
+    int32_t dc_q4;
+    int32_t lp_q2;
+    bool primed;
+    // Détection
+    int32_t prev;
+    bool rising;
+    int32_t valley;
+    int32_t amp_avg;
+    uint32_t last_step_ms;
+    uint32_t interval_avg_ms;
+    uint8_t pending;
+    // Compteur matériel (pedometer_feed_steps)
+    bool hw_primed;
+    uint32_t hw_last;
+    // Résultats
+    PedometerInfo info;
+} ped = { .amp_avg = AMP_INIT };
+
+static struct k_spinlock lock;
+
+/* Racine carrée entière (bit à bit, 16 itérations) */
+static uint32_t isqrt32(uint32_t v)
+{
+    uint32_t res = 0;
+    uint32_t bit = 1UL << 30;
+
+    while (bit > v) {
+        bit >>= 2;
+    }
+    while (bit) {
+        if (v >= res + bit) {
+            v -= res + bit;
+            res = (res >> 1) + bit;
+        } else {
+            res >>= 1;
+        }
+        bit >>= 2;
+    }
+    return res;
+}
+
+static uint16_t stride_cm(uint16_t cadence)
+{
+    uint32_t pct;
+
+    if (cadence <= CADENCE_WALK) {
+        pct = STRIDE_PCT_WALK;
+    } else if (cadence >= CADENCE_RUN) {
+        pct = STRIDE_PCT_RUN;
+    } else {
+        pct = STRIDE_PCT_WALK + (cadence - CADENCE_WALK) *
+              (STRIDE_PCT_RUN - STRIDE_PCT_WALK) / (CADENCE_RUN - CADENCE_WALK);
+    }
+    return CONFIG_ZSWATCH_PEDOMETER_HEIGHT_CM * pct / 100;
+}
+
+/* Pic validé par l'amplitude : décide s'il compte comme un pas */
+static void on_peak(uint32_t t_ms, int32_t amp)
+{
+    uint32_t dt = t_ms - ped.last_step_ms;
+
+    if (dt < STEP_MIN_MS) {
+        return;  // rebond du même pas
+    }
+    ped.amp_avg += (amp - ped.amp_avg) >> 2;
+    ped.last_step_ms = t_ms;
+
+    if (dt > STEP_MAX_MS || ped.pending == 0) {
+        // Reprise après un arrêt : il faut de nouveau une série régulière
+        ped.info.walking = false;
+        ped.pending = 1;
+        ped.interval_avg_ms = 0;
+        return;
+    }
+
+    ped.interval_avg_ms = ped.interval_avg_ms ?
+                          ped.interval_avg_ms + (((int32_t)dt - (int32_t)ped.interval_avg_ms) >> 2) : dt;
+    uint16_t cadence = 60000 / ped.interval_avg_ms;
+
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    if (ped.info.walking) {
+        ped.info.steps++;
+        ped.info.distance_cm += stride_cm(cadence);
+    } else if (++ped.pending >= PEDOMETER_CONFIRM_STEPS) {
+        // Série confirmée : les pas en attente comptent aussi
+        ped.info.walking = true;
+        ped.info.steps += ped.pending;
+        ped.info.distance_cm += ped.pending * stride_cm(cadence);
+    }
+    ped.info.cadence_spm = ped.info.walking ? cadence : 0;
+    k_spin_unlock(&lock, key);
+}
+
+static void process(const MotionSample *s)
+{
+    int32_t ax = s->accel[0], ay = s->accel[1], az = s->accel[2];
+    int32_t mag = isqrt32((uint32_t)(ax * ax) + (uint32_t)(ay * ay) + (uint32_t)(az * az));
+    uint32_t t_ms = (uint32_t)(s->timestamp_us / 1000);
+
+    if (!ped.primed) {
+        ped.dc_q4 = mag * 16;
+        ped.primed = true;
+    }
+    ped.dc_q4 += (mag * 16 - ped.dc_q4) >> DC_SHIFT;
+    int32_t hp = mag - (ped.dc_q4 >> 4);
+    ped.lp_q2 += (hp * 4 - ped.lp_q2) >> LP_SHIFT;
+    int32_t v = ped.lp_q2 >> 2;
+
+    if (v > ped.prev) {
+        ped.rising = true;
+    } else if (v < ped.prev) {
+        if (ped.rising) {
+            // Sommet atteint à l'échantillon précédent
+            int32_t amp = ped.prev - ped.valley;
+            int32_t thr = MAX(AMP_MIN, ped.amp_avg / 2);
+
+            if (amp > thr) {
+                on_peak(t_ms, amp);
+            }
+            ped.valley = v;
+        }
+        ped.rising = false;
+        ped.valley = MIN(ped.valley, v);
+    }
+    ped.prev = v;
+
+    // Arrêt : cadence nulle, seuil ramené à sa valeur de départ
+    if (ped.info.walking && t_ms - ped.last_step_ms > STEP_MAX_MS) {
+        k_spinlock_key_t key = k_spin_lock(&lock);
+        ped.info.walking = false;
+        ped.info.cadence_spm = 0;
+        k_spin_unlock(&lock, key);
+        ped.pending = 0;
+        ped.amp_avg = AMP_INIT;
+    }
+}
+
+void pedometer_feed(const MotionSample *samples, int n)
+{
+    for (int i = 0; i < n; i++) {
+        process(&samples[i]);
+    }
+}
+
+void pedometer_feed_steps(uint32_t total, uint32_t t_ms)
+{
+    uint32_t delta = total - ped.hw_last;
+    uint32_t dt = t_ms - ped.last_step_ms;
+
+    if (!ped.hw_primed) {
+        // Pas comptés avant le démarrage (ou le reset) : ignorés
+        ped.hw_primed = true;
+        ped.hw_last = total;
+        ped.last_step_ms = t_ms;
+        return;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    if (delta > 0) {
+        // Le LSM6DSO a déjà filtré les gestes isolés (debounce interne)
+        if (ped.info.walking && dt <= delta * STEP_MAX_MS) {
+            uint32_t interval = dt / delta;
+
+            ped.interval_avg_ms = ped.interval_avg_ms ?
+                ped.interval_avg_ms + (((int32_t)interval - (int32_t)ped.interval_avg_ms) >> 2) :
+                interval;
+        }
+        uint16_t cadence = ped.interval_avg_ms ? 60000 / MAX(ped.interval_avg_ms, STEP_MIN_MS) : 0;
+
+        ped.info.steps += delta;
+        ped.info.distance_cm += delta * stride_cm(cadence);
+        ped.info.cadence_spm = cadence;
+        ped.info.walking = true;
+        ped.hw_last = total;
+        ped.last_step_ms = t_ms;
+    } else if (ped.info.walking && dt > STEP_MAX_MS) {
+        ped.info.walking = false;
+        ped.info.cadence_spm = 0;
+        ped.interval_avg_ms = 0;
+    }
+    k_spin_unlock(&lock, key);
+}
+
+void pedometer_get(PedometerInfo *info)
+{
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    *info = ped.info;
+    k_spin_unlock(&lock, key);
+}
+
+void pedometer_reset(void)
+{
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    memset(&ped, 0, sizeof(ped));
+    ped.amp_avg = AMP_INIT;
+    k_spin_unlock(&lock, key);
+}
+
+#endif /* CONFIG_ZSWATCH_PEDOMETER */
@@ -0,0 +1,42 @@
+#ifndef PEDOMETER_H
+#define PEDOMETER_H
+
+#include <stdbool.h>
+#include "motion_sensor.h"
+
+/*
+ * Podomètre logiciel sur le flux accéléromètre pleine cadence (FIFO).
+ * Entiers uniquement, O(1) par échantillon :
+ *   norme |a| -> passe-haut (retrait de la gravité) -> passe-bas ~8 Hz
+ *   -> détection de pics (amplitude pic-creux > seuil adaptatif,
+ *   intervalle 250 ms .. 2 s) -> validation après PEDOMETER_CONFIRM_STEPS
+ *   pas réguliers, pour ignorer les gestes isolés.
+ */
+#define PEDOMETER_CONFIRM_STEPS 4
+
+typedef struct {
+    uint32_t steps;
+    uint16_t cadence_spm;   // pas par minute (0 à l'arrêt)
+    uint32_t distance_cm;   // longueur de foulée selon taille et cadence
+    bool walking;
+} PedometerInfo;
+
+/**
+ * @brief Traite des échantillons (du plus ancien au plus récent).
+ *        Un seul appelant (boucle principale).
+ */
+void pedometer_feed(const MotionSample *samples, int n);
+
+/**
+ * @brief Variante pour le podomètre matériel du LSM6DSO : total cumulé
+ *        (motion_step_count) et instant de lecture. La cadence est
+ *        déduite du nombre de pas entre deux lectures.
+ */
+void pedometer_feed_steps(uint32_t total, uint32_t t_ms);
+
+void pedometer_get(PedometerInfo *info);
+
+/* Remet compteurs et filtres à zéro */
+void pedometer_reset(void);
+
+#endif
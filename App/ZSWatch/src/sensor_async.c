@@ -0,0 +1,209 @@
+#include "sensor_async.h"
+
+#ifdef CONFIG_ZSWATCH_SENSOR_ASYNC
+
+#include <zephyr/device.h>
+#include <zephyr/rtio/rtio.h>
+#include <zephyr/drivers/sensor_data_types.h>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(sensor_async, LOG_LEVEL_INF);
+
+/* ==================== Requêtes de lecture (iodev) ==================== */
+SENSOR_DT_READ_IODEV(hts221_iodev, DT_INST(0, st_hts221),
+                     {SENSOR_CHAN_AMBIENT_TEMP, 0}, {SENSOR_CHAN_HUMIDITY, 0});
+/* Les capteurs en mode trigger sont lus par leur handler data-ready */
+#ifndef CONFIG_LPS22HH_TRIGGER
+SENSOR_DT_READ_IODEV(lps22hh_iodev, DT_INST(0, st_lps22hh),
+                     {SENSOR_CHAN_PRESS, 0}, {SENSOR_CHAN_AMBIENT_TEMP, 0});
+#endif
+#ifndef CONFIG_LIS2MDL_TRIGGER
+SENSOR_DT_READ_IODEV(lis2mdl_iodev, DT_INST(0, st_lis2mdl),
+                     {SENSOR_CHAN_MAGN_XYZ, 0});
+#endif
+#ifndef CONFIG_ZSWATCH_MOTION_FIFO
+SENSOR_DT_READ_IODEV(lsm6dso_iodev, DT_INST(0, st_lsm6dso),
+                     {SENSOR_CHAN_ACCEL_XYZ, 0}, {SENSOR_CHAN_GYRO_XYZ, 0});
+#endif
+
+enum {
+    ASYNC_HTS221,
+#ifndef CONFIG_LPS22HH_TRIGGER
+    ASYNC_LPS22HH,
+#endif
+#ifndef CONFIG_LIS2MDL_TRIGGER
+    ASYNC_LIS2MDL,
+#endif
+#ifndef CONFIG_ZSWATCH_MOTION_FIFO
+    ASYNC_LSM6DSO,
+#endif
+    ASYNC_COUNT,
+};
+
+static const struct rtio_iodev *const iodevs[ASYNC_COUNT] = {
+    [ASYNC_HTS221] = &hts221_iodev,
+#ifndef CONFIG_LPS22HH_TRIGGER
+    [ASYNC_LPS22HH] = &lps22hh_iodev,
+#endif
+#ifndef CONFIG_LIS2MDL_TRIGGER
+    [ASYNC_LIS2MDL] = &lis2mdl_iodev,
+#endif
+#ifndef CONFIG_ZSWATCH_MOTION_FIFO
+    [ASYNC_LSM6DSO] = &lsm6dso_iodev,
+#endif
+};
+
+// Un bloc mémoire par capteur et par cycle
+RTIO_DEFINE_WITH_MEMPOOL(sensor_rtio, ASYNC_COUNT, ASYNC_COUNT, ASYNC_COUNT * 2, 64, 4);
+
+/* ==================== Décodage ==================== */
+static void q31_to_sensor_value(q31_t q, int8_t shift, struct sensor_value *v)
+{
+    int64_t micro = (int64_t)q * 1000000;
+
+    micro = (shift <= 31) ? (micro >> (31 - shift)) : (micro << (shift - 31));
+    sensor_value_from_micro(v, micro);
+}
+
+static int decode_q31(const struct sensor_decoder_api *decoder, const uint8_t *buf,
+                      enum sensor_channel chan, struct sensor_value *out)
+{
+    struct sensor_q31_data data;
+    uint32_t fit = 0;
+
+    if (decoder->decode(buf, (struct sensor_chan_spec){chan, 0}, &fit, 1, &data) <= 0) {
+        return -1;
+    }
+    q31_to_sensor_value(data.readings[0].value, data.shift, out);
+    return 0;
+}
+
+static int decode_xyz(const struct sensor_decoder_api *decoder, const uint8_t *buf,
+                      enum sensor_channel chan, struct sensor_value out[3])
+{
+    struct sensor_three_axis_data data;
+    uint32_t fit = 0;
+
+    if (decoder->decode(buf, (struct sensor_chan_spec){chan, 0}, &fit, 1, &data) <= 0) {
+        return -1;
+    }
+    for (int i = 0; i < 3; i++) {
+        q31_to_sensor_value(data.readings[0].values[i], data.shift, &out[i]);
+    }
+    return 0;
+}
+
+static int decode_one(int id, const uint8_t *buf,
+                      EnvSensor *env, MotionSensor *imu, MagSensor *mag)
+{
+    const struct device *dev;
+    const struct sensor_decoder_api *decoder;
+
+    switch (id) {
+    case ASYNC_HTS221:  dev = env->hts221;  break;
+#ifndef CONFIG_LPS22HH_TRIGGER
+    case ASYNC_LPS22HH: dev = env->lps22hh; break;
+#endif
+#ifndef CONFIG_LIS2MDL_TRIGGER
+    case ASYNC_LIS2MDL: dev = mag->dev;     break;
+#endif
+#ifndef CONFIG_ZSWATCH_MOTION_FIFO
+    case ASYNC_LSM6DSO: dev = imu->dev;     break;
+#endif
+    default: return -1;
+    }
+
+    if (sensor_get_decoder(dev, &decoder) != 0) {
+        return -1;
+    }
+
+    switch (id) {
+    case ASYNC_HTS221:
+        if (decode_q31(decoder, buf, SENSOR_CHAN_AMBIENT_TEMP, &env->temp_hts) != 0) return -1;
+        return decode_q31(decoder, buf, SENSOR_CHAN_HUMIDITY, &env->humidity);
+#ifndef CONFIG_LPS22HH_TRIGGER
+    case ASYNC_LPS22HH:
+        if (decode_q31(decoder, buf, SENSOR_CHAN_PRESS, &env->pressure) != 0) return -1;
+        return decode_q31(decoder, buf, SENSOR_CHAN_AMBIENT_TEMP, &env->temp_lps);
+#endif
+#ifndef CONFIG_LIS2MDL_TRIGGER
+    case ASYNC_LIS2MDL:
+        return decode_xyz(decoder, buf, SENSOR_CHAN_MAGN_XYZ, mag->magn);
+#endif
+#ifndef CONFIG_ZSWATCH_MOTION_FIFO
+    case ASYNC_LSM6DSO:
+        if (decode_xyz(decoder, buf, SENSOR_CHAN_ACCEL_XYZ, imu->accel) != 0) return -1;
+        return decode_xyz(decoder, buf, SENSOR_CHAN_GYRO_XYZ, imu->gyro);
+#endif
+    default:
+        return -1;
+    }
+}
+
+/* Capteurs en power-down ou sans consommateur : pas de requête */
+static bool is_active(int id, const EnvSensor *env, const MotionSensor *imu, const MagSensor *mag)
+{
+    switch (id) {
+    case ASYNC_HTS221:  return env->hts_active;
+#ifndef CONFIG_LPS22HH_TRIGGER
+    case ASYNC_LPS22HH: return env->press_active;
+#endif
+#ifndef CONFIG_LIS2MDL_TRIGGER
+    case ASYNC_LIS2MDL: return mag->active;
+#endif
+#ifndef CONFIG_ZSWATCH_MOTION_FIFO
+    case ASYNC_LSM6DSO: return imu->accel_on || imu->gyro_on;
+#endif
+    default: return false;
+    }
+}
+
+/* ==================== Acquisition ==================== */
+int sensor_async_update(EnvSensor *env, MotionSensor *imu, MagSensor *mag)
+{
+    int submitted = 0;
+    int ret = 0;
+
+    /*
+     * Toutes les requêtes partent ensemble et le bus les enchaîne sans
+     * aller-retour par l'appelant ; l'appel reste bloquant jusqu'à la
+     * dernière complétion (les valeurs sont utilisées juste après).
+     */
+    for (int i = 0; i < ASYNC_COUNT; i++) {
+        if (!is_active(i, env, imu, mag)) {
+            continue;
+        }
+        if (sensor_read_async_mempool(iodevs[i], &sensor_rtio, (void *)(intptr_t)i) < 0) {
+            LOG_ERR("Soumission %d échouée", i);
+            ret = -1;
+            continue;
+        }
+        submitted++;
+    }
+
+    for (int i = 0; i < submitted; i++) {
+        struct rtio_cqe *cqe = rtio_cqe_consume_block(&sensor_rtio);
+        int id = (int)(intptr_t)cqe->userdata;
+        int result = cqe->result;
+        uint8_t *buf = NULL;
+        uint32_t buf_len = 0;
+
+        int err = rtio_cqe_get_mempool_buffer(&sensor_rtio, cqe, &buf, &buf_len);
+        rtio_cqe_release(&sensor_rtio, cqe);
+
+        if (result < 0 || err != 0) {
+            LOG_ERR("Lecture %d échouée (%d)", id, result < 0 ? result : err);
+            ret = -1;
+        } else if (decode_one(id, buf, env, imu, mag) != 0) {
+            ret = -1;
+        }
+        // Bloc rendu aussi en cas d'erreur : le pool ne compte que ASYNC_COUNT * 2 blocs
+        if (buf != NULL) {
+            rtio_release_buffer(&sensor_rtio, buf, buf_len);
+        }
+    }
+
+    return ret;
+}
+
+#endif /* CONFIG_ZSWATCH_SENSOR_ASYNC */
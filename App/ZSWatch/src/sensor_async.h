@@ -0,0 +1,20 @@
+#ifndef SENSOR_ASYNC_H
+#define SENSOR_ASYNC_H
+
+#include "env_sensor.h"
+#include "motion_sensor.h"
+#include "mag_sensor.h"
+
+/**
+ * @brief Acquisition asynchrone (RTIO) de tous les capteurs IKS01A3.
+ *
+ * Les lectures sont soumises ensemble puis récupérées dans la file de
+ * complétion. L'appel attend la dernière complétion : il reste bloquant,
+ * mais n'enchaîne plus les fetch un à un. Les valeurs décodées remplissent
+ * les mêmes champs que env_update(), motion_update() et mag_update(). Les capteurs désactivés
+ * (env_set_active(), motion_set_active(), mag_set_active()) sont ignorés.
+ * @return 0 si toutes les lectures ont abouti, -1 sinon
+ */
+int sensor_async_update(EnvSensor *env, MotionSensor *imu, MagSensor *mag);
+
+#endif
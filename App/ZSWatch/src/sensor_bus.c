@@ -0,0 +1,117 @@
+#include "sensor_bus.h"
+#include <zephyr/logging/log.h>
+#include "timebase.h"
+
+LOG_MODULE_REGISTER(sensor_bus, LOG_LEVEL_INF);
+
+// Attente du verrou du canal et des files des subscribers
+#define PUB_TIMEOUT K_MSEC(5)
+
+/* Observateurs ajoutés par chaque consommateur (ZBUS_CHAN_ADD_OBS) */
+ZBUS_CHAN_DEFINE(sensor_env_chan, SensorEnvMsg, NULL, NULL, ZBUS_OBSERVERS_EMPTY,
+                 ZBUS_MSG_INIT(0));
+ZBUS_CHAN_DEFINE(sensor_motion_chan, SensorMotionMsg, NULL, NULL, ZBUS_OBSERVERS_EMPTY,
+                 ZBUS_MSG_INIT(0));
+ZBUS_CHAN_DEFINE(sensor_mag_chan, SensorMagMsg, NULL, NULL, ZBUS_OBSERVERS_EMPTY,
+                 ZBUS_MSG_INIT(0));
+ZBUS_CHAN_DEFINE(sensor_batch_chan, SensorBatchMsg, NULL, NULL, ZBUS_OBSERVERS_EMPTY,
+                 ZBUS_MSG_INIT(0));
+
+static uint32_t seq;
+static uint32_t batch_seq;
+static SensorBusStats stats;
+static struct k_spinlock lock;
+
+static int publish(const struct zbus_channel *chan, SensorMsgHeader *hdr, const void *msg)
+{
+    hdr->pub_cycles = k_cycle_get_32();
+    int ret = zbus_chan_pub(chan, msg, PUB_TIMEOUT);
+
+    if (ret != 0) {
+        LOG_WRN("Publication %s : erreur %d", zbus_chan_name(chan), ret);
+    }
+    return ret;
+}
+
+/* Horodatage de l'échantillon, ou instant de publication s'il n'en a pas */
+static int64_t sample_us(int64_t timestamp_us)
+{
+    return timestamp_us > 0 ? timestamp_us : timebase_now_us();
+}
+
+int sensor_bus_publish(const EnvSensor *env, const MotionSensor *imu, const MagSensor *mag)
+{
+    SensorMsgHeader hdr = { .seq = ++seq };
+    SensorEnvMsg e = { .hdr = hdr, .hts_valid = env->hts_active, .press_valid = env->press_active };
+    SensorMotionMsg m = { .hdr = hdr, .valid = imu->accel_on, .gyro_valid = imu->gyro_on };
+    SensorMagMsg g = { .hdr = hdr, .valid = mag->active };
+    int err = 0;
+
+    // HTS221 lu à l'instant par env_update() : seule la pression porte un horodatage
+    e.hdr.timestamp_us = sample_us(e.press_valid ? env->press_us : 0);
+#ifdef CONFIG_ZSWATCH_MOTION_FIFO
+    m.hdr.timestamp_us = sample_us(imu->last.timestamp_us);
+#else
+    m.hdr.timestamp_us = timebase_now_us();
+#endif
+    g.hdr.timestamp_us = sample_us(mag->magn_us);
+
+    // Conversion entière (pas de double : FPU simple précision), capteurs actifs seulement
+    if (e.hts_valid) {
+        e.temp_100 = env_temp_centi(env);
+        e.humi_100 = env_humidity_centi(env);
+    }
+    if (e.press_valid) {
+        e.pressure_pa = env_pressure_pa(env);
+        e.temp_lps_100 = env_temp_lps_centi(env);
+    }
+    if (m.valid) {
+        motion_accel_centi(imu, m.accel_100);
+    }
+    if (g.valid) {
+        mag_magn_centi(mag, g.mag_100);
+    }
+
+    err |= publish(&sensor_env_chan, &e.hdr, &e);
+    err |= publish(&sensor_motion_chan, &m.hdr, &m);
+    err |= publish(&sensor_mag_chan, &g.hdr, &g);
+
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    stats.published++;
+    stats.failed += (err != 0);
+    k_spin_unlock(&lock, key);
+    return err ? -1 : 0;
+}
+
+int sensor_bus_publish_batch(SensorBatchMsg *batch)
+{
+    int64_t newest = 0;
+
+    // Échantillon le plus récent du lot, toutes sources confondues
+    if (batch->n_imu > 0) {
+        newest = MAX(newest, batch->imu[batch->n_imu - 1].timestamp_us);
+    }
+    if (batch->n_press > 0) {
+        newest = MAX(newest, batch->press[batch->n_press - 1].timestamp_us);
+    }
+    if (batch->n_mag > 0) {
+        newest = MAX(newest, batch->mag[batch->n_mag - 1].timestamp_us);
+    }
+    batch->hdr.seq = ++batch_seq;
+    batch->hdr.timestamp_us = sample_us(newest);
+
+    int err = publish(&sensor_batch_chan, &batch->hdr, batch);
+
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    stats.batches++;
+    stats.failed += (err != 0);
+    k_spin_unlock(&lock, key);
+    return err;
+}
+
+void sensor_bus_get_stats(SensorBusStats *out)
+{
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    *out = stats;
+    k_spin_unlock(&lock, key);
+}
@@ -0,0 +1,123 @@
+#ifndef SENSOR_BUS_H
+#define SENSOR_BUS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <zephyr/kernel.h>
+#include <zephyr/zbus/zbus.h>
+#include "env_sensor.h"
+#include "motion_sensor.h"
+#include "mag_sensor.h"
+
+/*
+ * Bus de données capteurs (zbus) : un canal et un message typé par bloc
+ * capteur, publiés à chaque acquisition par sensor_bus_publish(), dans
+ * l'ordre env, motion, mag (même seq sur les trois).
+ *
+ * Les lots pleine cadence vidés des anneaux à chaque passage de la boucle
+ * principale (~100 ms) partent sur sensor_batch_chan : les algorithmes
+ * (podomètre, activité, altimètre, météo, fusion, boussole) s'y attachent
+ * comme listeners, chacun dans son fichier bus_*.c.
+ *
+ * Un consommateur s'attache depuis son propre fichier, sans toucher à
+ * main.c : ZBUS_CHAN_ADD_OBS(sensor_env_chan, mon_observateur, prio).
+ *   - listener (ZBUS_LISTENER_DEFINE) : appelé dans le thread qui publie,
+ *     message lu en place par zbus_chan_const_msg() ; doit rester court ;
+ *   - subscriber (ZBUS_SUBSCRIBER_DEFINE(nom, profondeur)) : thread propre,
+ *     file de notifications de la profondeur choisie, dernière valeur lue
+ *     par zbus_chan_read() ; cadence libre (décimation côté consommateur).
+ */
+
+// Ordre de notification des observateurs (croissant)
+#define SENSOR_BUS_PRIO_CONSOLE  1
+#define SENSOR_BUS_PRIO_DERIVED  2
+#define SENSOR_BUS_PRIO_BLE      3
+#define SENSOR_BUS_PRIO_LOG      4
+
+// sensor_batch_chan : calibration magnétomètre avant la fusion qui l'applique
+#define SENSOR_BUS_PRIO_CALIB    1
+#define SENSOR_BUS_PRIO_ALGO     2
+
+// Threads des subscribers : préemptibles, moins prioritaires que main
+#define SENSOR_BUS_THREAD_PRIO   7
+
+typedef struct {
+    uint32_t seq;           // numéro d'acquisition
+    int64_t timestamp_us;   // timebase_now_us() de l'échantillon le plus récent
+    uint32_t pub_cycles;    // k_cycle_get_32() à la publication (latence)
+} SensorMsgHeader;
+
+typedef struct {
+    SensorMsgHeader hdr;
+    bool hts_valid;         // false : HTS221 non lu (veille)
+    bool press_valid;       // false : LPS22HH en power-down
+    int16_t temp_100;       // °C * 100
+    uint16_t humi_100;      // %HR * 100
+    uint32_t pressure_pa;
+    int16_t temp_lps_100;   // LPS22HH, °C * 100
+} SensorEnvMsg;
+
+typedef struct {
+    SensorMsgHeader hdr;
+    bool valid;             // accéléromètre alimenté
+    bool gyro_valid;
+    int16_t accel_100[3];   // m/s² * 100
+} SensorMotionMsg;
+
+typedef struct {
+    SensorMsgHeader hdr;
+    bool valid;
+    int16_t mag_100[3];     // gauss * 100
+} SensorMagMsg;
+
+/*
+ * Lot pleine cadence : échantillons retirés des anneaux depuis le lot
+ * précédent, du plus ancien au plus récent. Les pointeurs désignent les
+ * tampons de la boucle principale et ne valent que pendant la publication :
+ * listeners seulement (pas de subscriber, pas de copie gardée).
+ */
+typedef struct {
+    SensorMsgHeader hdr;
+    const MotionSample *imu;
+    const EnvSample *press;
+    const MagSample *mag;
+    uint16_t n_imu;
+    uint16_t n_press;
+    uint16_t n_mag;
+    bool accel_on;          // accéléromètre alimenté : échantillons IMU exploitables
+    bool hw_steps_valid;    // podomètre du LSM6DSO actif (hw_steps à jour)
+    uint32_t hw_steps;
+    bool dashboard;         // passage du dashboard : lignes console des algorithmes
+} SensorBatchMsg;
+
+ZBUS_CHAN_DECLARE(sensor_env_chan, sensor_motion_chan, sensor_mag_chan, sensor_batch_chan);
+
+typedef struct {
+    uint32_t published;     // acquisitions publiées
+    uint32_t batches;       // lots pleine cadence publiés
+    uint32_t failed;        // publications en erreur (canal occupé, file pleine)
+} SensorBusStats;
+
+/**
+ * @brief Convertit (entiers, sans double) et publie les trois blocs. Un
+ *        bloc en veille est publié avec valid = false.
+ * @return 0 si les trois publications ont réussi, -1 sinon
+ */
+int sensor_bus_publish(const EnvSensor *env, const MotionSensor *imu, const MagSensor *mag);
+
+/**
+ * @brief Publie un lot pleine cadence (en-tête rempli ici). Les listeners
+ *        s'exécutent dans l'appel : les tampons peuvent être réutilisés au retour.
+ * @return 0, ou l'erreur de zbus_chan_pub()
+ */
+int sensor_bus_publish_batch(SensorBatchMsg *batch);
+
+void sensor_bus_get_stats(SensorBusStats *stats);
+
+/* Latence publication -> consommation (µs) */
+static inline uint32_t sensor_bus_latency_us(const SensorMsgHeader *hdr)
+{
+    return k_cyc_to_us_floor32(k_cycle_get_32() - hdr->pub_cycles);
+}
+
+#endif
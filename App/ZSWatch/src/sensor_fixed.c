@@ -0,0 +1,44 @@
+#include "sensor_fixed.h"
+#include "env_sensor.h"
+#include "motion_sensor.h"
+#include "mag_sensor.h"
+
+/*
+ * Accesseurs entiers des dernières valeurs lues par les drivers
+ * (env_sensor.c, motion_sensor.c, mag_sensor.c). Sans accès au matériel :
+ * compilés tels quels dans les tests unitaires.
+ */
+int16_t env_temp_centi(const EnvSensor *s) {
+    return (int16_t)sensor_value_to_centi(&s->temp_hts);
+}
+
+uint16_t env_humidity_centi(const EnvSensor *s) {
+    return (uint16_t)sensor_value_to_centi(&s->humidity);
+}
+
+uint32_t env_pressure_pa(const EnvSensor *s) {
+    // Le driver fournit des kPa
+    return (uint32_t)sensor_value_to_milli32(&s->pressure);
+}
+
+int16_t env_temp_lps_centi(const EnvSensor *s) {
+    return (int16_t)sensor_value_to_centi(&s->temp_lps);
+}
+
+void motion_accel_centi(const MotionSensor *s, int16_t out[3]) {
+    for (int i = 0; i < 3; i++) {
+        out[i] = (int16_t)sensor_value_to_centi(&s->accel[i]);
+    }
+}
+
+void motion_gyro_centi(const MotionSensor *s, int16_t out[3]) {
+    for (int i = 0; i < 3; i++) {
+        out[i] = (int16_t)sensor_value_to_centi(&s->gyro[i]);
+    }
+}
+
+void mag_magn_centi(const MagSensor *s, int16_t out[3]) {
+    for (int i = 0; i < 3; i++) {
+        out[i] = (int16_t)sensor_value_to_centi(&s->magn[i]);
+    }
+}
@@ -0,0 +1,31 @@
+#ifndef SENSOR_FIXED_H
+#define SENSOR_FIXED_H
+
+#include <zephyr/drivers/sensor.h>
+
+/*
+ * Conversions entières de struct sensor_value (val1 + val2 * 1e-6).
+ * Le FPU du Cortex-M33 est simple précision : sensor_value_to_double()
+ * passe par l'émulation logicielle, ces helpers n'utilisent que des
+ * multiplications / divisions entières 32 bits. Les accesseurs
+ * env_*_centi(), motion_*_centi() et mag_magn_centi() (sensor_fixed.c)
+ * les appliquent aux valeurs des drivers.
+ */
+
+/* Valeur * 100 (ex: 23.456 -> 2345) */
+static inline int32_t sensor_value_to_centi(const struct sensor_value *v)
+{
+    return v->val1 * 100 + v->val2 / 10000;
+}
+
+/* Valeur * 1000 (ex: 101.325 kPa -> 101325 Pa) */
+static inline int32_t sensor_value_to_milli32(const struct sensor_value *v)
+{
+    return v->val1 * 1000 + v->val2 / 1000;
+}
+
+// Affichage d'une valeur * 100 avec deux décimales, sans flottant (abs : stdlib.h)
+#define CENTI_FMT      "%s%d.%02d"
+#define CENTI_ARG(v)   ((v) < 0 ? "-" : ""), abs(v) / 100, abs(v) % 100
+
+#endif
@@ -0,0 +1,387 @@
+#include "sensor_log.h"
+
+#ifdef CONFIG_ZSWATCH_SENSOR_LOG
+
+#include <zephyr/kernel.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/logging/log.h>
+#include <string.h>
+#include "timebase.h"
+
+LOG_MODULE_REGISTER(sensor_log, LOG_LEVEL_INF);
+
+#define SENSOR_LOG_PARTITION   FIXED_PARTITION_ID(sensor_log)
+#define SENSOR_LOG_MAGIC       0x5a534c32  // "ZSL2" : blocs compressés
+#define SENSOR_LOG_VERSION     2
+#define SENSOR_LOG_MAX_SECTORS 32
+#define SECTOR_EMPTY           UINT32_MAX
+
+// Taille d'un enregistrement non compressé : horodatage et flags, puis les champs présents
+#define RECORD_RAW_BASE        5
+#define RECORD_RAW_ENV         4
+#define RECORD_RAW_PRESS       4
+#define RECORD_RAW_AXES        6
+
+#define ENV_MASK    (BIT(SENSOR_LOG_CH_TEMP) | BIT(SENSOR_LOG_CH_HUMI))
+#define PRESS_MASK  BIT(SENSOR_LOG_CH_PRESS)
+#define ACCEL_MASK  (0x7 << SENSOR_LOG_CH_ACCEL)
+#define MAG_MASK    (0x7 << SENSOR_LOG_CH_MAG)
+
+enum {
+    CURSOR_FLASH,   // blocs lus dans la FCB
+    CURSOR_END,     // bloc en cours de remplissage copié, plus rien après
+};
+
+static struct fcb log_fcb;
+static struct flash_sector log_sectors[SENSOR_LOG_MAX_SECTORS];
+
+// Index : horodatage du premier enregistrement de chaque secteur
+static uint32_t sector_first_ts[SENSOR_LOG_MAX_SECTORS];
+static uint32_t last_time_s;
+static uint32_t time_base_s;
+static SensorLogStats stats;
+static bool mounted;
+
+// Bloc en cours de remplissage, écrit en flash une fois plein
+static TsEncoder stage;
+static K_MUTEX_DEFINE(stage_lock);
+
+/* ==================== Enregistrement <-> point ==================== */
+static void record_to_point(const SensorLogRecord *rec, TsPoint *p)
+{
+    memset(p, 0, sizeof(*p));
+    p->time = rec->time_s;
+    if (rec->flags & SENSOR_LOG_HAS_ENV) {
+        p->mask |= ENV_MASK;
+        p->values[SENSOR_LOG_CH_TEMP] = rec->temp_100;
+        p->values[SENSOR_LOG_CH_HUMI] = rec->humi_100;
+    }
+    if (rec->flags & SENSOR_LOG_HAS_PRESS) {
+        p->mask |= PRESS_MASK;
+        p->values[SENSOR_LOG_CH_PRESS] = rec->pressure;
+    }
+    if (rec->flags & SENSOR_LOG_HAS_ACCEL) {
+        p->mask |= ACCEL_MASK;
+        for (int i = 0; i < 3; i++) {
+            p->values[SENSOR_LOG_CH_ACCEL + i] = rec->accel_100[i];
+        }
+    }
+    if (rec->flags & SENSOR_LOG_HAS_MAG) {
+        p->mask |= MAG_MASK;
+        for (int i = 0; i < 3; i++) {
+            p->values[SENSOR_LOG_CH_MAG + i] = rec->mag_100[i];
+        }
+    }
+}
+
+static void point_to_record(const TsPoint *p, SensorLogRecord *rec)
+{
+    memset(rec, 0, sizeof(*rec));
+    rec->time_s = p->time;
+    if ((p->mask & ENV_MASK) == ENV_MASK) {
+        rec->flags |= SENSOR_LOG_HAS_ENV;
+        rec->temp_100 = p->values[SENSOR_LOG_CH_TEMP];
+        rec->humi_100 = p->values[SENSOR_LOG_CH_HUMI];
+    }
+    if (p->mask & PRESS_MASK) {
+        rec->flags |= SENSOR_LOG_HAS_PRESS;
+        rec->pressure = p->values[SENSOR_LOG_CH_PRESS];
+    }
+    if ((p->mask & ACCEL_MASK) == ACCEL_MASK) {
+        rec->flags |= SENSOR_LOG_HAS_ACCEL;
+        for (int i = 0; i < 3; i++) {
+            rec->accel_100[i] = p->values[SENSOR_LOG_CH_ACCEL + i];
+        }
+    }
+    if ((p->mask & MAG_MASK) == MAG_MASK) {
+        rec->flags |= SENSOR_LOG_HAS_MAG;
+        for (int i = 0; i < 3; i++) {
+            rec->mag_100[i] = p->values[SENSOR_LOG_CH_MAG + i];
+        }
+    }
+}
+
+static int block_read(const struct fcb_entry *loc, uint8_t *buf, uint16_t *len)
+{
+    *len = MIN(loc->fe_data_len, TS_BLOCK_MAX);
+    if (flash_area_read(log_fcb.fap, FCB_ENTRY_FA_DATA_OFF((*loc)), buf, *len) < 0) {
+        return -1;
+    }
+    return 0;
+}
+
+static int sector_index(const struct flash_sector *sector)
+{
+    return sector - log_sectors;
+}
+
+/* ==================== Montage ==================== */
+static int log_mount(uint32_t sector_cnt)
+{
+    memset(&log_fcb, 0, sizeof(log_fcb));
+    log_fcb.f_magic = SENSOR_LOG_MAGIC;
+    log_fcb.f_version = SENSOR_LOG_VERSION;
+    log_fcb.f_sectors = log_sectors;
+    log_fcb.f_sector_cnt = sector_cnt;
+    log_fcb.f_scratch_cnt = 0;  // pas de compaction : rotation pure
+    return fcb_init(SENSOR_LOG_PARTITION, &log_fcb);
+}
+
+/* Parcours complet, une seule fois au démarrage */
+static void index_rebuild(void)
+{
+    static uint8_t block[TS_BLOCK_MAX];
+    struct fcb_entry loc = { 0 };
+    TsDecoder dec;
+    TsPoint p;
+    uint16_t len;
+
+    for (int i = 0; i < SENSOR_LOG_MAX_SECTORS; i++) {
+        sector_first_ts[i] = SECTOR_EMPTY;
+    }
+    last_time_s = 0;
+
+    while (fcb_getnext(&log_fcb, &loc) == 0) {
+        if (block_read(&loc, block, &len) != 0 || ts_decoder_init(&dec, block, len) != 0) {
+            continue;
+        }
+        int idx = sector_index(loc.fe_sector);
+
+        while (ts_decoder_next(&dec, &p) == 0) {
+            if (sector_first_ts[idx] == SECTOR_EMPTY) {
+                sector_first_ts[idx] = p.time;
+            }
+            last_time_s = p.time;
+        }
+    }
+}
+
+int sensor_log_init(void)
+{
+    uint32_t cnt = SENSOR_LOG_MAX_SECTORS;
+
+    if (flash_area_get_sectors(SENSOR_LOG_PARTITION, &cnt, log_sectors) < 0) {
+        LOG_ERR("Partition sensor_log introuvable");
+        return -1;
+    }
+
+    if (log_mount(cnt) != 0) {
+        // Partition vierge d'un autre format ou corrompue : on repart de zéro
+        const struct flash_area *fa;
+
+        LOG_WRN("Journal illisible, effacement de la partition");
+        if (flash_area_open(SENSOR_LOG_PARTITION, &fa) < 0) {
+            return -1;
+        }
+        int ret = flash_area_erase(fa, 0, fa->fa_size);
+        flash_area_close(fa);
+        if (ret < 0 || log_mount(cnt) != 0) {
+            return -1;
+        }
+    }
+
+    index_rebuild();
+    ts_encoder_init(&stage);
+    // L'horloge du journal repart après le dernier enregistrement conservé
+    time_base_s = last_time_s ? last_time_s + 1 : 0;
+
+    stats.sectors = cnt;
+    stats.sector_size = log_sectors[0].fs_size;
+    LOG_INF("Journal : %u secteurs de %u octets, dernier horodatage %u s",
+            cnt, stats.sector_size, last_time_s);
+    mounted = true;
+    return 0;
+}
+
+bool sensor_log_ready(void)
+{
+    return mounted;
+}
+
+uint32_t sensor_log_time_s(void)
+{
+    uint32_t now = timebase_is_synced() ? timebase_now_s() :
+                   time_base_s + (uint32_t)(timebase_now_us() / 1000000);
+
+    // Ne recule jamais (recalage CTS en arrière) : seek suppose l'ordre croissant
+    return MAX(now, last_time_s);
+}
+
+/* ==================== Écriture ==================== */
+/* Écrit le bloc en cours comme une entrée FCB (stage_lock tenu) */
+static int stage_flush(void)
+{
+    struct fcb_entry loc;
+    uint16_t len = ts_encoder_size(&stage);
+    int ret;
+
+    if (stage.count == 0) {
+        return 0;
+    }
+
+    ret = fcb_append(&log_fcb, len, &loc);
+    if (ret == -ENOSPC) {
+        // Partition pleine : effacement du secteur le plus ancien
+        int oldest = sector_index(log_fcb.f_oldest);
+
+        if (fcb_rotate(&log_fcb) != 0) {
+            return -1;
+        }
+        sector_first_ts[oldest] = SECTOR_EMPTY;
+        stats.rotations++;
+        ret = fcb_append(&log_fcb, len, &loc);
+    }
+    if (ret != 0) {
+        return -1;
+    }
+
+    // L'entrée n'est valide qu'avec son CRC : une coupure ici la rend invisible.
+    // Le bourrage d'alignement reste dans stage.buf (TS_BLOCK_MAX multiple de 8)
+    uint16_t write_len = ROUND_UP(len, log_fcb.f_align);
+    if (flash_area_write(log_fcb.fap, FCB_ENTRY_FA_DATA_OFF(loc), stage.buf, write_len) < 0 ||
+        fcb_append_finish(&log_fcb, &loc) != 0) {
+        return -1;
+    }
+
+    int idx = sector_index(loc.fe_sector);
+    if (sector_first_ts[idx] == SECTOR_EMPTY) {
+        sector_first_ts[idx] = sys_get_be32(&stage.buf[1]);  // premier horodatage, en clair
+    }
+
+    stats.blocks++;
+    // En-tête de longueur + données + CRC, chacun aligné
+    stats.flash_bytes += (loc.fe_data_off - loc.fe_elem_off) + write_len + log_fcb.f_align;
+    ts_encoder_init(&stage);
+    return 0;
+}
+
+int sensor_log_append(const SensorLogRecord *rec)
+{
+    TsPoint p;
+    int ret = 0;
+
+    record_to_point(rec, &p);
+
+    k_mutex_lock(&stage_lock, K_FOREVER);
+    // Blocs courts : une coupure perd au plus BLOCK_RECORDS enregistrements
+    if (stage.count >= CONFIG_ZSWATCH_SENSOR_LOG_BLOCK_RECORDS) {
+        ret = stage_flush();
+    }
+    if (ret == 0 && ts_encoder_add(&stage, &p) != 0) {
+        ret = stage_flush();
+        if (ret == 0) {
+            ret = ts_encoder_add(&stage, &p);
+        }
+    }
+    if (ret == 0) {
+        last_time_s = rec->time_s;
+        stats.appends++;
+        stats.raw_bytes += RECORD_RAW_BASE +
+                           ((rec->flags & SENSOR_LOG_HAS_ENV) ? RECORD_RAW_ENV : 0) +
+                           ((rec->flags & SENSOR_LOG_HAS_PRESS) ? RECORD_RAW_PRESS : 0) +
+                           ((rec->flags & SENSOR_LOG_HAS_ACCEL) ? RECORD_RAW_AXES : 0) +
+                           ((rec->flags & SENSOR_LOG_HAS_MAG) ? RECORD_RAW_AXES : 0);
+    }
+    k_mutex_unlock(&stage_lock);
+
+    return ret ? -1 : 0;
+}
+
+/* ==================== Lecture ==================== */
+/* Bloc suivant : entrées FCB, puis copie du bloc en cours de remplissage */
+static int cursor_load(SensorLogCursor *c)
+{
+    while (c->state == CURSOR_FLASH) {
+        bool staged = false;
+
+        if (fcb_getnext(&log_fcb, &c->loc) != 0) {
+            // Fin de la flash : copie du bloc en RAM sous verrou, sauf si un
+            // bloc vient d'être écrit entre-temps
+            k_mutex_lock(&stage_lock, K_FOREVER);
+            if (fcb_getnext(&log_fcb, &c->loc) != 0) {
+                c->block_len = ts_encoder_size(&stage);
+                memcpy(c->block, stage.buf, c->block_len);
+                c->state = CURSOR_END;
+                staged = true;
+            }
+            k_mutex_unlock(&stage_lock);
+        }
+        if (!staged && block_read(&c->loc, c->block, &c->block_len) != 0) {
+            continue;
+        }
+        if (ts_decoder_init(&c->dec, c->block, c->block_len) == 0) {
+            c->block_taken = false;
+            return 0;
+        }
+    }
+    c->block_len = 0;
+    return -1;
+}
+
+int sensor_log_seek(uint32_t from_s, SensorLogCursor *c)
+{
+    struct flash_sector *start = NULL;
+    int i = sector_index(log_fcb.f_oldest);
+
+    // Secteurs du plus ancien au plus récent : le dernier commençant avant from_s
+    for (int n = 0; n < log_fcb.f_sector_cnt; n++) {
+        if (sector_first_ts[i] == SECTOR_EMPTY || sector_first_ts[i] > from_s) {
+            break;
+        }
+        start = &log_sectors[i];
+        i = (i + 1) % log_fcb.f_sector_cnt;
+    }
+
+    memset(c, 0, sizeof(*c));
+    c->state = CURSOR_FLASH;
+    c->loc.fe_sector = start ? start : log_fcb.f_oldest;
+
+    // Décodage limité au secteur trouvé (et au suivant si from_s tombe entre deux)
+    while (cursor_load(c) == 0) {
+        TsDecoder before = c->dec;
+        TsPoint p;
+
+        while (ts_decoder_next(&c->dec, &p) == 0) {
+            if (p.time >= from_s) {
+                c->dec = before;  // enregistrement rendu par le prochain sensor_log_next()
+                return 0;
+            }
+            before = c->dec;
+        }
+    }
+    return -1;
+}
+
+int sensor_log_next(SensorLogCursor *c, SensorLogRecord *rec)
+{
+    TsPoint p;
+
+    while (ts_decoder_next(&c->dec, &p) != 0) {
+        if (cursor_load(c) != 0) {
+            return -1;
+        }
+    }
+    point_to_record(&p, rec);
+    return 0;
+}
+
+int sensor_log_next_block(SensorLogCursor *c, const uint8_t **data, uint16_t *len)
+{
+    if ((c->block_taken || c->block_len == 0) && cursor_load(c) != 0) {
+        return -1;
+    }
+    c->block_taken = true;
+    *data = c->block;
+    *len = c->block_len;
+    return 0;
+}
+
+void sensor_log_get_stats(SensorLogStats *out)
+{
+    k_mutex_lock(&stage_lock, K_FOREVER);
+    *out = stats;
+    k_mutex_unlock(&stage_lock);
+}
+
+#endif /* CONFIG_ZSWATCH_SENSOR_LOG */
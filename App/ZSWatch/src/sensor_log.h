@@ -0,0 +1,108 @@
+#ifndef SENSOR_LOG_H
+#define SENSOR_LOG_H
+
+#include <stdbool.h>
+#include <zephyr/types.h>
+#include <zephyr/fs/fcb.h>
+#include "ts_codec.h"
+
+/* Champs optionnels présents dans l'enregistrement */
+#define SENSOR_LOG_HAS_ACCEL BIT(0)
+#define SENSOR_LOG_HAS_MAG   BIT(1)
+#define SENSOR_LOG_HAS_ENV   BIT(2)  // température et humidité (HTS221)
+#define SENSOR_LOG_HAS_PRESS BIT(3)
+
+/*
+ * Voies des blocs compressés (ts_codec.h) : horodatage en s, puis
+ * 0 température, 1 humidité, 2 pression, 3-5 accéléro X/Y/Z, 6-8 magnéto X/Y/Z,
+ * mêmes unités que SensorLogRecord. Chaque voie n'est présente
+ * (masque) que si le capteur tournait.
+ */
+#define SENSOR_LOG_CH_TEMP   0
+#define SENSOR_LOG_CH_HUMI   1
+#define SENSOR_LOG_CH_PRESS  2
+#define SENSOR_LOG_CH_ACCEL  3
+#define SENSOR_LOG_CH_MAG    6
+
+typedef struct {
+    uint32_t time_s;       // horodatage (s, horloge du journal, croissante)
+    uint8_t flags;         // SENSOR_LOG_HAS_*
+    int16_t temp_100;      // °C * 100 (si SENSOR_LOG_HAS_ENV)
+    uint16_t humi_100;     // %HR * 100 (si SENSOR_LOG_HAS_ENV)
+    uint32_t pressure;     // Pa (si SENSOR_LOG_HAS_PRESS)
+    int16_t accel_100[3];  // m/s² * 100 (si SENSOR_LOG_HAS_ACCEL)
+    int16_t mag_100[3];    // gauss * 100 (si SENSOR_LOG_HAS_MAG)
+} SensorLogRecord;
+
+/**
+ * @brief Position de lecture dans le journal (voir sensor_log_seek).
+ *        Contient le bloc courant, décompressé au fil de la lecture.
+ */
+typedef struct {
+    struct fcb_entry loc;
+    uint8_t state;         // flash, bloc en RAM, fin
+    bool block_taken;      // bloc courant déjà rendu par sensor_log_next_block()
+    uint16_t block_len;
+    uint8_t block[TS_BLOCK_MAX];
+    TsDecoder dec;
+} SensorLogCursor;
+
+typedef struct {
+    uint32_t appends;      // enregistrements ajoutés depuis le démarrage
+    uint32_t blocks;       // blocs écrits en flash
+    uint32_t rotations;    // secteurs effacés (usure)
+    uint32_t raw_bytes;    // taille non compressée des enregistrements ajoutés
+    uint32_t flash_bytes;  // octets flash consommés (en-têtes FCB compris)
+    uint16_t sectors;      // secteurs de la partition
+    uint32_t sector_size;
+} SensorLogStats;
+
+/**
+ * @brief Monte le journal circulaire (FCB sur la partition sensor_log) et
+ *        reconstruit l'index des horodatages par secteur.
+ * @return 0 si OK, -1 sinon
+ */
+int sensor_log_init(void);
+
+/* true une fois sensor_log_init() réussi */
+bool sensor_log_ready(void);
+
+/**
+ * @brief Horloge du journal : heure Unix une fois synchronisée (timebase.h),
+ *        sinon reprend après le dernier enregistrement, même après une
+ *        coupure d'alimentation. Jamais décroissante.
+ */
+uint32_t sensor_log_time_s(void);
+
+/**
+ * @brief Ajoute un enregistrement au bloc en cours (O(1)). Le bloc est écrit
+ *        en flash quand il est plein (CONFIG_ZSWATCH_SENSOR_LOG_BLOCK_RECORDS) ;
+ *        le secteur le plus ancien est effacé quand la partition est pleine.
+ * @return 0 si OK, -1 sinon
+ */
+int sensor_log_append(const SensorLogRecord *rec);
+
+/**
+ * @brief Place le curseur sur le premier enregistrement d'horodatage >= from_s.
+ *        Seul le secteur trouvé par l'index est parcouru.
+ * @return 0 si OK, -1 si aucun enregistrement
+ */
+int sensor_log_seek(uint32_t from_s, SensorLogCursor *c);
+
+/**
+ * @brief Lit l'enregistrement courant et avance le curseur.
+ * @return 0 si OK, -1 en fin de journal
+ */
+int sensor_log_next(SensorLogCursor *c, SensorLogRecord *rec);
+
+/**
+ * @brief Rend le bloc compressé courant (après sensor_log_seek) puis les
+ *        suivants, bloc en cours de remplissage compris. Le premier bloc peut
+ *        contenir des enregistrements antérieurs à from_s.
+ * @return 0 si OK, -1 en fin de journal
+ */
+int sensor_log_next_block(SensorLogCursor *c, const uint8_t **data, uint16_t *len);
+
+void sensor_log_get_stats(SensorLogStats *stats);
+
+#endif
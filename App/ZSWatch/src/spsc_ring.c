@@ -0,0 +1,42 @@
+#include "spsc_ring.h"
+#include <string.h>
+
+void spsc_ring_init(struct spsc_ring *r, void *buf, size_t elem_size, uint32_t len)
+{
+    __ASSERT(IS_POWER_OF_TWO(len), "len doit être une puissance de 2");
+
+    r->buf = buf;
+    r->elem_size = elem_size;
+    r->len = len;
+    atomic_set(&r->head, 0);
+    atomic_set(&r->tail, 0);
+    atomic_set(&r->dropped, 0);
+}
+
+bool spsc_ring_put(struct spsc_ring *r, const void *elem)
+{
+    uint32_t head = atomic_get(&r->head);
+
+    if (head - (uint32_t)atomic_get(&r->tail) == r->len) {
+        atomic_inc(&r->dropped);
+        return false;
+    }
+
+    memcpy(&r->buf[(head & (r->len - 1)) * r->elem_size], elem, r->elem_size);
+    // Publication après la copie : le consommateur ne voit que des éléments complets
+    atomic_set(&r->head, head + 1);
+    return true;
+}
+
+bool spsc_ring_get(struct spsc_ring *r, void *elem)
+{
+    uint32_t tail = atomic_get(&r->tail);
+
+    if (tail == (uint32_t)atomic_get(&r->head)) {
+        return false;
+    }
+
+    memcpy(elem, &r->buf[(tail & (r->len - 1)) * r->elem_size], r->elem_size);
+    atomic_set(&r->tail, tail + 1);
+    return true;
+}
@@ -0,0 +1,38 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <stdbool.h>
+
+/**
+ * @brief Anneau sans verrou, un seul producteur / un seul consommateur.
+ *
+ * Le producteur (handler de trigger, work FIFO) n'écrit que head, le
+ * consommateur n'écrit que tail : aucune section critique n'est
+ * nécessaire. Anneau plein : l'élément entrant est rejeté et compté
+ * dans dropped, les éléments déjà présents ne sont jamais écrasés.
+ */
+struct spsc_ring {
+    uint8_t *buf;
+    uint16_t elem_size;
+    uint32_t len;          // puissance de 2
+    atomic_t head;         // écrit par le producteur
+    atomic_t tail;         // écrit par le consommateur
+    atomic_t dropped;
+};
+
+void spsc_ring_init(struct spsc_ring *r, void *buf, size_t elem_size, uint32_t len);
+
+/** @return true si l'élément a été ajouté, false si l'anneau est plein */
+bool spsc_ring_put(struct spsc_ring *r, const void *elem);
+
+/** @return true si un élément a été retiré, false si l'anneau est vide */
+bool spsc_ring_get(struct spsc_ring *r, void *elem);
+
+static inline uint32_t spsc_ring_count(const struct spsc_ring *r)
+{
+    return (uint32_t)atomic_get(&r->head) - (uint32_t)atomic_get(&r->tail);
+}
+
+#endif
@@ -0,0 +1,306 @@
+#include "synth_trace.h"
+#include <math.h>
+
+#define PI 3.14159265f
+
+float synth_noise(uint32_t *lcg)
+{
+    *lcg = *lcg * 1103515245 + 12345;
+    return (int32_t)(*lcg >> 8) / (float)(1 << 23) - 1.0f;  // [-1, 1[
+}
+
+float synth_baro_pa(float alt_m)
+{
+    return 101325.0f * powf(1.0f - alt_m / 44330.77f, 5.25588f);
+}
+
+void synth_pressure(EnvSample *s, int64_t t_us, float pa)
+{
+    s->timestamp_us = t_us;
+    s->pressure.val1 = (int32_t)(pa / 1000.0f);
+    s->pressure.val2 = (int32_t)((pa - s->pressure.val1 * 1000.0f) * 1000.0f);
+}
+
+/* ==================== Marche ==================== */
+const SynthWalk synth_walks[SYNTH_WALK_COUNT] = {
+    [SYNTH_WALK_REST] = { "repos",  0.0f, 0.0f,  0.02f, 10 },
+    [SYNTH_WALK_WALK] = { "marche", 1.8f, 0.35f, 0.05f, 60 },
+    [SYNTH_WALK_RUN]  = { "course", 2.8f, 1.0f,  0.10f, 60 },
+};
+
+void synth_walk_start(SynthWalkReplay *r, const SynthWalk *walk)
+{
+    *r = (SynthWalkReplay){ .walk = walk, .lcg = 12345, .total = walk->seconds * MOTION_ODR_HZ };
+}
+
+int synth_walk_batch(SynthWalkReplay *r, MotionSample *out, int max)
+{
+    const SynthWalk *w = r->walk;
+    int n = 0;
+
+    while (n < max && r->i < r->total) {
+        float ph = 2 * PI * w->hz * r->i / MOTION_ODR_HZ;
+        float sn = sinf(ph);
+        float heel = sn > 0 ? sn * sn * sn * sn : 0;
+        float v = w->amp_g * (0.6f * sn + 0.4f * heel);
+        MotionSample *s = &out[n++];
+        float noise[3];
+
+        for (int a = 0; a < 3; a++) {
+            noise[a] = w->noise_g * synth_noise(&r->lcg);
+        }
+        *s = (MotionSample){ .timestamp_us = (int64_t)r->i * 1000000 / MOTION_ODR_HZ };
+        s->accel[0] = SYNTH_G_LSB * (0.2f + 0.3f * v + noise[0]);
+        s->accel[1] = SYNTH_G_LSB * (0.1f + 0.2f * v * cosf(ph / 2) + noise[1]);
+        s->accel[2] = SYNTH_G_LSB * (0.97f + v + noise[2]);
+        r->i++;
+    }
+    return n;
+}
+
+/* ==================== Escalier ==================== */
+#define STAIRS_BASE_M   300.0f
+#define STAIRS_TAU_S    0.5f    // montée en vitesse d'un marcheur
+#define STAIRS_BIAS     0.1f    // biais accéléro (m/s²), à estimer par le filtre
+
+static const struct {
+    float seconds;
+    float vspeed;  // consigne (m/s)
+} stairs[] = {
+    { 20, 0 }, { 7.5f, 0.44f }, { 5, 0 }, { 7.5f, 0.44f }, { 5, 0 }, { 7.5f, 0.44f }, { 5, 0 },
+    { 7.5f, 0.44f }, { 30, 0 }, { 6.6f, -0.5f }, { 5, 0 }, { 6.6f, -0.5f }, { 30, 0 },
+};
+
+void synth_stairs_init(SynthStairs *st, bool use_imu)
+{
+    *st = (SynthStairs){ .use_imu = use_imu, .lcg = 4321 };
+}
+
+bool synth_stairs_batch(SynthStairs *st, MotionSample *imu, int *n_imu,
+                        EnvSample *press, int *n_press)
+{
+    const float g_dir[3] = { 0.1f, 0.05f, 0.9937f };  // poignet légèrement incliné
+    const float dt = 1.0f / MOTION_ODR_HZ;
+
+    *n_imu = *n_press = 0;
+    for (int k = 0; k < SYNTH_BATCH_LEN; k++, st->i++) {
+        if (st->seg >= ARRAY_SIZE(stairs)) {
+            return false;
+        }
+        int64_t t_us = (int64_t)st->i * 1000000 / MOTION_ODR_HZ;
+        float a = (stairs[st->seg].vspeed - st->v) / STAIRS_TAU_S;
+
+        st->v += a * dt;
+        st->h += st->v * dt;
+        st->t_us = t_us;
+        if ((st->t_seg += dt) >= stairs[st->seg].seconds) {
+            st->t_seg = 0.0f;
+            st->seg++;
+        }
+
+        if (st->use_imu) {
+            // Vertical réel + rebond des pas + biais + bruit, le long de la gravité
+            float bounce = fabsf(st->v) > 0.05f ? 1.5f * sinf(2 * PI * 2.0f * t_us * 1e-6f) : 0.0f;
+            float a_meas = a + bounce + STAIRS_BIAS + 0.2f * synth_noise(&st->lcg);
+            float scale = (1.0f + a_meas / 9.80665f) * SYNTH_G_LSB;
+
+            imu[*n_imu].timestamp_us = t_us;
+            for (int j = 0; j < 3; j++) {
+                imu[*n_imu].accel[j] = (int16_t)(g_dir[j] * scale);
+            }
+            (*n_imu)++;
+        }
+        if (t_us >= st->next_press_us) {
+            float pa = synth_baro_pa(STAIRS_BASE_M + st->h) + 1.5f * synth_noise(&st->lcg);
+
+            synth_pressure(&press[(*n_press)++], t_us, pa);
+            st->next_press_us += 1000000 / ENV_PRESS_ODR_HZ;
+        }
+    }
+    return true;
+}
+
+/* ==================== Activités ==================== */
+static const struct {
+    ActivityState label;
+    int seconds;
+} activities[SYNTH_ACTIVITY_SEGMENTS] = {
+    { ACTIVITY_REST, 30 }, { ACTIVITY_WALK, 60 }, { ACTIVITY_RUN, 45 }, { ACTIVITY_WALK, 30 },
+    { ACTIVITY_VEHICLE, 90 }, { ACTIVITY_REST, 30 }, { ACTIVITY_RUN, 30 },
+    { ACTIVITY_VEHICLE, 45 }, { ACTIVITY_REST, 20 },
+};
+
+void synth_activity_sample(ActivityState label, float t, uint32_t *lcg, int16_t out[3])
+{
+    const float g_dir[3] = { 0.2f, 0.1f, 0.9747f };
+    float v = 0.0f, swing = 0.0f, n = 0.004f;
+
+    if (label == ACTIVITY_WALK || label == ACTIVITY_RUN) {
+        float hz = label == ACTIVITY_WALK ? 1.8f : 2.8f;
+        float amp = label == ACTIVITY_WALK ? 0.35f : 1.0f;
+        float sn = sinf(2 * PI * hz * t);
+        float heel = sn > 0 ? sn * sn * sn * sn : 0;
+
+        v = amp * (0.6f * sn + 0.4f * heel);
+        swing = 0.5f * amp * sinf(PI * hz * t);  // balancier du bras
+        n = 0.05f * amp / 0.35f;
+    } else if (label == ACTIVITY_VEHICLE) {
+        v = 0.04f * sinf(2 * PI * 9.3f * t) + 0.03f * sinf(2 * PI * 13.7f * t + 1.0f) +
+            0.02f * sinf(2 * PI * 17.1f * t + 2.0f);
+        swing = 0.05f * sinf(2 * PI * 0.35f * t);
+        n = 0.02f;
+    }
+    out[0] = SYNTH_G_LSB * (g_dir[0] * (1.0f + v) + swing + n * synth_noise(lcg));
+    out[1] = SYNTH_G_LSB * (g_dir[1] * (1.0f + v) + n * synth_noise(lcg));
+    out[2] = SYNTH_G_LSB * (g_dir[2] * (1.0f + v) + n * synth_noise(lcg));
+}
+
+void synth_activity_init(SynthActivity *a)
+{
+    *a = (SynthActivity){ .lcg = 777 };
+}
+
+bool synth_activity_batch(SynthActivity *a, MotionSample *out, ActivityState *label,
+                          bool *settled)
+{
+    if (a->batch == activities[a->seg].seconds * 10) {
+        a->batch = 0;
+        a->seg++;
+    }
+    if (a->seg >= ARRAY_SIZE(activities)) {
+        return false;
+    }
+    *label = activities[a->seg].label;
+    *settled = a->batch >= SYNTH_ACTIVITY_SETTLE_S * 10;
+    for (int i = 0; i < SYNTH_BATCH_LEN; i++) {
+        out[i].timestamp_us = a->t_us;
+        synth_activity_sample(*label, a->t_us * 1e-6f, &a->lcg, out[i].accel);
+        a->t_us += 1000000 / MOTION_ODR_HZ;
+    }
+    a->batch++;
+    return true;
+}
+
+/* ==================== Météo ==================== */
+const SynthWeatherSegment synth_weather[SYNTH_WEATHER_SEGMENTS] = {
+    { 6, 0, FORECAST_STEADY },
+    { 6, -100, FORECAST_FALLING },
+    { 6, -200, FORECAST_FALLING },
+    { 6, 200, FORECAST_RISING },
+    { 6, 20, FORECAST_STEADY },
+};
+
+void synth_weather_init(SynthWeather *w)
+{
+    *w = (SynthWeather){ .lcg = 2024, .pa0 = 102000.0f };
+}
+
+int synth_weather_batch(SynthWeather *w, EnvSample *out, int max, int *done_seg)
+{
+    *done_seg = -1;
+    if (w->seg >= ARRAY_SIZE(synth_weather)) {
+        return 0;
+    }
+
+    const int total = (int)(synth_weather[w->seg].hours * 3600 * SYNTH_WEATHER_RATE_HZ);
+    const float pa_s = synth_weather[w->seg].pa_h / (3600.0f * SYNTH_WEATHER_RATE_HZ);
+    int n = 0;
+
+    while (n < max && w->i < total) {
+        // Depuis le début du segment : pas d'accumulation d'arrondis float
+        synth_pressure(&out[n++], w->t_us, w->pa0 + pa_s * w->i + 2.0f * synth_noise(&w->lcg));
+        w->i++;
+        w->t_us += 1000000 / SYNTH_WEATHER_RATE_HZ;
+    }
+    if (w->i == total) {
+        *done_seg = w->seg++;
+        w->pa0 += pa_s * total;
+        w->i = 0;
+    }
+    return n;
+}
+
+/* ==================== Chutes ==================== */
+#ifdef CONFIG_ZSWATCH_FALL_DETECT
+const SynthFall synth_falls[SYNTH_FALL_COUNT] = {
+    [SYNTH_FALL_CONFIRMED] = { "chute",  0.45f, 5.0f, SYNTH_AFTER_LYING },
+    [SYNTH_FALL_GETUP]     = { "releve", 0.40f, 4.0f, SYNTH_AFTER_GETUP },
+    [SYNTH_FALL_JUMP]      = { "saut",   0.25f, 2.2f, SYNTH_AFTER_WALK },
+    [SYNTH_FALL_GESTURE]   = { "geste",  0.0f,  3.5f, SYNTH_AFTER_WALK },
+};
+
+/* Accélération (g) à l'instant t du scénario */
+static void fall_accel(const SynthFall *f, float t, uint32_t *lcg, float a[3])
+{
+    float t_impact = SYNTH_FALL_T0_S + f->free_fall_s;
+    float up[3] = { 0.0f, 0.0f, 1.0f };  // debout : gravité sur z
+    float amp = 0.0f, n = 0.01f;
+
+    if (t >= t_impact) {
+        float dt = t - t_impact;
+        bool lying = f->after == SYNTH_AFTER_LYING || (f->after == SYNTH_AFTER_GETUP && dt < 1.2f);
+
+        if (lying) {
+            up[0] = 1.0f;  // au sol : gravité sur x
+            up[2] = 0.0f;
+        }
+        if (dt < 0.03f) {
+            amp = (f->impact_g - 1.0f) * sinf(PI * dt / 0.03f);
+        } else if (dt < 0.3f) {
+            amp = 0.6f * expf(-10.0f * dt) * sinf(2 * PI * 8.0f * dt);  // rebonds
+        } else if (!lying) {
+            amp = 0.35f * sinf(2 * PI * 1.8f * dt);  // marche, relevé
+            n = 0.05f;
+        }
+    } else if (t >= SYNTH_FALL_T0_S && f->free_fall_s > 0.0f) {
+        for (int k = 0; k < 3; k++) {
+            a[k] = 0.03f * synth_noise(lcg);  // chute libre
+        }
+        return;
+    }
+    for (int k = 0; k < 3; k++) {
+        a[k] = up[k] * (1.0f + amp) + n * synth_noise(lcg);
+    }
+}
+
+void synth_fall_start(SynthFallReplay *r, const SynthFall *fall)
+{
+    *r = (SynthFallReplay){
+        .fall = fall,
+        .lcg = 99,
+        .total = (int)((SYNTH_FALL_T0_S + fall->free_fall_s + 4.0f) * MOTION_ODR_HZ),
+    };
+}
+
+int synth_fall_read(SynthFallReplay *r, MotionSample *fifo, int max, bool armed,
+                    uint32_t *events)
+{
+    const int64_t period_us = 1000000 / MOTION_ODR_HZ;
+    int n = 0;
+
+    while (r->s < r->total) {
+        int64_t t_us = r->s++ * period_us;
+        float a[3];
+
+        fall_accel(r->fall, t_us * 1e-6f, &r->lcg, a);
+        fifo[n].timestamp_us = t_us;
+        for (int k = 0; k < 3; k++) {
+            fifo[n].accel[k] = (int16_t)CLAMP(a[k] * SYNTH_G_LSB, INT16_MIN, INT16_MAX);
+        }
+        n++;
+
+        // Détecteur de chute libre du capteur, puis règle de lecture de la FIFO
+        float norm = sqrtf(a[0] * a[0] + a[1] * a[1] + a[2] * a[2]);
+        r->low = norm < FALL_FF_MG / 1000.0f ? r->low + 1 : 0;
+        bool ff = (r->low == FALL_FF_SAMPLES);
+
+        if (ff || n >= CONFIG_ZSWATCH_MOTION_FIFO_WATERMARK || n == max ||
+            (armed && t_us - r->last_read_us >= FALL_POLL_MS * 1000)) {
+            *events = ff ? MOTION_EVT_FREE_FALL : 0;
+            r->last_read_us = t_us;
+            return n;
+        }
+    }
+    return 0;
+}
+#endif /* CONFIG_ZSWATCH_FALL_DETECT */
@@ -0,0 +1,219 @@
+#ifndef SYNTH_TRACE_H
+#define SYNTH_TRACE_H
+
+#include <stdbool.h>
+#include <zephyr/types.h>
+#include "env_sensor.h"
+#include "motion_sensor.h"
+#include "activity.h"
+#include "fall_detect.h"
+#include "forecast.h"
+
+/*
+ * Traces capteurs synthétiques, partagées par les mesures de démarrage
+ * (bench.c) et les tests unitaires : mêmes signaux, mêmes graines, donc
+ * mêmes chiffres des deux côtés. Échantillons au format des drivers
+ * (IMU brute à MOTION_ODR_HZ, pression LPS22HH en kPa), lots de 100 ms
+ * comme la boucle principale.
+ */
+
+#define SYNTH_BATCH_LEN  (MOTION_ODR_HZ / 10)        // échantillons IMU par lot de 100 ms
+#define SYNTH_G_LSB      (1000000.0f / MOTION_ACCEL_UG_PER_LSB)
+
+/* Bruit uniforme [-1, 1[ (générateur congruentiel, graine *lcg) */
+float synth_noise(uint32_t *lcg);
+
+/* Pression (Pa) de l'atmosphère standard à l'altitude alt_m */
+float synth_baro_pa(float alt_m);
+
+/* Échantillon LPS22HH (kPa) de pression pa */
+void synth_pressure(EnvSample *s, int64_t t_us, float pa);
+
+/*
+ * Escalier : 4 étages de 3.3 m montés avec paliers de 5 s, 2 descendus,
+ * à 300 m. Rebond de marche à 2 Hz, bruit accéléro (0.2 m/s²) et baro
+ * (~1.5 Pa), biais accéléro constant de 0.1 m/s².
+ */
+#define SYNTH_STAIRS_UP    4
+#define SYNTH_STAIRS_DOWN  2
+
+typedef struct {
+    bool use_imu;        // false : accéléromètre en veille (aucun échantillon IMU)
+    uint32_t lcg;
+    size_t seg;
+    int i;               // échantillon IMU depuis le début
+    float t_seg;
+    int64_t next_press_us;
+    // Vérité à la fin du dernier lot
+    int64_t t_us;
+    float h;             // altitude relative (m)
+    float v;             // vitesse verticale (m/s)
+} SynthStairs;
+
+void synth_stairs_init(SynthStairs *st, bool use_imu);
+
+/**
+ * @brief Lot suivant de 100 ms (IMU 208 Hz, LPS22HH 100 Hz).
+ * @param imu SYNTH_BATCH_LEN échantillons au plus
+ * @param press SYNTH_BATCH_LEN échantillons au plus
+ * @return false à la fin de l'escalier (lot incomplet jeté)
+ */
+bool synth_stairs_batch(SynthStairs *st, MotionSample *imu, int *n_imu,
+                        EnvSample *press, int *n_press);
+
+/*
+ * Marche au poignet : un pas par période (pic au contact du talon +
+ * oscillation), bruit uniforme sur chaque axe. Le nombre de pas attendu
+ * est connu exactement (hz x secondes), la cadence vaut hz x 60.
+ */
+typedef struct {
+    const char *name;
+    float hz;            // pas par seconde
+    float amp_g;
+    float noise_g;
+    int seconds;
+} SynthWalk;
+
+enum {
+    SYNTH_WALK_REST,     // bruit seul
+    SYNTH_WALK_WALK,     // marche 1.8 Hz
+    SYNTH_WALK_RUN,      // course 2.8 Hz
+    SYNTH_WALK_COUNT,
+};
+
+extern const SynthWalk synth_walks[SYNTH_WALK_COUNT];
+
+typedef struct {
+    const SynthWalk *walk;
+    uint32_t lcg;
+    int i;
+    int total;
+} SynthWalkReplay;
+
+void synth_walk_start(SynthWalkReplay *r, const SynthWalk *walk);
+
+/**
+ * @brief Lot suivant d'au plus max échantillons IMU.
+ * @return échantillons écrits, 0 à la fin de la trace
+ */
+int synth_walk_batch(SynthWalkReplay *r, MotionSample *out, int max);
+
+/*
+ * Trace étiquetée : repos (bruit seul), marche 1.8 Hz / 0.35 g, course
+ * 2.8 Hz / 1 g, véhicule (vibrations 9 .. 17 Hz de quelques centièmes de g
+ * + roulis lent), en 9 segments de 20 à 90 s. Les SYNTH_ACTIVITY_SETTLE_S
+ * premières secondes d'un segment (fenêtre + confirmation du classifieur)
+ * sont marquées comme transition.
+ */
+#define SYNTH_ACTIVITY_SETTLE_S  9
+#define SYNTH_ACTIVITY_SEGMENTS  9
+
+typedef struct {
+    uint32_t lcg;
+    size_t seg;
+    int batch;           // lot dans le segment
+    int64_t t_us;
+} SynthActivity;
+
+/* Accélération brute (LSB) d'une activité à l'instant t (s) */
+void synth_activity_sample(ActivityState label, float t, uint32_t *lcg, int16_t out[3]);
+
+void synth_activity_init(SynthActivity *a);
+
+/**
+ * @brief Lot suivant de SYNTH_BATCH_LEN échantillons de la trace étiquetée.
+ * @param label activité réelle du lot
+ * @param settled false pendant la transition du début de segment
+ * @return false à la fin de la trace
+ */
+bool synth_activity_batch(SynthActivity *a, MotionSample *out, ActivityState *label,
+                          bool *settled);
+
+/*
+ * Chutes et faux positifs, rejoués avec la livraison réelle de la FIFO :
+ * lecture au seuil (CONFIG_ZSWATCH_MOTION_FIFO_WATERMARK échantillons),
+ * immédiate à l'interruption chute libre (|a| < FALL_FF_MG pendant
+ * FALL_FF_SAMPLES échantillons, comme le LSM6DSO), puis toutes les
+ * FALL_POLL_MS tant que le détecteur est armé. Chute libre (ou geste) à
+ * SYNTH_FALL_T0_S, 4 s d'enregistrement après l'impact.
+ */
+#define SYNTH_FALL_T0_S  2.0f
+
+typedef enum {
+    SYNTH_AFTER_LYING,     // immobile au sol
+    SYNTH_AFTER_GETUP,     // se relève après 1.2 s
+    SYNTH_AFTER_WALK,      // repart en marchant
+} SynthFallAfter;
+
+typedef struct {
+    const char *name;
+    float free_fall_s;     // 0 : pas de chute libre
+    float impact_g;
+    SynthFallAfter after;
+} SynthFall;
+
+enum {
+    SYNTH_FALL_CONFIRMED,  // chute, reste au sol
+    SYNTH_FALL_GETUP,      // chute, se relève
+    SYNTH_FALL_JUMP,       // saut : chute libre courte, réception sous le seuil d'impact
+    SYNTH_FALL_GESTURE,    // geste brusque sans chute libre
+    SYNTH_FALL_COUNT,
+};
+
+extern const SynthFall synth_falls[SYNTH_FALL_COUNT];
+
+typedef struct {
+    const SynthFall *fall;
+    uint32_t lcg;
+    uint32_t low;          // échantillons consécutifs sous FALL_FF_MG
+    int s;
+    int total;
+    int64_t last_read_us;
+} SynthFallReplay;
+
+void synth_fall_start(SynthFallReplay *r, const SynthFall *fall);
+
+/**
+ * @brief Remplit la FIFO jusqu'à la prochaine lecture.
+ * @param armed détecteur armé : lecture toutes les FALL_POLL_MS
+ * @param events MOTION_EVT_FREE_FALL si la lecture vient de l'interruption
+ * @return échantillons à lire, 0 à la fin du scénario (reste jeté)
+ */
+int synth_fall_read(SynthFallReplay *r, MotionSample *fifo, int max, bool armed,
+                    uint32_t *events);
+
+/*
+ * Passage d'une dépression sur 30 h, un échantillon de pression par
+ * seconde (le coût par échantillon ne dépend pas de l'ODR) : pente
+ * imposée par segment de 6 h, bruit LPS22HH ~2 Pa, départ à 1020 hPa.
+ * En fin de segment, la fenêtre 3 h est entièrement dans le segment.
+ */
+#define SYNTH_WEATHER_RATE_HZ   1
+#define SYNTH_WEATHER_SEGMENTS  5
+
+typedef struct {
+    float hours;
+    float pa_h;                // pente imposée
+    ForecastTrend expected;
+} SynthWeatherSegment;
+
+extern const SynthWeatherSegment synth_weather[SYNTH_WEATHER_SEGMENTS];
+
+typedef struct {
+    uint32_t lcg;
+    size_t seg;
+    int i;                     // échantillon dans le segment
+    float pa0;                 // pression au début du segment
+    int64_t t_us;
+} SynthWeather;
+
+void synth_weather_init(SynthWeather *w);
+
+/**
+ * @brief Lot suivant d'au plus max échantillons, sans déborder du segment.
+ * @param done_seg segment terminé par ce lot, -1 sinon
+ * @return échantillons écrits, 0 à la fin de la trace
+ */
+int synth_weather_batch(SynthWeather *w, EnvSample *out, int max, int *done_seg);
+
+#endif
@@ -0,0 +1,198 @@
+#include "timebase.h"
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+LOG_MODULE_REGISTER(timebase, LOG_LEVEL_INF);
+
+#define USEC_PER_SEC_LL   1000000LL
+#define SYNC_POINTS       8          // historique de la régression
+#define SYNC_MIN_SPACING  (600 * USEC_PER_SEC_LL)  // points plus proches : remplacés
+#define DRIFT_MAX_PPB     500000     // au-delà : pas un quartz, l'heure a été changée
+#define STEP_MAX_US       (2 * USEC_PER_SEC_LL)     // saut toléré en plus de la dérive
+#define NEXT_SYNC_MIN_S   600
+#define NEXT_SYNC_MAX_S   (7 * 24 * 3600)
+#define NEXT_SYNC_FIRST_S 3600       // un seul point : dérive inconnue
+
+typedef struct {
+    int64_t uptime_us;
+    int64_t epoch_us;
+    uint32_t resolution_us;
+} SyncPoint;
+
+// Modèle : epoch = ref_epoch + dt + dt * drift_ppb / 1e9, dt = uptime - ref_uptime
+static struct k_spinlock lock;
+static int64_t ref_uptime_us;
+static int64_t ref_epoch_us;
+static int32_t drift_ppb;
+static bool synced;
+// Résultats de la dernière synchro, publiés avec le modèle (timebase_get_info)
+static uint8_t fit_points;
+static int32_t last_step_ms;
+static uint32_t next_sync_s;
+
+// Historique, modifié dans le thread BT uniquement
+static SyncPoint points[SYNC_POINTS];
+static int n_points;
+
+int64_t timebase_now_us(void)
+{
+    return k_ticks_to_us_floor64(k_uptime_ticks());
+}
+
+static int64_t model_epoch_us(int64_t uptime_us)
+{
+    int64_t dt = uptime_us - ref_uptime_us;
+
+    return ref_epoch_us + dt + dt * drift_ppb / 1000000000LL;
+}
+
+int64_t timebase_to_epoch_us(int64_t uptime_us)
+{
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    int64_t epoch_us = model_epoch_us(uptime_us);
+
+    k_spin_unlock(&lock, key);
+    return epoch_us;
+}
+
+uint32_t timebase_now_s(void)
+{
+    return (uint32_t)(timebase_to_epoch_us(timebase_now_us()) / USEC_PER_SEC_LL);
+}
+
+/*
+ * Régression de l'écart (epoch - uptime) en fonction de l'uptime : la pente
+ * est la dérive, l'écart-type de la pente borne l'erreur future.
+ * Calcul centré en double (rare : une fois par synchro).
+ */
+static void drift_fit(double *slope, double *slope_sigma, double *offset_at_last)
+{
+    double mx = 0, my = 0, sxx = 0, sxy = 0, sse = 0, var_q = 0;
+    int64_t x0 = points[0].uptime_us;
+    int64_t y0 = points[0].epoch_us - points[0].uptime_us;
+
+    for (int i = 0; i < n_points; i++) {
+        mx += (double)(points[i].uptime_us - x0) / USEC_PER_SEC_LL;
+        my += (double)(points[i].epoch_us - points[i].uptime_us - y0);
+        // Quantification uniforme : variance r²/12
+        double r = points[i].resolution_us;
+        var_q = MAX(var_q, r * r / 12);
+    }
+    mx /= n_points;
+    my /= n_points;
+
+    for (int i = 0; i < n_points; i++) {
+        double x = (double)(points[i].uptime_us - x0) / USEC_PER_SEC_LL - mx;
+        double y = (double)(points[i].epoch_us - points[i].uptime_us - y0) - my;
+        sxx += x * x;
+        sxy += x * y;
+    }
+    *slope = sxy / sxx;  // µs/s = ppm
+
+    for (int i = 0; i < n_points; i++) {
+        double x = (double)(points[i].uptime_us - x0) / USEC_PER_SEC_LL - mx;
+        double y = (double)(points[i].epoch_us - points[i].uptime_us - y0) - my;
+        double e = y - *slope * x;
+        sse += e * e;
+    }
+    // Résidus (n > 2) ou, à défaut, bruit de quantification de l'heure reçue
+    double var = (n_points > 2) ? MAX(sse / (n_points - 2), var_q) : var_q;
+    *slope_sigma = sqrt(var / sxx);
+
+    double x_last = (double)(points[n_points - 1].uptime_us - x0) / USEC_PER_SEC_LL - mx;
+    *offset_at_last = y0 + my + *slope * x_last;
+}
+
+/* Délai avant que l'erreur probable (2 sigma) dépasse le budget */
+static uint32_t next_sync_delay(double slope_sigma, uint32_t resolution_us)
+{
+    double budget_us = CONFIG_ZSWATCH_TIME_ERROR_BUDGET_MS * 1000.0 - resolution_us / 2.0;
+
+    if (budget_us <= 0) {
+        return NEXT_SYNC_MIN_S;
+    }
+    double t = budget_us / MAX(2 * slope_sigma, 0.01);  // plancher 0.01 ppm
+    return CLAMP((uint32_t)MIN(t, (double)UINT32_MAX), NEXT_SYNC_MIN_S, NEXT_SYNC_MAX_S);
+}
+
+void timebase_sync(int64_t epoch_us, uint32_t resolution_us)
+{
+    timebase_sync_at(timebase_now_us(), epoch_us, resolution_us);
+}
+
+void timebase_sync_at(int64_t now_us, int64_t epoch_us, uint32_t resolution_us)
+{
+    resolution_us = MAX(resolution_us, 1U);
+    // Heure reçue tronquée : l'instant réel est en moyenne au milieu de l'intervalle
+    epoch_us += resolution_us / 2;
+
+    int64_t step_us = epoch_us - timebase_to_epoch_us(now_us);
+    int64_t since_us = n_points ? now_us - points[n_points - 1].uptime_us : 0;
+
+    int32_t step_ms = synced ? (int32_t)CLAMP(step_us / 1000, INT32_MIN, INT32_MAX) : 0;
+
+    // Heure changée par l'utilisateur ou fuseau : l'historique ne vaut plus rien
+    if (synced && llabs(step_us) > STEP_MAX_US + since_us / (1000000000LL / DRIFT_MAX_PPB)) {
+        LOG_WRN("Saut d'heure de %d ms : estimation de dérive réinitialisée", step_ms);
+        n_points = 0;
+    }
+
+    if (n_points > 0 && since_us < SYNC_MIN_SPACING) {
+        n_points--;  // même « instant » : seul le point le plus récent compte
+    } else if (n_points == SYNC_POINTS) {
+        memmove(&points[0], &points[1], sizeof(points[0]) * (SYNC_POINTS - 1));
+        n_points--;
+    }
+    points[n_points++] = (SyncPoint){ now_us, epoch_us, resolution_us };
+
+    int64_t new_ref_epoch = epoch_us;
+    int32_t new_drift = 0;
+    uint32_t next_s;
+
+    if (n_points >= 2) {
+        double slope, sigma, offset;
+
+        drift_fit(&slope, &sigma, &offset);
+        if (fabs(slope) * 1000 < DRIFT_MAX_PPB) {
+            new_drift = (int32_t)(slope * 1000);
+            // Droite de régression plutôt que le dernier point (bruit de quantification)
+            new_ref_epoch = now_us + (int64_t)offset;
+        }
+        next_s = next_sync_delay(sigma, resolution_us);
+    } else {
+        next_s = NEXT_SYNC_FIRST_S;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    ref_uptime_us = now_us;
+    ref_epoch_us = new_ref_epoch;
+    drift_ppb = new_drift;
+    synced = true;
+    fit_points = n_points;
+    last_step_ms = step_ms;
+    next_sync_s = next_s;
+    k_spin_unlock(&lock, key);
+
+    LOG_INF("Synchro %d : écart %d ms, dérive %d ppb, prochaine dans %u s",
+            n_points, step_ms, new_drift, next_s);
+}
+
+bool timebase_is_synced(void)
+{
+    return synced;
+}
+
+void timebase_get_info(TimebaseInfo *info)
+{
+    // Même verrou que la synchro : dérive et résultats d'une seule synchro
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    info->synced = synced;
+    info->points = fit_points;
+    info->drift_ppb = drift_ppb;
+    info->last_step_ms = last_step_ms;
+    info->next_sync_s = next_sync_s;
+    k_spin_unlock(&lock, key);
+}
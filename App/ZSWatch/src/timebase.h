@@ -0,0 +1,57 @@
+#ifndef TIMEBASE_H
+#define TIMEBASE_H
+
+#include <stdbool.h>
+#include <zephyr/types.h>
+
+/*
+ * Base de temps unique de l'application.
+ *
+ * Les échantillons sont horodatés en µs depuis le démarrage (timebase_now_us,
+ * monotone, résolution d'un tick noyau : ~30 µs à 32768 Hz). Un modèle
+ * linéaire vers l'epoch Unix (décalage + dérive du quartz), recalé à chaque
+ * écriture CTS du téléphone, permet de convertir n'importe quel horodatage
+ * après coup : une nouvelle synchro ne modifie pas les horodatages déjà pris.
+ *
+ * La dérive est estimée par régression linéaire sur les derniers points de
+ * synchro ; son incertitude donne le délai avant la prochaine synchro
+ * nécessaire (CONFIG_ZSWATCH_TIME_ERROR_BUDGET_MS).
+ */
+
+typedef struct {
+    bool synced;
+    uint8_t points;          // points de synchro utilisés par la régression
+    int32_t drift_ppb;       // dérive corrigée (> 0 : quartz en retard)
+    int32_t last_step_ms;    // écart constaté à la dernière synchro
+    uint32_t next_sync_s;    // délai conseillé avant la prochaine synchro
+} TimebaseInfo;
+
+/* Temps monotone depuis le démarrage (µs) */
+int64_t timebase_now_us(void);
+
+/**
+ * @brief Convertit un horodatage timebase_now_us() en µs depuis 1970,
+ *        dérive corrigée. Sans synchro, rend l'horodatage tel quel.
+ */
+int64_t timebase_to_epoch_us(int64_t uptime_us);
+
+/* Heure courante (s depuis 1970, ou depuis le démarrage sans synchro) */
+uint32_t timebase_now_s(void);
+
+/**
+ * @brief Recale l'horloge sur l'heure reçue (Current Time Service) et
+ *        met à jour l'estimation de dérive.
+ * @param epoch_us µs depuis 1970, tronquées à resolution_us
+ * @param resolution_us résolution de l'heure reçue (1 s si secondes seules)
+ */
+void timebase_sync(int64_t epoch_us, uint32_t resolution_us);
+
+/* Même chose pour une heure reçue à l'instant now_us (rejeu de synchros) */
+void timebase_sync_at(int64_t now_us, int64_t epoch_us, uint32_t resolution_us);
+
+/* true après la première synchro */
+bool timebase_is_synced(void);
+
+void timebase_get_info(TimebaseInfo *info);
+
+#endif
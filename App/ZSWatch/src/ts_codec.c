@@ -0,0 +1,211 @@
+#include "ts_codec.h"
+#include <string.h>
+
+// Pire cas d'un point : delta-de-delta 36 bits, masque 17, valeurs 9 * 36
+#define POINT_MAX_BITS   (36 + 17 + TS_MAX_CHANNELS * 36)
+#define COUNT_BITS       8
+
+/* Classes de codage : préfixe unaire puis nombre de bits de la valeur */
+static const uint8_t dod_widths[] = { 7, 9, 12, 32 };
+static const uint8_t val_widths[] = { 4, 8, 16, 32 };
+
+/* ==================== Bits ==================== */
+static void put_bits(TsEncoder *e, uint32_t v, uint8_t n)
+{
+    // MSB d'abord ; buf est remis à zéro par ts_encoder_init
+    while (n--) {
+        if (v & (1UL << n)) {
+            e->buf[e->bits >> 3] |= 0x80 >> (e->bits & 7);
+        }
+        e->bits++;
+    }
+}
+
+static int get_bits(TsDecoder *d, uint8_t n, uint32_t *out)
+{
+    uint32_t v = 0;
+
+    if (d->bits + n > (uint32_t)d->len * 8) {
+        return -1;
+    }
+    while (n--) {
+        v = (v << 1) | ((d->buf[d->bits >> 3] >> (7 - (d->bits & 7))) & 1);
+        d->bits++;
+    }
+    *out = v;
+    return 0;
+}
+
+static uint32_t zigzag(int32_t v)
+{
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+static int32_t unzigzag(uint32_t v)
+{
+    return (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+}
+
+/* Différence / somme modulo 2^32 : pas de débordement signé */
+static int32_t wrap_sub(int32_t a, int32_t b)
+{
+    return (int32_t)((uint32_t)a - (uint32_t)b);
+}
+
+static int32_t wrap_add(int32_t a, int32_t b)
+{
+    return (int32_t)((uint32_t)a + (uint32_t)b);
+}
+
+/* '0' pour zéro, sinon préfixe '1..10' (ou '1111') + valeur zig-zag */
+static void put_class(TsEncoder *e, int32_t v, const uint8_t widths[4])
+{
+    uint32_t z = zigzag(v);
+
+    if (z == 0) {
+        put_bits(e, 0, 1);
+        return;
+    }
+    for (int c = 0; c < 4; c++) {
+        if (c == 3 || z < (1UL << widths[c])) {
+            // Préfixe : c+1 uns, puis un zéro sauf pour la dernière classe
+            put_bits(e, (c == 3) ? 0xF : ((1U << (c + 2)) - 2), (c == 3) ? 4 : c + 2);
+            put_bits(e, z, widths[c]);
+            return;
+        }
+    }
+}
+
+static int get_class(TsDecoder *d, int32_t *v, const uint8_t widths[4])
+{
+    uint32_t bit, z;
+    int c = 0;
+
+    // Préfixe unaire, au plus 4 uns
+    while (c < 4) {
+        if (get_bits(d, 1, &bit) != 0) {
+            return -1;
+        }
+        if (!bit) {
+            break;
+        }
+        c++;
+    }
+    if (c == 0) {
+        *v = 0;
+        return 0;
+    }
+    if (get_bits(d, widths[c - 1], &z) != 0) {
+        return -1;
+    }
+    *v = unzigzag(z);
+    return 0;
+}
+
+/* ==================== Encodeur ==================== */
+void ts_encoder_init(TsEncoder *e)
+{
+    memset(e, 0, sizeof(*e));
+    e->bits = COUNT_BITS;
+}
+
+int ts_encoder_add(TsEncoder *e, const TsPoint *p)
+{
+    if (e->count == UINT8_MAX || e->bits + POINT_MAX_BITS > TS_BLOCK_MAX * 8) {
+        return -1;
+    }
+
+    if (e->count == 0) {
+        put_bits(e, p->time, 32);
+        e->prev_delta = 0;
+    } else {
+        int32_t delta = (int32_t)(p->time - e->prev_time);
+        put_class(e, wrap_sub(delta, e->prev_delta), dod_widths);
+        e->prev_delta = delta;
+    }
+    e->prev_time = p->time;
+
+    if (e->count > 0 && p->mask == e->prev_mask) {
+        put_bits(e, 0, 1);
+    } else {
+        put_bits(e, 1, 1);
+        put_bits(e, p->mask, 16);
+        e->prev_mask = p->mask;
+    }
+
+    // Les voies absentes gardent leur dernière valeur comme référence
+    for (int i = 0; i < TS_MAX_CHANNELS; i++) {
+        if (p->mask & (1U << i)) {
+            put_class(e, wrap_sub(p->values[i], e->prev[i]), val_widths);
+            e->prev[i] = p->values[i];
+        }
+    }
+
+    e->count++;
+    e->buf[0] = e->count;
+    return 0;
+}
+
+/* ==================== Décodeur ==================== */
+int ts_decoder_init(TsDecoder *d, const uint8_t *buf, uint16_t len)
+{
+    memset(d, 0, sizeof(*d));
+    if (len < 1 || buf[0] == 0) {
+        return -1;
+    }
+    d->buf = buf;
+    d->len = len;
+    d->bits = COUNT_BITS;
+    d->remaining = buf[0];
+    d->first = true;
+    return 0;
+}
+
+static int decode_point(TsDecoder *d, TsPoint *p)
+{
+    uint32_t v;
+    int32_t s;
+
+    if (d->first) {
+        if (get_bits(d, 32, &v) != 0) return -1;
+        d->prev_time = v;
+        d->prev_delta = 0;
+    } else {
+        if (get_class(d, &s, dod_widths) != 0) return -1;
+        d->prev_delta = wrap_add(d->prev_delta, s);
+        d->prev_time += (uint32_t)d->prev_delta;
+    }
+    p->time = d->prev_time;
+
+    if (get_bits(d, 1, &v) != 0) return -1;
+    if (v || d->first) {
+        if (!v || get_bits(d, 16, &v) != 0) return -1;
+        d->prev_mask = v;
+    }
+    p->mask = d->prev_mask;
+
+    for (int i = 0; i < TS_MAX_CHANNELS; i++) {
+        if (p->mask & (1U << i)) {
+            if (get_class(d, &s, val_widths) != 0) return -1;
+            d->prev[i] = wrap_add(d->prev[i], s);
+        }
+        p->values[i] = d->prev[i];
+    }
+
+    return 0;
+}
+
+int ts_decoder_next(TsDecoder *d, TsPoint *p)
+{
+    if (d->remaining == 0) {
+        return -1;
+    }
+    // Bloc tronqué ou corrompu : la position de lecture n'est plus fiable, arrêt définitif
+    if (decode_point(d, p) != 0) {
+        d->remaining = 0;
+        return -1;
+    }
+    d->first = false;
+    d->remaining--;
+    return 0;
+}
@@ -0,0 +1,75 @@
+#ifndef TS_CODEC_H
+#define TS_CODEC_H
+
+#include <stdbool.h>
+#include <zephyr/types.h>
+
+/*
+ * Compression de séries temporelles par blocs (inspirée de Gorilla).
+ *
+ * Chaque point = horodatage + jusqu'à TS_MAX_CHANNELS valeurs entières,
+ * un masque indiquant les voies présentes. Dans un bloc :
+ *   - horodatages : le premier en clair (32 bits), puis delta-de-delta
+ *     codé '0' | '10'+7 | '110'+9 | '1110'+12 | '1111'+32 bits ;
+ *   - masque : '0' si identique au précédent, sinon '1' + 16 bits ;
+ *   - valeurs : delta avec la dernière valeur de la voie, zig-zag, codé
+ *     '0' | '10'+4 | '110'+8 | '1110'+16 | '1111'+32 bits.
+ * Octet 0 du bloc : nombre de points. Chaque bloc se décode seul.
+ */
+#define TS_BLOCK_MAX     256
+#define TS_MAX_CHANNELS  9
+
+typedef struct {
+    uint32_t time;
+    uint16_t mask;                    // bit i : values[i] présente
+    int32_t values[TS_MAX_CHANNELS];
+} TsPoint;
+
+typedef struct {
+    uint8_t buf[TS_BLOCK_MAX];
+    uint32_t bits;                    // bits écrits (octet de compte inclus)
+    uint8_t count;
+    uint32_t prev_time;
+    int32_t prev_delta;
+    uint16_t prev_mask;
+    int32_t prev[TS_MAX_CHANNELS];
+} TsEncoder;
+
+typedef struct {
+    const uint8_t *buf;
+    uint16_t len;
+    uint32_t bits;                    // position de lecture
+    uint8_t remaining;
+    bool first;
+    uint32_t prev_time;
+    int32_t prev_delta;
+    uint16_t prev_mask;
+    int32_t prev[TS_MAX_CHANNELS];
+} TsDecoder;
+
+void ts_encoder_init(TsEncoder *e);
+
+/**
+ * @brief Ajoute un point au bloc.
+ * @return 0 si OK, -1 si le bloc est plein (le point n'est pas ajouté)
+ */
+int ts_encoder_add(TsEncoder *e, const TsPoint *p);
+
+/* Taille du bloc encodé, en octets */
+static inline uint16_t ts_encoder_size(const TsEncoder *e)
+{
+    return (e->bits + 7) / 8;
+}
+
+/**
+ * @return 0 si OK, -1 si le bloc est vide ou tronqué
+ */
+int ts_decoder_init(TsDecoder *d, const uint8_t *buf, uint16_t len);
+
+/**
+ * @return 0 si un point a été décodé, -1 en fin de bloc ou si le bloc est corrompu
+ *         (les appels suivants renvoient alors -1)
+ */
+int ts_decoder_next(TsDecoder *d, TsPoint *p);
+
+#endif
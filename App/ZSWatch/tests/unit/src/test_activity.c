@@ -0,0 +1,64 @@
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+#include <string.h>
+#include "activity.h"
+#include "synth_trace.h"
+
+/* Trace étiquetée de synth_trace.h, transitions hors matrice de confusion */
+ZTEST(activity, test_labelled_trace)
+{
+    static MotionSample batch[SYNTH_BATCH_LEN];
+    static uint32_t confusion[ACTIVITY_COUNT][ACTIVITY_COUNT];  // réel x estimé, en lots
+    uint32_t changes = 0;
+    ActivityState label;
+    SynthActivity trace;
+    bool settled;
+
+    memset(confusion, 0, sizeof(confusion));
+    activity_reset();
+    synth_activity_init(&trace);
+    while (synth_activity_batch(&trace, batch, &label, &settled)) {
+        changes += activity_feed(batch, ARRAY_SIZE(batch));
+        if (settled) {
+            ActivityInfo info;
+
+            activity_get(&info);
+            confusion[label][info.state]++;
+        }
+    }
+
+    for (int r = ACTIVITY_REST; r < ACTIVITY_COUNT; r++) {
+        uint32_t total = 0;
+
+        for (int c = 0; c < ACTIVITY_COUNT; c++) {
+            total += confusion[r][c];
+        }
+        zassert_true(total > 0);
+        // 95 % par classe : marge pour la FFT float32 de CMSIS-DSP (100 % sur l'hôte)
+        zassert_true(confusion[r][r] * 100 >= total * 95, "%s : %u/%u lots corrects",
+                     activity_name(r), confusion[r][r], total);
+    }
+    // Un changement publié par segment, sans oscillation
+    zassert_equal(changes, SYNTH_ACTIVITY_SEGMENTS, "%u changements", changes);
+}
+
+ZTEST(activity, test_unknown_until_window_full)
+{
+    static MotionSample batch[SYNTH_BATCH_LEN];
+    uint32_t lcg = 1;
+    ActivityInfo info;
+
+    activity_reset();
+    // Fenêtre de ~4.9 s : 4 s de repos ne suffisent pas
+    for (int b = 0; b < 40; b++) {
+        for (size_t i = 0; i < ARRAY_SIZE(batch); i++) {
+            batch[i].timestamp_us = (b * ARRAY_SIZE(batch) + i) * (1000000 / MOTION_ODR_HZ);
+            synth_activity_sample(ACTIVITY_REST, 0.0f, &lcg, batch[i].accel);
+        }
+        zassert_false(activity_feed(batch, ARRAY_SIZE(batch)));
+    }
+    activity_get(&info);
+    zassert_equal(info.state, ACTIVITY_UNKNOWN);
+}
+
+ZTEST_SUITE(activity, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,168 @@
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+#include <math.h>
+#include <string.h>
+#include "ahrs.h"
+
+/*
+ * Trajectoires synthétiques à vitesse angulaire constante (repère capteur),
+ * intégrées exactement, rejouées dans ahrs_update() à 208 Hz. Le filtre
+ * part de l'identité, à 90° de lacet et 30° de roulis de la vérité.
+ */
+#define TRACE_SECONDS   60
+#define CONVERGE_MAX_MS 45000  // mesuré : 3 s (6 axes) à 38.5 s (immobile)
+#define DEG_PER_RAD     57.29578f
+
+static const float start_q[4] = { 0.683f, 0.183f, 0.183f, 0.683f };
+static const float gravity[3] = { 0.0f, 0.0f, 1.0f };
+static const float field[3] = { 0.22f, 0.0f, -0.42f };  // gauss, inclinaison ~62°
+
+static void quat_mul(const float a[4], const float b[4], float out[4])
+{
+    out[0] = a[0] * b[0] - a[1] * b[1] - a[2] * b[2] - a[3] * b[3];
+    out[1] = a[0] * b[1] + a[1] * b[0] + a[2] * b[3] - a[3] * b[2];
+    out[2] = a[0] * b[2] - a[1] * b[3] + a[2] * b[0] + a[3] * b[1];
+    out[3] = a[0] * b[3] + a[1] * b[2] - a[2] * b[1] + a[3] * b[0];
+}
+
+/* Vecteur terrestre vu du capteur : q* v q */
+static void quat_to_sensor(const float q[4], const float v[3], float out[3])
+{
+    const float qc[4] = { q[0], -q[1], -q[2], -q[3] };
+    const float vq[4] = { 0.0f, v[0], v[1], v[2] };
+    float t[4], r[4];
+
+    quat_mul(qc, vq, t);
+    quat_mul(t, q, r);
+    out[0] = r[1];
+    out[1] = r[2];
+    out[2] = r[3];
+}
+
+typedef struct {
+    int converged_ms;   // dernier passage sous 2° (-1 : jamais)
+    float final_deg;
+} TraceResult;
+
+static TraceResult run_trace(const float w[3], bool use_mag)
+{
+    const float dt = 1.0f / MOTION_ODR_HZ;
+    float q[4] = { start_q[0], start_q[1], start_q[2], start_q[3] };
+    float wn = sqrtf(w[0] * w[0] + w[1] * w[1] + w[2] * w[2]);
+    float dq[4] = { 1.0f, 0.0f, 0.0f, 0.0f };
+    TraceResult r = { .converged_ms = -1 };
+
+    if (wn > 0.0f) {
+        float s = sinf(wn * dt / 2) / wn;
+
+        dq[0] = cosf(wn * dt / 2);
+        dq[1] = w[0] * s;
+        dq[2] = w[1] * s;
+        dq[3] = w[2] * s;
+    }
+
+    ahrs_reset();
+    for (int i = 0; i < TRACE_SECONDS * MOTION_ODR_HZ; i++) {
+        float next[4], a[3], m[3], err;
+        AhrsOutput o;
+
+        quat_mul(q, dq, next);
+        memcpy(q, next, sizeof(q));
+        quat_to_sensor(q, gravity, a);
+        quat_to_sensor(q, field, m);
+        ahrs_update(w, a, use_mag ? m : NULL, dt);
+        ahrs_get(&o);
+
+        if (use_mag) {
+            float dot = fabsf(o.q[0] * q[0] + o.q[1] * q[1] + o.q[2] * q[2] + o.q[3] * q[3]);
+
+            err = 2.0f * acosf(fminf(1.0f, dot)) * DEG_PER_RAD;
+        } else {
+            // Sans magnétomètre, seule l'inclinaison est observable
+            float g_est[3];
+
+            quat_to_sensor(o.q, gravity, g_est);
+            err = acosf(fminf(1.0f, g_est[0] * a[0] + g_est[1] * a[1] + g_est[2] * a[2])) *
+                  DEG_PER_RAD;
+        }
+        if (err >= 2.0f) {
+            r.converged_ms = -1;
+        } else if (r.converged_ms < 0) {
+            r.converged_ms = i * 1000 / MOTION_ODR_HZ;
+        }
+        r.final_deg = err;
+    }
+    return r;
+}
+
+static void check_trace(const char *name, const float w[3], bool use_mag, int max_ms)
+{
+    TraceResult r = run_trace(w, use_mag);
+
+    zassert_true(r.converged_ms >= 0, "%s : pas de convergence (%.1f deg)", name,
+                 (double)r.final_deg);
+    zassert_true(r.converged_ms <= max_ms, "%s : < 2 deg apres %d ms", name, r.converged_ms);
+    zassert_true(r.final_deg < 1.2f, "%s : erreur finale %.2f deg", name, (double)r.final_deg);
+}
+
+ZTEST(ahrs, test_still)
+{
+    const float w[3] = { 0.0f, 0.0f, 0.0f };
+
+    check_trace("immobile", w, true, CONVERGE_MAX_MS);
+}
+
+ZTEST(ahrs, test_yaw_turn)
+{
+    const float w[3] = { 0.0f, 0.0f, 0.8f };  // rotation du poignet à plat
+
+    check_trace("lacet", w, true, CONVERGE_MAX_MS);
+}
+
+ZTEST(ahrs, test_tumble)
+{
+    const float w[3] = { 0.5f, -0.3f, 0.4f };
+
+    check_trace("libre", w, true, CONVERGE_MAX_MS);
+}
+
+ZTEST(ahrs, test_tumble_6axis_tilt)
+{
+    const float w[3] = { 0.5f, -0.3f, 0.4f };
+
+    check_trace("libre 6 axes", w, false, CONVERGE_MAX_MS);
+}
+
+/* Premier échantillon FIFO : orientation posée directement (gravité + champ) */
+ZTEST(ahrs, test_feed_primes_from_gravity_and_field)
+{
+    // Montre inclinée : 1 g réparti sur y et z, champ au nord (repère LIS2MDL)
+    const float tilt = 30.0f / DEG_PER_RAD;
+    MotionSample s = {
+        .timestamp_us = 1000,
+        .accel = {
+            0,
+            (int16_t)(sinf(tilt) * 1e6f / MOTION_ACCEL_UG_PER_LSB),
+            (int16_t)(cosf(tilt) * 1e6f / MOTION_ACCEL_UG_PER_LSB),
+        },
+    };
+    MagSample m = { .timestamp_us = 1000 };
+    AhrsOutput o;
+
+    ahrs_reset();
+    // Champ horizontal vers le nord dans le repère IMU, vu par le LIS2MDL (NWU)
+    m.magn[0].val2 = 0;
+    m.magn[1].val2 = -300000;
+    ahrs_set_mag(&m);
+    ahrs_feed(&s, 1);
+    ahrs_get(&o);
+
+    // Roulis de 30° retrouvé sans attendre la convergence du filtre
+    zassert_within(o.euler_deg[0], 30.0f, 1.0f, "roulis %.2f", (double)o.euler_deg[0]);
+    zassert_within(o.euler_deg[1], 0.0f, 1.0f, "tangage %.2f", (double)o.euler_deg[1]);
+    for (int i = 0; i < 3; i++) {
+        zassert_within(o.lin_accel[i], 0.0f, 0.1f, "acceleration lineaire %d", i);
+    }
+}
+
+ZTEST_SUITE(ahrs, NULL, NULL, NULL, NULL, NULL);
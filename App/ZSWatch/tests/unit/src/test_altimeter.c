@@ -0,0 +1,92 @@
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+#include <math.h>
+#include "altimeter.h"
+#include "synth_trace.h"
+
+/* Escalier de synth_trace.h rejoué par lots de 100 ms, comme la boucle principale */
+#define BASE_M   300.0f
+
+typedef struct {
+    AltimeterInfo info;
+    float alt_rms_m;    // écart-type de l'erreur d'altitude (hors décalage constant)
+    float speed_rms_ms;
+} TraceResult;
+
+static TraceResult run_stairs(bool use_imu)
+{
+    static MotionSample imu[SYNTH_BATCH_LEN];
+    static EnvSample press[SYNTH_BATCH_LEN];
+    float err_h = 0.0f, err_h2 = 0.0f, err_v2 = 0.0f;
+    int n_imu, n_press, n_err = 0;
+    SynthStairs st;
+    TraceResult r;
+
+    altimeter_reset();
+    synth_stairs_init(&st, use_imu);
+    while (synth_stairs_batch(&st, imu, &n_imu, press, &n_press)) {
+        altimeter_feed(imu, n_imu, press, n_press);
+        altimeter_get(&r.info);
+        if (st.t_us > 2000000) {  // après la convergence initiale
+            err_h += r.info.altitude_m - st.h;
+            err_h2 += (r.info.altitude_m - st.h) * (r.info.altitude_m - st.h);
+            err_v2 += (r.info.vspeed_ms - st.v) * (r.info.vspeed_ms - st.v);
+            n_err++;
+        }
+    }
+
+    // Altitude relative au premier échantillon (bruité) : sans le décalage constant
+    float mean_h = err_h / n_err;
+
+    altimeter_get(&r.info);
+    r.alt_rms_m = sqrtf(MAX(err_h2 / n_err - mean_h * mean_h, 0.0f));
+    r.speed_rms_ms = sqrtf(err_v2 / n_err);
+    return r;
+}
+
+ZTEST(altimeter, test_stairs_fusion)
+{
+    TraceResult r = run_stairs(true);
+
+    zassert_equal(r.info.floors_up, SYNTH_STAIRS_UP, "etages montes %u", r.info.floors_up);
+    zassert_equal(r.info.floors_down, SYNTH_STAIRS_DOWN, "etages descendus %u", r.info.floors_down);
+    zassert_true(r.alt_rms_m < 0.05f, "altitude %f m", (double)r.alt_rms_m);
+    zassert_true(r.speed_rms_ms < 0.10f, "vitesse %f m/s", (double)r.speed_rms_ms);
+}
+
+/* Accéléromètre en veille : prédiction à accélération nulle */
+ZTEST(altimeter, test_stairs_baro_only)
+{
+    TraceResult r = run_stairs(false);
+
+    zassert_equal(r.info.floors_up, SYNTH_STAIRS_UP, "etages montes %u", r.info.floors_up);
+    zassert_equal(r.info.floors_down, SYNTH_STAIRS_DOWN, "etages descendus %u", r.info.floors_down);
+    zassert_true(r.alt_rms_m < 0.05f, "altitude %f m", (double)r.alt_rms_m);
+    zassert_true(r.speed_rms_ms < 0.15f, "vitesse %f m/s", (double)r.speed_rms_ms);
+}
+
+/* Montre posée pendant 3 h de baisse météo (1 hPa/3 h, ~8 m) : aucun étage */
+ZTEST(altimeter, test_weather_drift_not_counted)
+{
+    static EnvSample press[10];
+    const int64_t end_us = 3LL * 3600 * 1000000;
+    const float drift_ms = 8.3f / (3 * 3600);
+    uint32_t lcg = 99;
+    AltimeterInfo info;
+
+    altimeter_reset();
+    for (int64_t t_us = 0; t_us < end_us; t_us += 100000) {
+        for (int k = 0; k < 10; k++) {
+            int64_t ts = t_us + k * (1000000 / ENV_PRESS_ODR_HZ);
+
+            synth_pressure(&press[k], ts, synth_baro_pa(BASE_M + drift_ms * ts * 1e-6f) +
+                           1.5f * synth_noise(&lcg));
+        }
+        altimeter_feed(NULL, 0, press, 10);
+    }
+    altimeter_get(&info);
+    zassert_equal(info.floors_up, 0, "etages montes %u", info.floors_up);
+    zassert_equal(info.floors_down, 0, "etages descendus %u", info.floors_down);
+}
+
+ZTEST_SUITE(altimeter, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,70 @@
+#include <zephyr/ztest.h>
+#include <zephyr/sys/byteorder.h>
+#include "ble.h"
+
+/*
+ * Décodage côté central de la trame "sensor frame", écrit d'après le
+ * format documenté dans ble.h et appliqué à la sortie de ble_frame_pack().
+ */
+typedef struct {
+    uint16_t seq;
+    uint32_t time_ms;
+    BleSensorFrame f;
+} DecodedFrame;
+
+static void decode(const uint8_t *p, DecodedFrame *d)
+{
+    d->seq = sys_get_le16(&p[0]);
+    d->time_ms = sys_get_le32(&p[2]);
+    d->f.temp_100 = (int16_t)sys_get_le16(&p[6]);
+    d->f.humi_100 = sys_get_le16(&p[8]);
+    d->f.pressure = sys_get_le32(&p[10]);
+    for (int i = 0; i < 3; i++) {
+        d->f.accel_100[i] = (int16_t)sys_get_le16(&p[14 + 2 * i]);
+        d->f.mag_100[i] = (int16_t)sys_get_le16(&p[20 + 2 * i]);
+    }
+}
+
+ZTEST(ble_frame, test_round_trip)
+{
+    const BleSensorFrame f = {
+        .temp_100 = -1234,
+        .humi_100 = 6543,
+        .pressure = 101325,
+        .accel_100 = { -981, 12, 32767 },
+        .mag_100 = { -32768, 45, -7 },
+    };
+    uint8_t buf[BLE_SENSOR_FRAME_SIZE + 1];
+    DecodedFrame d;
+
+    buf[BLE_SENSOR_FRAME_SIZE] = 0xA5;  // garde : pas d'écriture au-delà de la trame
+    ble_frame_pack(buf, 0xBEEF, 0x12345678, &f);
+    decode(buf, &d);
+
+    zassert_equal(buf[BLE_SENSOR_FRAME_SIZE], 0xA5, "debordement de la trame");
+    zassert_equal(d.seq, 0xBEEF);
+    zassert_equal(d.time_ms, 0x12345678);
+    zassert_equal(d.f.temp_100, f.temp_100);
+    zassert_equal(d.f.humi_100, f.humi_100);
+    zassert_equal(d.f.pressure, f.pressure);
+    for (int i = 0; i < 3; i++) {
+        zassert_equal(d.f.accel_100[i], f.accel_100[i], "accel %d", i);
+        zassert_equal(d.f.mag_100[i], f.mag_100[i], "mag %d", i);
+    }
+}
+
+ZTEST(ble_frame, test_little_endian_layout)
+{
+    const BleSensorFrame f = { .pressure = 0x00018BCD };
+    uint8_t buf[BLE_SENSOR_FRAME_SIZE];
+
+    ble_frame_pack(buf, 0x0102, 0, &f);
+    zassert_equal(buf[0], 0x02);
+    zassert_equal(buf[1], 0x01);
+    zassert_equal(buf[10], 0xCD);
+    zassert_equal(buf[11], 0x8B);
+    zassert_equal(buf[12], 0x01);
+    zassert_equal(buf[13], 0x00);
+}
+
+ZTEST_SUITE(ble_frame, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,115 @@
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+#include "derived.h"
+#include "sensor_bus.h"
+
+#define ROUNDS 1000
+
+static void before(void *fixture)
+{
+    derived_reset();
+}
+
+/* Publications sans lecteur : aucun calcul */
+ZTEST(derived, test_no_reader_no_eval)
+{
+    DerivedStats st;
+
+    for (int i = 0; i < ROUNDS; i++) {
+        int32_t t = 2000 + i % 500, h = 5000 + i % 300;
+        int32_t a[3] = { i % 50, -(i % 30), 981 };
+
+        derived_publish(DERIVED_IN_TEMP, &t, 1);
+        derived_publish(DERIVED_IN_HUMI, &h, 1);
+        derived_publish(DERIVED_IN_ACCEL, a, 3);
+    }
+    for (int m = 0; m < DERIVED_COUNT; m++) {
+        derived_get_stats(m, &st);
+        zassert_equal(st.evals, 0, "%s : %u calculs", derived_name(m), st.evals);
+        zassert_equal(st.reads, 0);
+    }
+}
+
+/* Un lecteur, température modifiée une fois sur 10 : un calcul par changement */
+ZTEST(derived, test_eval_only_on_change)
+{
+    DerivedStats st;
+    int32_t v;
+
+    for (int i = 0; i < ROUNDS; i++) {
+        int32_t t = 1500 + i / 10, h = 6000;
+
+        derived_publish(DERIVED_IN_TEMP, &t, 1);
+        derived_publish(DERIVED_IN_HUMI, &h, 1);
+        zassert_ok(derived_get(DERIVED_DEW_POINT, &v));
+    }
+    derived_get_stats(DERIVED_DEW_POINT, &st);
+    zassert_equal(st.reads, ROUNDS);
+    zassert_equal(st.evals, ROUNDS / 10);
+
+    // Les grandeurs non lues n'ont rien coûté
+    derived_get_stats(DERIVED_HEAT_INDEX, &st);
+    zassert_equal(st.evals, 0);
+}
+
+ZTEST(derived, test_missing_input)
+{
+    int32_t v;
+
+    derived_publish(DERIVED_IN_TEMP, &(int32_t){ 2500 }, 1);
+    zassert_equal(derived_get(DERIVED_DEW_POINT, &v), -1);
+    zassert_equal(derived_get(DERIVED_ACCEL_NORM, &v), -1);
+}
+
+/* Valeurs de référence (Magnus, table NOAA) */
+ZTEST(derived, test_reference_values)
+{
+    int32_t dew, ah, hi, norm;
+
+    derived_publish(DERIVED_IN_TEMP, &(int32_t){ 2500 }, 1);
+    derived_publish(DERIVED_IN_HUMI, &(int32_t){ 6000 }, 1);
+    zassert_ok(derived_get(DERIVED_DEW_POINT, &dew));
+    zassert_ok(derived_get(DERIVED_ABS_HUMIDITY, &ah));
+    zassert_within(dew, 1669, 5, "rosee %d", dew);
+    zassert_within(ah, 1381, 5, "humidite absolue %d", ah);
+
+    derived_publish(DERIVED_IN_TEMP, &(int32_t){ 3200 }, 1);
+    derived_publish(DERIVED_IN_HUMI, &(int32_t){ 7000 }, 1);
+    zassert_ok(derived_get(DERIVED_HEAT_INDEX, &hi));
+    zassert_within(hi, 4040, 50, "ressenti %d", hi);  // NOAA : ~41 C
+
+    derived_publish(DERIVED_IN_ACCEL, (const int32_t[3]){ 0, 0, 981 }, 3);
+    zassert_ok(derived_get(DERIVED_ACCEL_NORM, &norm));
+    zassert_within(norm, 1000, 2, "|a| %d mg", norm);
+}
+
+/* Entrées copiées par le listener du bus capteurs, rien n'est calculé avant la lecture */
+ZTEST(derived, test_inputs_from_bus)
+{
+    static EnvSensor env;
+    static MotionSensor imu;
+    static MagSensor mag;
+    DerivedStats st;
+    int32_t dew;
+
+    env.hts_active = true;
+    env.temp_hts = (struct sensor_value){ 25, 0 };
+    env.humidity = (struct sensor_value){ 60, 0 };
+    imu.accel_on = true;
+    imu.accel[2] = (struct sensor_value){ 9, 810000 };
+    zassert_ok(sensor_bus_publish(&env, &imu, &mag));
+
+    derived_get_stats(DERIVED_DEW_POINT, &st);
+    zassert_equal(st.evals, 0);
+    zassert_ok(derived_get(DERIVED_DEW_POINT, &dew));
+    zassert_within(dew, 1669, 5, "rosee %d", dew);
+
+    // HTS221 en veille : les dernières valeurs restent en cache
+    env.hts_active = false;
+    zassert_ok(sensor_bus_publish(&env, &imu, &mag));
+    zassert_ok(derived_get(DERIVED_DEW_POINT, &dew));
+    derived_get_stats(DERIVED_DEW_POINT, &st);
+    zassert_equal(st.evals, 1);
+}
+
+ZTEST_SUITE(derived, NULL, NULL, before, NULL, NULL);
@@ -0,0 +1,96 @@
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+#include <string.h>
+#include "fall_detect.h"
+#include "synth_trace.h"
+
+/*
+ * Scénarios de synth_trace.h, livrés comme par la FIFO. Le handler tient
+ * lieu de ble_indicate_fall() : la latence mesurée va de l'échantillon
+ * d'impact à son appel.
+ */
+#define MAX_LATENCY_US  20000   // FALL_POLL_MS + une période + traitement
+
+static struct {
+    uint32_t phases[FALL_PHASE_RECOVERED + 1];
+    uint32_t latency_us;
+    uint8_t n_snap;
+} seen;
+
+static void handler(const FallEvent *e)
+{
+    seen.phases[e->phase]++;
+    if (e->phase == FALL_PHASE_IMPACT) {
+        seen.latency_us = e->latency_us;
+        seen.n_snap = e->n_snap;
+    }
+}
+
+static void replay(int scenario)
+{
+    static MotionSample fifo[128];
+    SynthFallReplay r;
+    uint32_t events;
+    FallInfo info;
+    int n;
+
+    memset(&seen, 0, sizeof(seen));
+    fall_detect_init(NULL, handler);
+    synth_fall_start(&r, &synth_falls[scenario]);
+    do {
+        fall_detect_get(&info);
+        n = synth_fall_read(&r, fifo, ARRAY_SIZE(fifo), info.armed, &events);
+        if (n > 0) {
+            fall_detect_feed(fifo, n, events);
+        }
+    } while (n > 0);
+}
+
+ZTEST(fall_detect, test_fall_confirmed)
+{
+    replay(SYNTH_FALL_CONFIRMED);
+    zassert_equal(seen.phases[FALL_PHASE_IMPACT], 1);
+    zassert_equal(seen.phases[FALL_PHASE_CONFIRMED], 1);
+    zassert_equal(seen.phases[FALL_PHASE_RECOVERED], 0);
+    zassert_true(seen.latency_us <= MAX_LATENCY_US, "latence %u us", seen.latency_us);
+    zassert_equal(seen.n_snap, FALL_SNAP_LEN);
+}
+
+ZTEST(fall_detect, test_fall_then_getup)
+{
+    replay(SYNTH_FALL_GETUP);
+    zassert_equal(seen.phases[FALL_PHASE_IMPACT], 1);
+    zassert_equal(seen.phases[FALL_PHASE_CONFIRMED], 0);
+    zassert_equal(seen.phases[FALL_PHASE_RECOVERED], 1);
+    zassert_true(seen.latency_us <= MAX_LATENCY_US, "latence %u us", seen.latency_us);
+}
+
+/* Saut : chute libre courte, réception sous le seuil d'impact */
+ZTEST(fall_detect, test_jump_no_alert)
+{
+    FallInfo info;
+
+    replay(SYNTH_FALL_JUMP);
+    zassert_equal(seen.phases[FALL_PHASE_IMPACT], 0);
+    fall_detect_get(&info);
+    zassert_false(info.armed);
+    zassert_equal(info.false_alarms, 1);
+}
+
+/* Geste brusque : pic sans chute libre, le détecteur n'est jamais armé */
+ZTEST(fall_detect, test_gesture_no_alert)
+{
+    FallInfo info;
+
+    replay(SYNTH_FALL_GESTURE);
+    zassert_equal(seen.phases[FALL_PHASE_IMPACT], 0);
+    fall_detect_get(&info);
+    zassert_equal(info.alerts, 0);
+}
+
+static void after(void *fixture)
+{
+    fall_detect_init(NULL, NULL);
+}
+
+ZTEST_SUITE(fall_detect, NULL, NULL, NULL, after, NULL);
@@ -0,0 +1,58 @@
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+#include <math.h>
+#include "forecast.h"
+#include "synth_trace.h"
+
+/* Dépression de synth_trace.h, vérifiée en fin de chaque segment */
+#define BATCH    10
+
+ZTEST(forecast, test_depression_trends)
+{
+    static EnvSample press[BATCH];
+    SynthWeather w;
+    int n, seg;
+
+    forecast_reset();
+    synth_weather_init(&w);
+    while ((n = synth_weather_batch(&w, press, BATCH, &seg)) > 0) {
+        ForecastInfo fc;
+
+        forecast_feed(press, n);
+        if (seg < 0) {
+            continue;
+        }
+        forecast_get(&fc);
+        zassert_true(fc.valid);
+        zassert_equal(fc.trend, synth_weather[seg].expected, "segment %d : %s", seg,
+                      forecast_trend_name(fc.trend));
+        zassert_within(fc.slope_pa_h, synth_weather[seg].pa_h, 0.1f, "segment %d : pente %f Pa/h",
+                       seg, (double)fc.slope_pa_h);
+        zassert_not_equal(fc.code, FORECAST_NONE);
+    }
+    zassert_equal(w.seg, SYNTH_WEATHER_SEGMENTS);
+}
+
+/* Première prévision après FORECAST_MIN_BINS tranches, pas avant */
+ZTEST(forecast, test_no_forecast_before_min_bins)
+{
+    EnvSample s = { .pressure = { .val1 = 101, .val2 = 325000 } };
+    ForecastInfo fc;
+
+    forecast_reset();
+    for (int64_t t = 0; t < (int64_t)(FORECAST_MIN_BINS - 1) * FORECAST_BIN_S; t += 10) {
+        s.timestamp_us = t * 1000000;
+        forecast_feed(&s, 1);
+    }
+    forecast_get(&fc);
+    zassert_false(fc.valid);
+}
+
+/* Dépression profonde qui se creuse : pire libellé, anticyclone stable : le meilleur */
+ZTEST(forecast, test_zambretti_extremes)
+{
+    zassert_equal(forecast_zambretti(105000, FORECAST_STEADY), 0);
+    zassert_equal(forecast_zambretti(95000, FORECAST_FALLING), 25);
+}
+
+ZTEST_SUITE(forecast, NULL, NULL, NULL, NULL, NULL);
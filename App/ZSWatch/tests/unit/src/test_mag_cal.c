@@ -0,0 +1,156 @@
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+#include <math.h>
+#include "mag_cal.h"
+
+/*
+ * Sphère synthétique de rayon FIELD_G déformée par un fer doux non
+ * diagonal puis décalée d'un fer dur supérieur au champ terrestre, avec
+ * un bruit uniforme de +/- NOISE_G (ordre de grandeur du LIS2MDL).
+ */
+#define FIELD_G     0.45f
+#define NOISE_G     0.002f
+#define N_SAMPLES   3000
+
+static const float hard[3] = { 0.6f, -0.35f, 0.2f };
+static const float soft[3][3] = {
+    { 1.15f, 0.08f, -0.05f },
+    { 0.08f, 0.90f, 0.04f },
+    { -0.05f, 0.04f, 1.05f },
+};
+
+static uint32_t rng = 12345;
+
+static float rand_unit(void)
+{
+    rng = rng * 1664525u + 1013904223u;
+    return (rng >> 8) * (1.0f / (1 << 24));  // [0, 1[
+}
+
+static void to_sample(const float v[3], MagSample *s)
+{
+    for (int i = 0; i < 3; i++) {
+        int32_t ug = (int32_t)lroundf(v[i] * 1e6f);
+
+        s->magn[i].val1 = ug / 1000000;
+        s->magn[i].val2 = ug % 1000000;
+    }
+}
+
+/* Champ mesuré pour une direction de la montre : hard + soft * (R u) + bruit */
+static void distorted(const float u[3], float noise, float out[3])
+{
+    for (int i = 0; i < 3; i++) {
+        out[i] = hard[i] + (2.0f * rand_unit() - 1.0f) * noise;
+        for (int j = 0; j < 3; j++) {
+            out[i] += soft[i][j] * FIELD_G * u[j];
+        }
+    }
+}
+
+static void random_dir(float u[3])
+{
+    float z = 2.0f * rand_unit() - 1.0f;
+    float a = 2.0f * 3.14159265f * rand_unit();
+    float r = sqrtf(1.0f - z * z);
+
+    u[0] = r * cosf(a);
+    u[1] = r * sinf(a);
+    u[2] = z;
+}
+
+static void before(void *fixture)
+{
+    mag_cal_reset();
+    rng = 12345;
+}
+
+/* Pas de calibration laissée aux autres suites (ahrs.c l'applique au champ) */
+static void after(void *fixture)
+{
+    mag_cal_reset();
+}
+
+ZTEST(mag_cal, test_identity_without_fit)
+{
+    float v[3] = { 0.1f, -0.2f, 0.3f }, out[3];
+    MagCalInfo info;
+
+    mag_cal_apply(v, out);
+    zassert_mem_equal(v, out, sizeof(v));
+    mag_cal_get_info(&info);
+    zassert_false(info.valid);
+}
+
+ZTEST(mag_cal, test_distorted_sphere)
+{
+    MagSample s;
+    MagCalInfo info;
+
+    for (int i = 0; i < N_SAMPLES; i++) {
+        float u[3], m[3];
+
+        random_dir(u);
+        distorted(u, NOISE_G, m);
+        to_sample(m, &s);
+        mag_cal_feed(&s, 1);
+    }
+    mag_cal_get_info(&info);
+    zassert_true(info.valid, "aucun ajustement accepte");
+    zassert_equal(info.coverage, 0xFF);
+    zassert_true(info.fits > 0);
+    zassert_true(info.cal.rms < MAG_CAL_MAX_RMS, "residu %f", (double)info.cal.rms);
+
+    // Fer dur retrouvé à 0.5 mG près (mesuré : 0.11 mG)
+    for (int i = 0; i < 3; i++) {
+        zassert_within(info.cal.offset[i], hard[i], 0.0005f, "offset[%d] = %f", i,
+                       (double)info.cal.offset[i]);
+    }
+
+    // Norme corrigée constante à 0.1 % sur des directions nouvelles (sans bruit)
+    float worst = 0.0f;
+    for (int i = 0; i < 500; i++) {
+        float u[3], m[3];
+
+        random_dir(u);
+        distorted(u, 0.0f, m);
+        mag_cal_apply(m, m);
+        float n = sqrtf(m[0] * m[0] + m[1] * m[1] + m[2] * m[2]);
+        worst = fmaxf(worst, fabsf(n / info.cal.radius - 1.0f));
+    }
+    zassert_true(worst < 0.001f, "ecart de norme %f", (double)worst);
+}
+
+/* Rotation dans un seul plan : octants non couverts, aucun ajustement */
+ZTEST(mag_cal, test_planar_motion_rejected)
+{
+    MagSample s;
+    MagCalInfo info;
+
+    for (int i = 0; i < N_SAMPLES; i++) {
+        float a = 2.0f * 3.14159265f * rand_unit();
+        float u[3] = { cosf(a), sinf(a), 0.0f }, m[3];
+
+        distorted(u, NOISE_G, m);
+        to_sample(m, &s);
+        mag_cal_feed(&s, 1);
+    }
+    mag_cal_get_info(&info);
+    zassert_false(info.valid);
+    zassert_equal(info.fits, 0);
+}
+
+/* Montre à plat, x vers le nord puis vers l'est (repère IMU, +z en haut) */
+ZTEST(mag_cal, test_heading)
+{
+    const float up[3] = { 0.0f, 0.0f, 1.0f };
+    const float north[3] = { 0.22f, 0.0f, -0.42f };
+    const float east[3] = { 0.0f, 0.22f, -0.42f };  // x à 90° à l'est du nord
+
+    zassert_within(mag_cal_heading(up, north), 0.0f, 0.1f);
+    float h = mag_cal_heading(up, east);
+    zassert_within(h, 90.0f, 0.1f, "cap %f", (double)h);
+    zassert_equal(mag_cal_heading((const float[3]){ 0 }, north), -1.0f);
+}
+
+ZTEST_SUITE(mag_cal, NULL, NULL, before, after, NULL);
@@ -0,0 +1,301 @@
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/emul.h>
+#include <zephyr/drivers/i2c.h>
+#include <zephyr/drivers/i2c_emul.h>
+#include <zephyr/drivers/gpio/gpio_emul.h>
+#include <zephyr/sys/byteorder.h>
+#include <errno.h>
+#include <string.h>
+#include "motion_sensor.h"
+#include "timebase.h"
+
+/*
+ * Lecture de la FIFO du LSM6DSO (motion_fifo_drain) sur le contrôleur I2C
+ * émulé de native_sim : un émulateur minimal répond aux registres FIFO
+ * (niveau, mots étiquetés accéléro / gyro, vidage en bypass) et pilote
+ * INT1 selon le seuil programmé. Le driver Zephyr est remplacé par un
+ * device sans effet (CONFIG_LSM6DSO=n) : seules les lectures directes de
+ * motion_sensor.c passent par le bus.
+ */
+#define LSM6DSO_NODE  DT_NODELABEL(lsm6dso)
+
+#define REG_FIFO_CTRL1     0x07
+#define REG_FIFO_CTRL2     0x08
+#define REG_FIFO_CTRL3     0x09
+#define REG_FIFO_CTRL4     0x0A
+#define REG_FIFO_STATUS1   0x3A
+#define REG_FIFO_DATA_OUT  0x78
+
+#define TAG_GYRO           0x01
+#define TAG_ACCEL          0x02
+#define WORD_SIZE          7
+#define WATERMARK          CONFIG_ZSWATCH_MOTION_FIFO_WATERMARK
+#define BURST_WORDS        (2 * WATERMARK)   // plafond d'une rafale (accéléro + gyro)
+#define PERIOD_US          (1000000 / MOTION_ODR_HZ)
+// Durée d'une rafale sur le bus à 400 kHz (9 bits par octet)
+#define BUS_US_PER_WORD    (WORD_SIZE * 9 * 1000000 / 400000)
+
+static const struct gpio_dt_spec int1 = GPIO_DT_SPEC_GET(LSM6DSO_NODE, irq_gpios);
+
+static struct {
+    uint8_t regs[0x80];
+    uint16_t level;          // mots dans la FIFO
+    uint32_t popped;         // mots lus depuis le dernier vidage
+    int64_t level_read_us;   // première lecture d'un niveau non nul
+    uint32_t bursts;
+    uint32_t max_burst_words;
+} fifo;
+
+static bool fifo_gyro_on(void)
+{
+    return (fifo.regs[REG_FIFO_CTRL3] >> 4) != 0;
+}
+
+static uint16_t fifo_watermark(void)
+{
+    return fifo.regs[REG_FIFO_CTRL1] | ((fifo.regs[REG_FIFO_CTRL2] & 0x01) << 8);
+}
+
+/* INT1 (FIFO_TH) suit le niveau, comme le composant */
+static void fifo_update_int1(void)
+{
+    gpio_emul_input_set(int1.port, int1.pin, fifo.level >= fifo_watermark());
+}
+
+/* Mot suivant : échantillon k = {k, -k, 1000 + k}, gyro = {2000 + k, ...} */
+static void fifo_pop_word(uint8_t *p)
+{
+    int per_sample = fifo_gyro_on() ? 2 : 1;
+    int16_t k = fifo.popped / per_sample;
+    bool gyro = (fifo.popped % per_sample) == 1;
+    int16_t base = gyro ? 2000 : 0;
+
+    p[0] = (gyro ? TAG_GYRO : TAG_ACCEL) << 3;
+    sys_put_le16(base + k, &p[1]);
+    sys_put_le16(base - k, &p[3]);
+    sys_put_le16(base + 1000 + k, &p[5]);
+    fifo.popped++;
+    fifo.level--;
+}
+
+static int fifo_emul_transfer(const struct emul *target, struct i2c_msg *msgs, int num_msgs,
+                              int addr)
+{
+    if (num_msgs < 1 || (msgs[0].flags & I2C_MSG_READ) || msgs[0].len < 1) {
+        return -EIO;
+    }
+
+    uint8_t reg = msgs[0].buf[0];
+
+    // Écriture de registres
+    if (num_msgs == 1) {
+        for (uint32_t i = 1; i < msgs[0].len; i++) {
+            fifo.regs[(reg + i - 1) & 0x7F] = msgs[0].buf[i];
+        }
+        // Passage en bypass : FIFO vidée
+        if (reg == REG_FIFO_CTRL4 && (msgs[0].buf[1] & 0x07) == 0) {
+            fifo.level = 0;
+            fifo.popped = 0;
+        }
+        return 0;
+    }
+
+    struct i2c_msg *rd = &msgs[1];
+
+    if (num_msgs != 2 || !(rd->flags & I2C_MSG_READ)) {
+        return -EIO;
+    }
+
+    if (reg == REG_FIFO_STATUS1) {
+        rd->buf[0] = fifo.level & 0xFF;
+        if (rd->len > 1) {
+            rd->buf[1] = (fifo.level >> 8) & 0x03;
+        }
+        if (fifo.level > 0 && fifo.level_read_us < 0) {
+            fifo.level_read_us = timebase_now_us();
+        }
+    } else if (reg == REG_FIFO_DATA_OUT) {
+        uint32_t words = rd->len / WORD_SIZE;
+
+        if (rd->len % WORD_SIZE != 0 || words > fifo.level) {
+            return -EIO;
+        }
+        for (uint32_t w = 0; w < words; w++) {
+            fifo_pop_word(&rd->buf[w * WORD_SIZE]);
+        }
+        fifo.bursts++;
+        fifo.max_burst_words = MAX(fifo.max_burst_words, words);
+        k_busy_wait(words * BUS_US_PER_WORD);
+        fifo_update_int1();
+    } else {
+        for (uint32_t i = 0; i < rd->len; i++) {
+            rd->buf[i] = fifo.regs[(reg + i) & 0x7F];
+        }
+    }
+    return 0;
+}
+
+static int fifo_emul_init(const struct emul *target, const struct device *parent)
+{
+    return 0;
+}
+
+static const struct i2c_emul_api fifo_emul_api = {
+    .transfer = fifo_emul_transfer,
+};
+
+EMUL_DT_DEFINE(LSM6DSO_NODE, fifo_emul_init, NULL, NULL, &fifo_emul_api, NULL);
+
+/* Device LSM6DSO sans driver : ODR et pleine échelle acceptés sans effet */
+static int fake_attr_set(const struct device *dev, enum sensor_channel chan,
+                         enum sensor_attribute attr, const struct sensor_value *val)
+{
+    return 0;
+}
+
+static const struct sensor_driver_api fake_lsm6dso_api = {
+    .attr_set = fake_attr_set,
+};
+
+DEVICE_DT_DEFINE(LSM6DSO_NODE, NULL, NULL, NULL, NULL, POST_KERNEL,
+                 CONFIG_SENSOR_INIT_PRIORITY, &fake_lsm6dso_api);
+
+/* ==================== Rejeu ==================== */
+static MotionSensor imu;
+static MotionSample out[MOTION_BUF_LEN];
+
+static struct {
+    uint32_t calls;
+    uint32_t samples;
+    int max_n;
+} seen;
+
+static void listener(const MotionSample *samples, int n, uint32_t events)
+{
+    seen.calls++;
+    seen.samples += n;
+    seen.max_n = MAX(seen.max_n, n);
+}
+
+/* Ajoute n échantillons complets ; INT1 monte au seuil et lance la lecture */
+static void fifo_fill(int n)
+{
+    fifo.level += n * (fifo_gyro_on() ? 2 : 1);
+    fifo_update_int1();
+}
+
+static int drain(void)
+{
+    struct k_work_sync sync;
+
+    k_work_flush(&imu.fifo_work, &sync);
+    return motion_fifo_read(&imu, out, ARRAY_SIZE(out));
+}
+
+static void check_samples(int n, bool gyro)
+{
+    for (int i = 0; i < n; i++) {
+        zassert_equal(out[i].accel[0], i, "échantillon %d", i);
+        zassert_equal(out[i].accel[1], -i);
+        zassert_equal(out[i].accel[2], 1000 + i);
+        zassert_equal(out[i].gyro[0], gyro ? 2000 + i : 0, "échantillon %d", i);
+    }
+}
+
+ZTEST(motion_fifo, test_watermark_drain)
+{
+    uint32_t bursts = imu.bursts;
+
+    fifo_fill(WATERMARK);
+    zassert_equal(drain(), WATERMARK);
+    check_samples(WATERMARK, true);
+
+    zassert_equal(fifo.level, 0);
+    zassert_equal(fifo.bursts, 1);
+    zassert_equal(fifo.max_burst_words, BURST_WORDS);
+    zassert_equal(imu.bursts - bursts, 1);
+    zassert_equal(gpio_pin_get_dt(&int1), 0);
+    zassert_equal(seen.calls, 1);
+    zassert_equal(seen.samples, WATERMARK);
+}
+
+/* FIFO remplie pendant un blocage : plusieurs rafales plafonnées, un seul niveau lu */
+ZTEST(motion_fifo, test_multi_burst)
+{
+    const int n = 3 * WATERMARK + WATERMARK / 2;
+
+    fifo_fill(n);
+    zassert_equal(drain(), n);
+    check_samples(n, true);
+
+    zassert_equal(fifo.bursts, 4, "%u rafales", fifo.bursts);
+    zassert_equal(fifo.max_burst_words, BURST_WORDS);
+    zassert_equal(seen.calls, 4);
+    zassert_equal(seen.samples, n);
+    zassert_equal(seen.max_n, WATERMARK);
+}
+
+/* Horodatage à rebours depuis la lecture du niveau, malgré la durée des rafales */
+ZTEST(motion_fifo, test_timestamps)
+{
+    const int n = 3 * WATERMARK + WATERMARK / 2;
+
+    fifo_fill(n);
+    zassert_equal(drain(), n);
+
+    for (int i = 1; i < n; i++) {
+        zassert_equal(out[i].timestamp_us - out[i - 1].timestamp_us, PERIOD_US,
+                      "écart %d", i);
+    }
+    zassert_true(out[n - 1].timestamp_us >= fifo.level_read_us);
+    zassert_true(out[n - 1].timestamp_us - fifo.level_read_us < PERIOD_US,
+                 "dernier échantillon %lld us après la lecture du niveau",
+                 (long long)(out[n - 1].timestamp_us - fifo.level_read_us));
+    // Les rafales suivantes ont pris du temps : pas d'horodatage au moment de leur lecture
+    zassert_true(timebase_now_us() - fifo.level_read_us >= 3 * BURST_WORDS * BUS_US_PER_WORD);
+}
+
+/* Mot isolé (gyro pas encore écrit) : laissé pour la lecture suivante */
+ZTEST(motion_fifo, test_incomplete_sample_left)
+{
+    fifo.level = 2 * WATERMARK + 1;
+    fifo_update_int1();
+    zassert_equal(drain(), WATERMARK);
+    zassert_equal(fifo.level, 1);
+}
+
+/* Gyroscope coupé : un mot accéléro par échantillon, lecture demandée avant le seuil */
+ZTEST(motion_fifo, test_accel_only)
+{
+    zassert_ok(motion_set_active(&imu, true, false));
+    fifo_fill(WATERMARK / 2);
+    motion_fifo_kick(&imu);
+    zassert_equal(drain(), WATERMARK / 2);
+    check_samples(WATERMARK / 2, false);
+    zassert_equal(fifo.bursts, 1);
+    zassert_equal(fifo.max_burst_words, WATERMARK / 2);
+    zassert_ok(motion_set_active(&imu, true, true));
+}
+
+static void *motion_fifo_setup(void)
+{
+    zassert_ok(motion_init(&imu));
+    motion_set_listener(&imu, listener);
+    return NULL;
+}
+
+static void motion_fifo_before(void *fixture)
+{
+    // Passage en bypass et retour en stream : FIFO vide
+    zassert_ok(motion_set_active(&imu, true, true));
+    fifo_update_int1();
+    drain();
+    fifo.level_read_us = -1;
+    fifo.bursts = 0;
+    fifo.max_burst_words = 0;
+    memset(&seen, 0, sizeof(seen));
+}
+
+ZTEST_SUITE(motion_fifo, NULL, motion_fifo_setup, motion_fifo_before, NULL, NULL);
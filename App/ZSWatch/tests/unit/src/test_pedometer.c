@@ -0,0 +1,75 @@
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+#include "pedometer.h"
+#include "synth_trace.h"
+
+/*
+ * Traces de marche de synth_trace.h, par lots de 100 ms comme la boucle
+ * principale. Les PEDOMETER_CONFIRM_STEPS premiers pas sont validés en
+ * bloc : l'écart toléré couvre le premier et le dernier pas.
+ */
+#define STEP_TOL_PCT     3
+#define CADENCE_TOL_SPM  5
+
+static void replay(int trace, PedometerInfo *info)
+{
+    static MotionSample batch[SYNTH_BATCH_LEN];
+    SynthWalkReplay r;
+    int n;
+
+    pedometer_reset();
+    synth_walk_start(&r, &synth_walks[trace]);
+    while ((n = synth_walk_batch(&r, batch, ARRAY_SIZE(batch))) > 0) {
+        pedometer_feed(batch, n);
+    }
+    pedometer_get(info);
+}
+
+static void check_walk(int trace)
+{
+    const SynthWalk *w = &synth_walks[trace];
+    const uint32_t expected = w->hz * w->seconds;
+    const uint16_t cadence = w->hz * 60;
+    PedometerInfo info;
+
+    replay(trace, &info);
+    zassert_within(info.steps, expected, expected * STEP_TOL_PCT / 100, "%s : %u pas / %u",
+                   w->name, info.steps, expected);
+    zassert_true(info.walking, "%s", w->name);
+    zassert_within(info.cadence_spm, cadence, CADENCE_TOL_SPM, "%s : %u pas/min / %u", w->name,
+                   info.cadence_spm, cadence);
+    zassert_true(info.distance_cm > 0);
+}
+
+ZTEST(pedometer, test_rest)
+{
+    PedometerInfo info;
+
+    replay(SYNTH_WALK_REST, &info);
+    zassert_equal(info.steps, 0, "%u pas au repos", info.steps);
+    zassert_false(info.walking);
+    zassert_equal(info.cadence_spm, 0);
+}
+
+ZTEST(pedometer, test_walk)
+{
+    check_walk(SYNTH_WALK_WALK);
+}
+
+ZTEST(pedometer, test_run)
+{
+    check_walk(SYNTH_WALK_RUN);
+}
+
+/* La foulée s'allonge avec la cadence (41 % de la taille en marche, jusqu'à 65 % en course) */
+ZTEST(pedometer, test_stride_grows_with_cadence)
+{
+    PedometerInfo walk, run;
+
+    replay(SYNTH_WALK_WALK, &walk);
+    replay(SYNTH_WALK_RUN, &run);
+    zassert_true(run.distance_cm / run.steps > walk.distance_cm / walk.steps, "%u / %u cm",
+                 run.distance_cm / run.steps, walk.distance_cm / walk.steps);
+}
+
+ZTEST_SUITE(pedometer, NULL, NULL, NULL, NULL, NULL);
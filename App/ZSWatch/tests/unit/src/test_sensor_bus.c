@@ -0,0 +1,225 @@
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+#include <string.h>
+#include "sensor_bus.h"
+#include "timebase.h"
+
+/*
+ * Mesures du bus capteurs (équivalent de bench_bus() sur native_sim) :
+ * latence listener / subscriber, rafale plus rapide que le subscriber,
+ * coût mémoire, et lot pleine cadence de sensor_bus_publish_batch().
+ * Sur native_sim le temps simulé n'avance pas pendant l'exécution : les
+ * latences mesurent l'ordonnancement, pas le coût CPU de la cible.
+ */
+#define ROUNDS       100
+#define BURST        16
+#define SUB_DEPTH    4
+#define PERIOD_MS    2
+#define LISTENER_MAX_US    500
+#define SUBSCRIBER_MAX_US  (PERIOD_MS * 1000)
+
+static struct {
+    uint32_t n;
+    uint32_t sum;
+    uint32_t max;
+} lat[2];
+static uint32_t last_seq;
+
+static void lat_add(int i, uint32_t pub_cycles)
+{
+    uint32_t us = k_cyc_to_us_floor32(k_cycle_get_32() - pub_cycles);
+
+    lat[i].n++;
+    lat[i].sum += us;
+    lat[i].max = MAX(lat[i].max, us);
+}
+
+ZBUS_CHAN_DEFINE(test_bus_chan, SensorEnvMsg, NULL, NULL, ZBUS_OBSERVERS_EMPTY,
+                 ZBUS_MSG_INIT(0));
+
+static void test_bus_cb(const struct zbus_channel *chan)
+{
+    const SensorEnvMsg *e = zbus_chan_const_msg(chan);
+
+    lat_add(0, e->hdr.pub_cycles);
+}
+
+ZBUS_LISTENER_DEFINE(test_bus_lis, test_bus_cb);
+ZBUS_SUBSCRIBER_DEFINE(test_bus_sub, SUB_DEPTH);
+ZBUS_CHAN_ADD_OBS(test_bus_chan, test_bus_lis, SENSOR_BUS_PRIO_CONSOLE);
+ZBUS_CHAN_ADD_OBS(test_bus_chan, test_bus_sub, SENSOR_BUS_PRIO_BLE);
+
+static void test_bus_thread(void *p1, void *p2, void *p3)
+{
+    const struct zbus_channel *chan;
+
+    while (zbus_sub_wait(&test_bus_sub, &chan, K_FOREVER) == 0) {
+        SensorEnvMsg e;
+
+        if (zbus_chan_read(chan, &e, K_MSEC(10)) == 0) {
+            lat_add(1, e.hdr.pub_cycles);
+            last_seq = e.hdr.seq;
+        }
+    }
+}
+
+K_THREAD_DEFINE(test_bus_tid, 768, test_bus_thread, NULL, NULL, NULL,
+                SENSOR_BUS_THREAD_PRIO, 0, 0);
+
+// Lot reçu par le listener de sensor_batch_chan
+static SensorBatchMsg batch_seen;
+static MotionSample batch_first;
+static uint32_t batch_calls;
+
+static void test_batch_cb(const struct zbus_channel *chan)
+{
+    const SensorBatchMsg *b = zbus_chan_const_msg(chan);
+
+    batch_seen = *b;
+    if (b->n_imu > 0) {
+        batch_first = b->imu[0];  // tampons valides pendant la publication seulement
+    }
+    batch_calls++;
+}
+
+ZBUS_LISTENER_DEFINE(test_batch_lis, test_batch_cb);
+ZBUS_CHAN_ADD_OBS(sensor_batch_chan, test_batch_lis, SENSOR_BUS_PRIO_ALGO);
+
+static void before(void *fixture)
+{
+    // Le subscriber vide sa file avant chaque test
+    k_sleep(K_MSEC(10));
+    memset(lat, 0, sizeof(lat));
+}
+
+/* Publications espacées : tout est reçu, dans les bornes de latence */
+ZTEST(sensor_bus, test_spaced_latency)
+{
+    SensorEnvMsg e = { 0 };
+    uint32_t failed = 0;
+
+    for (int i = 0; i < ROUNDS; i++) {
+        e.hdr.seq = i + 1;
+        e.hdr.pub_cycles = k_cycle_get_32();
+        failed += zbus_chan_pub(&test_bus_chan, &e, K_MSEC(5)) != 0;
+        k_sleep(K_MSEC(PERIOD_MS));  // le subscriber consomme avant la suivante
+    }
+    for (int i = 0; i < 2; i++) {
+        TC_PRINT("%s : %u/%u recus | latence moy. %u us, max %u us\n",
+                 i ? "subscriber" : "listener", lat[i].n, ROUNDS,
+                 lat[i].n ? lat[i].sum / lat[i].n : 0, lat[i].max);
+    }
+    zassert_equal(failed, 0);
+    zassert_equal(lat[0].n, ROUNDS, "listener : %u", lat[0].n);
+    zassert_equal(lat[1].n, ROUNDS, "subscriber : %u", lat[1].n);
+    zassert_equal(last_seq, ROUNDS);
+    zassert_true(lat[0].max < LISTENER_MAX_US, "listener : %u us", lat[0].max);
+    zassert_true(lat[1].max < SUBSCRIBER_MAX_US, "subscriber : %u us", lat[1].max);
+}
+
+/* Rafale sans céder la main : la file du subscriber déborde, la dernière valeur reste lue */
+ZTEST(sensor_bus, test_burst_overflow)
+{
+    SensorEnvMsg e = { 0 };
+    uint32_t failed = 0;
+
+    for (int i = 0; i < BURST; i++) {
+        e.hdr.seq = ROUNDS + i + 1;
+        e.hdr.pub_cycles = k_cycle_get_32();
+        failed += zbus_chan_pub(&test_bus_chan, &e, K_NO_WAIT) != 0;
+    }
+    k_sleep(K_MSEC(20));
+    TC_PRINT("rafale %d (file %d) : listener %u | subscriber %u | perdues %u | "
+             "derniere valeur %u/%u\n", BURST, SUB_DEPTH, lat[0].n, lat[1].n, failed,
+             last_seq - ROUNDS, BURST);
+
+    zassert_equal(lat[0].n, BURST, "les listeners ne perdent rien");
+    zassert_equal(lat[1].n, SUB_DEPTH);
+    zassert_equal(failed, BURST - SUB_DEPTH);
+    zassert_equal(last_seq, ROUNDS + BURST);
+}
+
+/* Coût mémoire : messages copiés dans les canaux, lot passé par pointeurs */
+ZTEST(sensor_bus, test_memory)
+{
+    uint32_t chan_bytes = sizeof(struct zbus_channel) + sizeof(struct zbus_channel_data);
+    uint32_t obs_bytes = sizeof(struct zbus_observer) + sizeof(struct zbus_channel_observation);
+
+    TC_PRINT("canal %u + message (env %u, motion %u, mag %u, lot %u) octets | "
+             "observateur %u octets | %u octets/notification en file\n",
+             chan_bytes, (unsigned)sizeof(SensorEnvMsg), (unsigned)sizeof(SensorMotionMsg),
+             (unsigned)sizeof(SensorMagMsg), (unsigned)sizeof(SensorBatchMsg), obs_bytes,
+             (unsigned)sizeof(struct zbus_channel *));
+
+    zassert_true(sizeof(SensorEnvMsg) <= 48);
+    zassert_true(sizeof(SensorMotionMsg) <= 48);
+    zassert_true(sizeof(SensorMagMsg) <= 48);
+    // Le lot ne copie pas les échantillons
+    zassert_true(sizeof(SensorBatchMsg) <= 64, "lot : %u octets", (unsigned)sizeof(SensorBatchMsg));
+}
+
+/* Lot pleine cadence : livré aux listeners dans l'appel, compté dans les stats */
+ZTEST(sensor_bus, test_publish_batch)
+{
+    static MotionSample imu[8];
+    static EnvSample press[2];
+    SensorBusStats before_st, after_st;
+
+    for (size_t i = 0; i < ARRAY_SIZE(imu); i++) {
+        imu[i].timestamp_us = 1000 * i;
+    }
+    imu[0].accel[2] = 4096;
+
+    sensor_bus_get_stats(&before_st);
+    uint32_t calls = batch_calls;
+
+    SensorBatchMsg b = {
+        .imu = imu, .n_imu = ARRAY_SIZE(imu),
+        .press = press, .n_press = ARRAY_SIZE(press),
+        .accel_on = true, .dashboard = true,
+    };
+    zassert_ok(sensor_bus_publish_batch(&b));
+    uint32_t seq = batch_seen.hdr.seq;
+    zassert_ok(sensor_bus_publish_batch(&b));
+
+    sensor_bus_get_stats(&after_st);
+    zassert_equal(batch_calls, calls + 2);
+    zassert_equal(batch_seen.hdr.seq, seq + 1);
+    zassert_equal(batch_seen.n_imu, ARRAY_SIZE(imu));
+    zassert_equal(batch_seen.n_press, ARRAY_SIZE(press));
+    zassert_equal(batch_seen.n_mag, 0);
+    zassert_true(batch_seen.accel_on && batch_seen.dashboard);
+    zassert_equal(batch_first.accel[2], 4096);
+    zassert_equal(after_st.batches, before_st.batches + 2);
+    zassert_equal(after_st.failed, before_st.failed);
+    zassert_equal(after_st.published, before_st.published);
+}
+
+/* En-tête du lot : échantillon le plus récent, instant de publication si lot vide */
+ZTEST(sensor_bus, test_batch_timestamp)
+{
+    static MotionSample imu[4];
+    static MagSample mag[2];
+
+    for (size_t i = 0; i < ARRAY_SIZE(imu); i++) {
+        imu[i].timestamp_us = 5000 + 4808 * i;
+    }
+    mag[0].timestamp_us = 9000;
+    mag[1].timestamp_us = 25000;
+
+    SensorBatchMsg b = { .imu = imu, .n_imu = ARRAY_SIZE(imu), .mag = mag, .n_mag = 1 };
+    zassert_ok(sensor_bus_publish_batch(&b));
+    zassert_equal(batch_seen.hdr.timestamp_us, imu[3].timestamp_us);
+
+    b.n_mag = ARRAY_SIZE(mag);
+    zassert_ok(sensor_bus_publish_batch(&b));
+    zassert_equal(batch_seen.hdr.timestamp_us, mag[1].timestamp_us);
+
+    SensorBatchMsg empty = { 0 };
+    int64_t t0 = timebase_now_us();
+    zassert_ok(sensor_bus_publish_batch(&empty));
+    zassert_true(batch_seen.hdr.timestamp_us >= t0 &&
+                 batch_seen.hdr.timestamp_us <= timebase_now_us());
+}
+
+ZTEST_SUITE(sensor_bus, NULL, NULL, before, NULL, NULL);
@@ -0,0 +1,259 @@
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+#include <zephyr/storage/flash_map.h>
+#include <errno.h>
+#include <string.h>
+#include "sensor_log.h"
+
+/*
+ * Journal sur la partition sensor_log du simulateur de flash
+ * (boards/native_sim.overlay, 16 secteurs de 4 Ko comme pm_static.yml).
+ * Les effacements et écritures passent par flash_area_erase/write
+ * (-Wl,--wrap, CMakeLists.txt) : usure par secteur et coupure
+ * d'alimentation au milieu de l'écriture d'un bloc.
+ *
+ * Le temps simulé de native_sim n'avance que sur les attentes de la flash
+ * (CONFIG_FLASH_SIMULATOR_SIMULATE_TIMING) : le débit mesuré est celui
+ * imposé par la flash, pas par le codage.
+ */
+#define LOG_PARTITION  FIXED_PARTITION_ID(sensor_log)
+#define BLOCK          CONFIG_ZSWATCH_SENSOR_LOG_BLOCK_RECORDS
+#define T0_S           1700000000u
+#define PERIOD_S       60
+#define MAX_SECTORS    32
+#define MAX_APPENDS    200000
+
+int __real_flash_area_erase(const struct flash_area *fa, off_t off, size_t len);
+int __real_flash_area_write(const struct flash_area *fa, off_t off, const void *src, size_t len);
+
+static struct {
+    uint32_t erases[MAX_SECTORS];
+    uint32_t sector_size;
+    bool cut_armed;        // coupure à la prochaine écriture de données d'un bloc
+    bool dead;             // alimentation coupée : plus aucune opération flash
+} flash;
+
+int __wrap_flash_area_erase(const struct flash_area *fa, off_t off, size_t len)
+{
+    if (flash.dead) {
+        return -EIO;
+    }
+    if (fa->fa_id == LOG_PARTITION && flash.sector_size) {
+        for (size_t s = off / flash.sector_size; s < (off + len) / flash.sector_size; s++) {
+            flash.erases[s]++;
+        }
+    }
+    return __real_flash_area_erase(fa, off, len);
+}
+
+int __wrap_flash_area_write(const struct flash_area *fa, off_t off, const void *src, size_t len)
+{
+    if (flash.dead) {
+        return -EIO;
+    }
+    // En-têtes FCB (secteur, longueur, CRC) : quelques octets ; données d'un bloc : plus
+    if (flash.cut_armed && len >= 16) {
+        flash.dead = true;
+        __real_flash_area_write(fa, off, src, len / 2);
+        return -EIO;
+    }
+    return __real_flash_area_write(fa, off, src, len);
+}
+
+/* Enregistrement n° i : valeurs lentes et bruitées, accéléro un bloc sur trois */
+static void make_record(uint32_t i, SensorLogRecord *r)
+{
+    memset(r, 0, sizeof(*r));
+    r->time_s = T0_S + i * PERIOD_S;
+    r->flags = SENSOR_LOG_HAS_ENV | SENSOR_LOG_HAS_PRESS;
+    r->temp_100 = 2150 + (int16_t)(i % 37) - 18;
+    r->humi_100 = 4500 + (i * 7) % 200;
+    r->pressure = 101325 + (i % 50) * 3;
+    if ((i / BLOCK) % 3 == 0) {
+        r->flags |= SENSOR_LOG_HAS_ACCEL;
+        r->accel_100[0] = (int16_t)(i % 11) - 5;
+        r->accel_100[1] = 12 - (int16_t)(i % 7);
+        r->accel_100[2] = 981 + (int16_t)(i % 5);
+    }
+}
+
+static uint32_t record_index(const SensorLogRecord *r)
+{
+    return (r->time_s - T0_S) / PERIOD_S;
+}
+
+/* Partition effacée, journal remonté, compteurs à zéro */
+static void log_reset(void)
+{
+    const struct flash_area *fa;
+
+    memset(&flash, 0, sizeof(flash));
+    zassert_ok(flash_area_open(LOG_PARTITION, &fa));
+    zassert_ok(flash_area_erase(fa, 0, fa->fa_size));
+    flash_area_close(fa);
+    zassert_ok(sensor_log_init());
+    memset(flash.erases, 0, sizeof(flash.erases));
+}
+
+static void log_append(uint32_t from, uint32_t n)
+{
+    SensorLogRecord r;
+
+    for (uint32_t i = from; i < from + n; i++) {
+        make_record(i, &r);
+        zassert_ok(sensor_log_append(&r), "enregistrement %u", i);
+    }
+}
+
+/* Relit [first, last] depuis seek(from_s) : ordre, contiguïté et valeurs exactes */
+static void check_range(uint32_t from_s, uint32_t first, uint32_t last)
+{
+    SensorLogCursor c;
+    SensorLogRecord got, want;
+    uint32_t i = first;
+
+    zassert_ok(sensor_log_seek(from_s, &c));
+    while (sensor_log_next(&c, &got) == 0) {
+        make_record(i, &want);
+        zassert_mem_equal(&got, &want, sizeof(got), "enregistrement %u (lu %u)", i,
+                          record_index(&got));
+        i++;
+    }
+    zassert_equal(i, last + 1, "%u enregistrements relus, %u attendus", i - first,
+                  last + 1 - first);
+}
+
+/* Ajoute jusqu'à avoir effacé chaque secteur deux fois (compteurs du journal cumulés) */
+static uint32_t log_wrap_twice(uint32_t *sectors, uint32_t *rotations)
+{
+    SensorLogStats st;
+    uint32_t n = 0;
+
+    sensor_log_get_stats(&st);
+    const uint32_t start = st.rotations;
+
+    flash.sector_size = st.sector_size;
+    *sectors = st.sectors;
+    zassert_true(st.sectors <= MAX_SECTORS);
+    do {
+        log_append(n, BLOCK);
+        n += BLOCK;
+        sensor_log_get_stats(&st);
+    } while (st.rotations - start < 2u * st.sectors && n < MAX_APPENDS);
+    zassert_true(n < MAX_APPENDS);
+    *rotations = st.rotations - start;
+    return n;
+}
+
+/* Débit d'ajout : un bloc écrit par BLOCK enregistrements, coût flash amorti */
+ZTEST(sensor_log, test_append_throughput)
+{
+    const uint32_t n = 64 * BLOCK;
+    SensorLogStats before, after;
+
+    log_reset();
+    sensor_log_get_stats(&before);
+    int64_t t0 = k_uptime_get();
+    log_append(0, n);
+    long long ms = MAX(k_uptime_get() - t0, 1);
+    sensor_log_get_stats(&after);
+
+    uint32_t blocks = after.blocks - before.blocks;
+    uint32_t flash_bytes = after.flash_bytes - before.flash_bytes;
+    uint32_t raw_bytes = after.raw_bytes - before.raw_bytes;
+
+    TC_PRINT("%u enregistrements en %lld ms simulees (%lld /s) | %u blocs | "
+             "%u octets flash pour %u bruts\n", n, ms, n * 1000LL / ms, blocks, flash_bytes,
+             raw_bytes);
+    // Le dernier bloc reste en RAM
+    zassert_equal(blocks, n / BLOCK - 1);
+    zassert_true(flash_bytes * 2 < raw_bytes, "compression insuffisante");
+    // Un enregistrement toutes les 2 s au plus : marge de plusieurs ordres de grandeur
+    zassert_true(n * 1000LL / ms >= 1000, "%lld enregistrements/s", n * 1000LL / ms);
+}
+
+/* Rotation : chaque secteur effacé à tour de rôle, usure uniforme */
+ZTEST(sensor_log, test_wrap_erase_counts)
+{
+    uint32_t sectors, rotations, total = 0, min = UINT32_MAX, max = 0;
+
+    log_reset();
+    log_wrap_twice(&sectors, &rotations);
+
+    for (int s = 0; s < sectors; s++) {
+        total += flash.erases[s];
+        min = MIN(min, flash.erases[s]);
+        max = MAX(max, flash.erases[s]);
+    }
+    TC_PRINT("%u rotations sur %u secteurs : %u a %u effacements par secteur\n",
+             rotations, sectors, min, max);
+    zassert_equal(total, rotations);
+    zassert_true(min >= 2);
+    zassert_true(max - min <= 1, "usure inégale : %u .. %u", min, max);
+}
+
+/* Lectures par plage après rebouclage : les plus anciens perdus par secteur entier */
+ZTEST(sensor_log, test_seek_after_wrap)
+{
+    uint32_t sectors, rotations;
+    SensorLogCursor c;
+    SensorLogRecord r;
+
+    log_reset();
+    uint32_t n = log_wrap_twice(&sectors, &rotations);
+    uint32_t last = n - 1;
+
+    // Plus ancien conservé : début d'un bloc, après les secteurs effacés
+    zassert_ok(sensor_log_seek(0, &c));
+    zassert_ok(sensor_log_next(&c, &r));
+    uint32_t oldest = record_index(&r);
+    zassert_true(oldest > 0);
+    zassert_equal(oldest % BLOCK, 0);
+    zassert_true(last - oldest + 1 >= (sectors - 2) * (n / (rotations + sectors)),
+                 "%u enregistrements conservés", last - oldest + 1);
+
+    // Tout le journal, bloc en RAM compris
+    check_range(0, oldest, last);
+    // Horodatage exact, puis entre deux enregistrements
+    uint32_t mid = (oldest + last) / 2;
+    check_range(T0_S + mid * PERIOD_S, mid, last);
+    check_range(T0_S + mid * PERIOD_S + PERIOD_S / 2, mid + 1, last);
+    // Dans la zone effacée : reprise au plus ancien conservé
+    check_range(T0_S + (oldest / 2) * PERIOD_S, oldest, last);
+    // Au-delà du dernier
+    zassert_equal(sensor_log_seek(T0_S + (last + 1) * PERIOD_S, &c), -1);
+}
+
+/* Coupure pendant l'écriture d'un bloc : blocs déjà écrits intacts, reprise après */
+ZTEST(sensor_log, test_reopen_after_power_loss)
+{
+    SensorLogRecord r;
+    const uint32_t flushed = 40 * BLOCK;
+
+    log_reset();
+    // Le 41e bloc part en flash au premier ajout suivant
+    log_append(0, flushed + BLOCK);
+    flash.cut_armed = true;
+    make_record(flushed + BLOCK, &r);
+    zassert_equal(sensor_log_append(&r), -1);
+    zassert_true(flash.dead);
+
+    // Redémarrage : RAM perdue, entrée tronquée sans CRC ignorée
+    flash.dead = false;
+    flash.cut_armed = false;
+    zassert_ok(sensor_log_init());
+    check_range(0, 0, flushed - 1);
+    zassert_true(sensor_log_time_s() >= T0_S + (flushed - 1) * PERIOD_S,
+                 "horloge du journal revenue en arrière");
+
+    // Nouveaux enregistrements derrière l'entrée tronquée, relus après un nouveau montage
+    log_append(flushed + BLOCK, 4 * BLOCK);
+    zassert_ok(sensor_log_init());
+    SensorLogCursor c;
+    zassert_ok(sensor_log_seek(T0_S + flushed * PERIOD_S, &c));
+    zassert_ok(sensor_log_next(&c, &r));
+    zassert_equal(record_index(&r), flushed + BLOCK, "premier relu : %u", record_index(&r));
+    check_range(T0_S + (flushed + BLOCK) * PERIOD_S, flushed + BLOCK, flushed + 4 * BLOCK - 1);
+}
+
+ZTEST_SUITE(sensor_log, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,119 @@
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+#include <stdlib.h>
+#include "timebase.h"
+
+/*
+ * Dérive de quartz injectée : l'heure vraie avance de (1 + ppm * 1e-6) µs
+ * par µs d'uptime. Synchros rejouées toutes les 6 h avec timebase_sync_at().
+ */
+#define SYNC_SPACING_US  (6LL * 3600 * 1000000)
+#define EPOCH_BASE_US    1700000000000000LL
+
+static int64_t uptime_us = 1000000;   // croissant d'un test à l'autre
+static int64_t epoch0_us;
+
+static int64_t true_epoch(int64_t up, int32_t ppm)
+{
+    return epoch0_us + up + up * ppm / 1000000;
+}
+
+/* Première synchro d'une série : saut d'heure, historique repris à zéro */
+static void series_start(void)
+{
+    epoch0_us += EPOCH_BASE_US / 1000;
+}
+
+static void sync(int32_t ppm, uint32_t resolution_us)
+{
+    int64_t epoch = true_epoch(uptime_us, ppm);
+
+    timebase_sync_at(uptime_us, epoch - epoch % resolution_us, resolution_us);
+    uptime_us += SYNC_SPACING_US;
+}
+
+static void check_exact(int32_t ppm)
+{
+    TimebaseInfo info;
+
+    series_start();
+    for (int i = 0; i < 8; i++) {
+        sync(ppm, 1);
+    }
+    timebase_get_info(&info);
+    zassert_true(info.synced);
+    zassert_equal(info.points, 8);
+    zassert_within(info.drift_ppb, ppm * 1000, 50, "derive %d ppb", info.drift_ppb);
+}
+
+ZTEST(timebase, test_drift_us_writes_fast)
+{
+    check_exact(40);
+}
+
+ZTEST(timebase, test_drift_us_writes_slow)
+{
+    check_exact(-25);
+}
+
+ZTEST(timebase, test_drift_second_writes)
+{
+    const int32_t ppm[] = { 40, -25 };
+
+    for (size_t k = 0; k < ARRAY_SIZE(ppm); k++) {
+        TimebaseInfo info;
+
+        series_start();
+        for (int i = 0; i < 4; i++) {
+            sync(ppm[k], 1000000);
+        }
+        timebase_get_info(&info);
+        zassert_equal(info.points, 4);
+        // Quantification à la seconde (écart type ~0.29 s) : pente à ~6 ppm près sur 18 h
+        zassert_within(info.drift_ppb, ppm[k] * 1000, 15000, "%d ppm -> %d ppb (4 points)",
+                       ppm[k], info.drift_ppb);
+        zassert_between_inclusive(info.next_sync_s, 600, 7 * 24 * 3600);
+
+        for (int i = 4; i < 8; i++) {
+            sync(ppm[k], 1000000);
+        }
+        timebase_get_info(&info);
+        zassert_equal(info.points, 8);
+        // ~2 ppm sur 42 h
+        zassert_within(info.drift_ppb, ppm[k] * 1000, 5000, "%d ppm -> %d ppb (8 points)",
+                       ppm[k], info.drift_ppb);
+    }
+}
+
+ZTEST(timebase, test_conversion_after_fit)
+{
+    series_start();
+    for (int i = 0; i < 8; i++) {
+        sync(40, 1);
+    }
+    // Un jour sans synchro : la dérive corrigée garde l'heure à la ms près
+    int64_t later = uptime_us + 24LL * 3600 * 1000000;
+    int64_t err = timebase_to_epoch_us(later) - true_epoch(later, 40);
+
+    zassert_true(llabs(err) < 1000, "erreur %lld us", (long long)err);
+}
+
+ZTEST(timebase, test_clock_jump_resets_history)
+{
+    TimebaseInfo info;
+
+    series_start();
+    for (int i = 0; i < 4; i++) {
+        sync(40, 1);
+    }
+    // Heure changée d'une heure par l'utilisateur
+    epoch0_us += 3600LL * 1000000;
+    sync(40, 1);
+
+    timebase_get_info(&info);
+    zassert_equal(info.points, 1);
+    zassert_equal(info.drift_ppb, 0);
+    zassert_true(abs(info.last_step_ms - 3600 * 1000) < 1000, "saut %d ms", info.last_step_ms);
+}
+
+ZTEST_SUITE(timebase, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,290 @@
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+#include <string.h>
+#include "ts_codec.h"
+
+/*
+ * Aller-retour ts_codec : decode(encode(x)) == x sur chaque classe de
+ * codage (delta-de-delta et valeurs, bornes comprises), les deltas
+ * extrêmes, les changements de masque et les voies absentes, puis les
+ * blocs pleins, tronqués ou corrompus.
+ */
+#define T0        1700000000u
+#define MAX_PTS   UINT8_MAX
+
+static TsEncoder enc;
+static TsPoint pts[MAX_PTS + 1];
+
+/* Coût en bits d'une classe, préfixe compris, selon ts_codec.h */
+static uint32_t class_bits(int32_t v, const uint8_t widths[4])
+{
+    uint32_t z = ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+
+    if (z == 0) {
+        return 1;
+    }
+    for (int c = 0; c < 3; c++) {
+        if (z < (1UL << widths[c])) {
+            return c + 2 + widths[c];
+        }
+    }
+    return 4 + widths[3];
+}
+
+static const uint8_t dod_widths[] = { 7, 9, 12, 32 };
+static const uint8_t val_widths[] = { 4, 8, 16, 32 };
+
+/* Encode n points, chacun au coût attendu si check_bits */
+static void encode(int n, bool check_bits)
+{
+    int32_t prev[TS_MAX_CHANNELS] = { 0 };
+    int32_t prev_delta = 0;
+
+    ts_encoder_init(&enc);
+    for (int k = 0; k < n; k++) {
+        uint32_t bits = enc.bits;
+        uint32_t want = 0;
+
+        zassert_ok(ts_encoder_add(&enc, &pts[k]), "point %d", k);
+        if (k == 0) {
+            want = 32 + 17;
+        } else {
+            int32_t delta = (int32_t)(pts[k].time - pts[k - 1].time);
+
+            want = class_bits((int32_t)((uint32_t)delta - (uint32_t)prev_delta), dod_widths);
+            want += (pts[k].mask == pts[k - 1].mask) ? 1 : 17;
+            prev_delta = delta;
+        }
+        for (int i = 0; i < TS_MAX_CHANNELS; i++) {
+            if (pts[k].mask & (1U << i)) {
+                want += class_bits((int32_t)((uint32_t)pts[k].values[i] - (uint32_t)prev[i]),
+                                   val_widths);
+                prev[i] = pts[k].values[i];
+            }
+        }
+        if (check_bits) {
+            zassert_equal(enc.bits - bits, want, "point %d : %u bits, %u attendus", k,
+                          enc.bits - bits, want);
+        }
+    }
+    zassert_equal(enc.buf[0], n);
+}
+
+/* Relit le bloc : voies présentes exactes, voies absentes à leur dernière valeur */
+static void check_decode(const uint8_t *buf, uint16_t len, int n)
+{
+    int32_t last[TS_MAX_CHANNELS] = { 0 };
+    TsDecoder d;
+    TsPoint p;
+
+    zassert_ok(ts_decoder_init(&d, buf, len));
+    for (int k = 0; k < n; k++) {
+        zassert_ok(ts_decoder_next(&d, &p), "point %d", k);
+        zassert_equal(p.time, pts[k].time, "point %d : t %u au lieu de %u", k, p.time,
+                      pts[k].time);
+        zassert_equal(p.mask, pts[k].mask, "point %d : masque %04x", k, p.mask);
+        for (int i = 0; i < TS_MAX_CHANNELS; i++) {
+            if (pts[k].mask & (1U << i)) {
+                last[i] = pts[k].values[i];
+            }
+            zassert_equal(p.values[i], last[i], "point %d voie %d : %d au lieu de %d", k, i,
+                          p.values[i], last[i]);
+        }
+    }
+    zassert_equal(ts_decoder_next(&d, &p), -1, "point en trop");
+}
+
+static void roundtrip(int n)
+{
+    encode(n, true);
+    check_decode(enc.buf, ts_encoder_size(&enc), n);
+}
+
+/* Bornes de chaque classe de part et d'autre, en zig-zag */
+static const int32_t dod_cases[] = {
+    0, 1, -1, 63, -64, 64, -65, 255, -256, 256, -257, 2047, -2048, 2048, -2049,
+    100000, -100000, INT32_MAX, INT32_MIN,
+};
+static const int32_t val_cases[] = {
+    0, 1, -1, 7, -8, 8, -9, 127, -128, 128, -129, 32767, -32768, 32768, -32769,
+    INT32_MAX, INT32_MIN,
+};
+
+ZTEST(ts_codec, test_dod_classes)
+{
+    int32_t delta = 60;
+    int n = 0;
+
+    pts[n++] = (TsPoint){ .time = T0 };
+    pts[n++] = (TsPoint){ .time = T0 + delta };
+    for (int c = 0; c < ARRAY_SIZE(dod_cases); c++) {
+        delta = (int32_t)((uint32_t)delta + (uint32_t)dod_cases[c]);
+        pts[n] = (TsPoint){ .time = pts[n - 1].time + (uint32_t)delta };
+        n++;
+    }
+    roundtrip(n);
+}
+
+ZTEST(ts_codec, test_value_classes)
+{
+    int n = 0;
+
+    // Trois voies espacées, décalées d'un tiers des cas : chaque cas sur chaque voie
+    pts[n++] = (TsPoint){ .time = T0, .mask = BIT(0) | BIT(4) | BIT(TS_MAX_CHANNELS - 1) };
+    for (int c = 0; c < ARRAY_SIZE(val_cases); c++) {
+        pts[n] = pts[n - 1];
+        pts[n].time += 60;
+        for (int i = 0; i < TS_MAX_CHANNELS; i++) {
+            int32_t dv = val_cases[(c + i * ARRAY_SIZE(val_cases) / 3) % ARRAY_SIZE(val_cases)];
+
+            pts[n].values[i] = (int32_t)((uint32_t)pts[n - 1].values[i] + (uint32_t)dv);
+        }
+        n++;
+    }
+    roundtrip(n);
+}
+
+/* Deltas INT32_MIN / INT32_MAX sur l'horodatage et les valeurs */
+ZTEST(ts_codec, test_extreme_deltas)
+{
+    static const int32_t v[] = { 0, INT32_MAX, -1, INT32_MIN, INT32_MAX, 0, INT32_MIN, 0 };
+    static const uint32_t t[] = {
+        0, INT32_MAX, UINT32_MAX, 0x80000000u, 0, INT32_MAX, 0x80000000u, UINT32_MAX,
+    };
+
+    for (int k = 0; k < ARRAY_SIZE(v); k++) {
+        pts[k] = (TsPoint){ .time = t[k], .mask = BIT(0) | BIT(TS_MAX_CHANNELS - 1) };
+        pts[k].values[0] = v[k];
+        pts[k].values[TS_MAX_CHANNELS - 1] = -v[k];
+    }
+    roundtrip(ARRAY_SIZE(v));
+}
+
+/* Masques changeants : voies absentes, réapparues, masque vide */
+ZTEST(ts_codec, test_mask_changes)
+{
+    static const uint16_t masks[] = {
+        0x001, 0x001, 0x1FF, 0x000, 0x000, 0x100, 0x0F0, 0x0F0, 0x00F, 0x1FF, 0x155, 0x0AA,
+    };
+
+    for (int k = 0; k < ARRAY_SIZE(masks); k++) {
+        pts[k] = (TsPoint){ .time = T0 + k * 10, .mask = masks[k] };
+        for (int i = 0; i < TS_MAX_CHANNELS; i++) {
+            // Valeurs des voies absentes différentes : ni codées ni relues
+            pts[k].values[i] = (masks[k] & BIT(i)) ? 1000 * i + k * k : -12345;
+        }
+    }
+    roundtrip(ARRAY_SIZE(masks));
+}
+
+/* Bloc plein : -1 sans toucher au bloc, en octets puis en nombre de points */
+ZTEST(ts_codec, test_full_block)
+{
+    TsPoint extra;
+    int n = 0;
+
+    // Toutes les voies en classe 32 bits : quelques points par bloc
+    ts_encoder_init(&enc);
+    for (; n < MAX_PTS; n++) {
+        pts[n] = (TsPoint){ .time = T0 + n * (n % 2 ? 100000 : 1),
+                            .mask = BIT_MASK(TS_MAX_CHANNELS) };
+        for (int i = 0; i < TS_MAX_CHANNELS; i++) {
+            pts[n].values[i] = (n % 2) ? INT32_MAX - i : INT32_MIN + i;
+        }
+        if (ts_encoder_add(&enc, &pts[n]) != 0) {
+            break;
+        }
+    }
+    zassert_true(n > 1 && n < MAX_PTS, "%d points", n);
+    zassert_true(ts_encoder_size(&enc) <= TS_BLOCK_MAX);
+    TsEncoder before = enc;
+    zassert_equal(ts_encoder_add(&enc, &pts[n]), -1);
+    zassert_mem_equal(&enc, &before, sizeof(enc));
+    check_decode(enc.buf, ts_encoder_size(&enc), n);
+
+    // Points identiques sans voie : 2 bits chacun, limite du compteur 8 bits
+    for (n = 0; n < MAX_PTS; n++) {
+        pts[n] = (TsPoint){ .time = T0 + n * 60 };
+    }
+    encode(MAX_PTS, true);
+    extra = (TsPoint){ .time = T0 + MAX_PTS * 60 };
+    zassert_equal(ts_encoder_add(&enc, &extra), -1);
+    check_decode(enc.buf, ts_encoder_size(&enc), MAX_PTS);
+}
+
+/* Bloc tronqué : chaque point complet relu, puis -1 */
+ZTEST(ts_codec, test_truncated)
+{
+    TsDecoder d;
+    TsPoint p;
+    int n = ARRAY_SIZE(val_cases);
+
+    for (int k = 0; k < n; k++) {
+        pts[k] = (TsPoint){ .time = T0 + k * 60, .mask = BIT(k % TS_MAX_CHANNELS) | BIT(0) };
+        for (int i = 0; i < TS_MAX_CHANNELS; i++) {
+            pts[k].values[i] = val_cases[(k + i) % n];
+        }
+    }
+    encode(n, false);
+    uint16_t size = ts_encoder_size(&enc);
+
+    zassert_equal(ts_decoder_init(&d, enc.buf, 0), -1);
+    for (uint16_t len = 1; len < size; len++) {
+        int k = 0;
+
+        zassert_ok(ts_decoder_init(&d, enc.buf, len));
+        while (ts_decoder_next(&d, &p) == 0) {
+            zassert_equal(p.time, pts[k].time, "longueur %u, point %d", len, k);
+            k++;
+        }
+        zassert_true(k < n, "longueur %u : %d points relus sur %d", len, k, n);
+        zassert_equal(ts_decoder_next(&d, &p), -1);
+    }
+}
+
+/* Bloc corrompu : compteur gonflé, premier masque absent, octets effacés */
+ZTEST(ts_codec, test_corrupted)
+{
+    static uint8_t buf[TS_BLOCK_MAX];
+    TsDecoder d;
+    TsPoint p;
+    int n = 10, k = 0;
+
+    for (int j = 0; j < n; j++) {
+        pts[j] = (TsPoint){ .time = T0 + j * 60, .mask = 0x007 };
+        pts[j].values[0] = j * 1000;
+    }
+    encode(n, false);
+    uint16_t size = ts_encoder_size(&enc);
+
+    // Compteur supérieur au contenu : fin des données avant le dernier point
+    memcpy(buf, enc.buf, size);
+    buf[0] = UINT8_MAX;
+    zassert_ok(ts_decoder_init(&d, buf, size));
+    while (ts_decoder_next(&d, &p) == 0) {
+        k++;
+    }
+    zassert_true(k >= n && k < UINT8_MAX, "%d points", k);
+
+    // Bit « nouveau masque » du premier point à zéro : aucun masque de référence
+    memcpy(buf, enc.buf, size);
+    buf[(8 + 32) / 8] &= ~(0x80 >> ((8 + 32) % 8));
+    zassert_ok(ts_decoder_init(&d, buf, size));
+    zassert_equal(ts_decoder_next(&d, &p), -1);
+
+    // Flash effacée (0xFF) : préfixes de classe maximale jusqu'à épuisement
+    memset(buf, 0xFF, sizeof(buf));
+    zassert_ok(ts_decoder_init(&d, buf, sizeof(buf)));
+    k = 0;
+    while (ts_decoder_next(&d, &p) == 0) {
+        k++;
+    }
+    zassert_true(k < UINT8_MAX, "%d points", k);
+
+    // Compteur nul : bloc vide refusé
+    memcpy(buf, enc.buf, size);
+    buf[0] = 0;
+    zassert_equal(ts_decoder_init(&d, buf, size), -1);
+}
+
+ZTEST_SUITE(ts_codec, NULL, NULL, NULL, NULL, NULL);